@@ -0,0 +1,52 @@
+// FILE: benchmarks/alloc/alloc_aligned_test.c
+// Purpose: rt_alloc_aligned across the small/large boundary. For each size from 16 bytes
+// to 4 MiB (including the sizes around RT_ALLOC_SMALL_MAX) and each alignment 32 and 64,
+// it keeps several blocks live at once and checks that every block is aligned, that the
+// blocks are pairwise disjoint and that each one keeps its fill pattern; then it frees
+// them. Exit status 0 and "OK" on success, otherwise the first failure.
+//
+//   cc -O2 -std=c11 -pthread -I../../internal/aotminic/runtime alloc_aligned_test.c
+//      ../../internal/aotminic/runtime/rt_alloc.c -o alloc_aligned_test
+//   ./alloc_aligned_test
+#include "rt_alloc.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LIVE 4
+
+static int fail(const char *what, size_t n, size_t align) {
+    fprintf(stderr, "FAIL: %s (n=%zu, align=%zu)\n", what, n, align);
+    return 1;
+}
+
+static int check(size_t n, size_t align) {
+    unsigned char *p[LIVE];
+    for (int i = 0; i < LIVE; i++) {
+        if (!(p[i] = rt_alloc_aligned(n, align))) return fail("NULL", n, align);
+        if ((uintptr_t)p[i] % align) return fail("misaligned", n, align);
+        memset(p[i], 0x40 + i, n);
+    }
+    for (int i = 0; i < LIVE; i++)
+        for (int j = i + 1; j < LIVE; j++)
+            if (p[i] < p[j] + n && p[j] < p[i] + n) return fail("overlapping blocks", n, align);
+    for (int i = 0; i < LIVE; i++)
+        for (size_t k = 0; k < n; k += n / 64 + 1)
+            if (p[i][k] != 0x40 + i || p[i][n - 1] != 0x40 + i) return fail("block overwritten", n, align);
+    for (int i = 0; i < LIVE; i++) rt_free(p[i]);
+    return 0;
+}
+
+int main(void) {
+    static const size_t around[] = { RT_ALLOC_SMALL_MAX - 64, RT_ALLOC_SMALL_MAX - 1, RT_ALLOC_SMALL_MAX,
+                                     RT_ALLOC_SMALL_MAX + 1, RT_ALLOC_SMALL_MAX + 64, 512u << 10, 1u << 20 };
+    for (size_t align = 32; align <= 64; align *= 2) {
+        for (size_t n = 16; n <= (4u << 20); n = n * 5 / 4 + 1)
+            if (check(n, align)) return 1;
+        for (size_t i = 0; i < sizeof around / sizeof around[0]; i++)
+            if (check(around[i], align)) return 1;
+    }
+    puts("OK");
+    return 0;
+}
@@ -0,0 +1,153 @@
+// FILE: benchmarks/alloc/alloc_bench.c
+// Purpose: allocation-heavy microbenchmark, rt_alloc against glibc malloc at 1..32 threads
+// Cases (the total op count is split across the threads):
+//   churn    each thread keeps 1024 live blocks of 16..512 bytes and replaces a random
+//            one per op (all frees local)
+//   handoff  rounds of: every thread allocates a batch of 16..256-byte blocks, then all
+//            wait, then each frees the batch of its neighbour (all frees cross-thread
+//            once there are two threads or more)
+//   tree     each thread builds and tears down complete binary trees of 32-byte nodes
+//            (the allocation pattern of recursive AOT code)
+// One op is one allocation plus its free.
+//
+//   cc -O3 -std=c11 -pthread -I../../internal/aotminic/runtime alloc_bench.c
+//      ../../internal/aotminic/runtime/rt_alloc.c -o alloc_bench
+//   ./alloc_bench [ops] [threads,...]     default 4000000 and 1,2,4,8,16,32
+#define _GNU_SOURCE
+#include "../src/c/runtime.h"
+#include "rt_alloc.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LIVE  1024
+#define BATCH 4096
+#define DEPTH 12        // nodes per tree: 2^(DEPTH+1) - 1
+
+typedef struct {
+    const char *name;
+    void *(*alloc)(size_t);
+    void  (*free)(void *);
+} impl;
+
+static const impl IMPLS[] = { { "glibc", malloc, free }, { "rt_alloc", rt_alloc, rt_free } };
+
+typedef struct {
+    const impl        *im;
+    int                id, nthreads;
+    long               ops;
+    void             **batches;     // handoff: nthreads * BATCH slots
+    pthread_barrier_t *bar;
+    long long          sink;
+} job;
+
+static void *run_churn(void *arg) {
+    job *j = arg;
+    void *live[LIVE] = {0};
+    uint64_t rng = 0x9e37u + (uint64_t)j->id;
+    for (long i = 0; i < j->ops; i++) {
+        uint64_t r = splitmix64(&rng);
+        size_t k = r % LIVE, n = 16 + (r >> 32) % 497;
+        j->im->free(live[k]);
+        char *p = j->im->alloc(n);
+        p[0] = (char)i;
+        live[k] = p;
+    }
+    for (int k = 0; k < LIVE; k++) j->im->free(live[k]);
+    return NULL;
+}
+
+static void *run_handoff(void *arg) {
+    job *j = arg;
+    uint64_t rng = 0x7f4au + (uint64_t)j->id;
+    void **mine = j->batches + (size_t)j->id * BATCH;
+    void **next = j->batches + (size_t)((j->id + 1) % j->nthreads) * BATCH;
+    for (long done = 0; done < j->ops; done += BATCH) {
+        for (int k = 0; k < BATCH; k++) {
+            char *p = j->im->alloc(16 + splitmix64(&rng) % 241);
+            p[0] = (char)k;
+            mine[k] = p;
+        }
+        pthread_barrier_wait(j->bar);
+        for (int k = 0; k < BATCH; k++) j->sink += *(char *)next[k], j->im->free(next[k]);
+        pthread_barrier_wait(j->bar);
+    }
+    return NULL;
+}
+
+typedef struct tnode { struct tnode *l, *r; long v; long pad; } tnode;
+
+static tnode *build(const impl *im, int d) {
+    tnode *t = im->alloc(sizeof(tnode));
+    t->v = d;
+    t->l = d ? build(im, d - 1) : NULL;
+    t->r = d ? build(im, d - 1) : NULL;
+    return t;
+}
+
+static long teardown(const impl *im, tnode *t) {
+    if (!t) return 0;
+    long s = t->v + teardown(im, t->l) + teardown(im, t->r);
+    im->free(t);
+    return s;
+}
+
+static void *run_tree(void *arg) {
+    job *j = arg;
+    long per_tree = (2L << DEPTH) - 1;
+    for (long done = 0; done < j->ops; done += per_tree) j->sink += teardown(j->im, build(j->im, DEPTH));
+    return NULL;
+}
+
+static long long sink_total;
+
+static void bench(const char *cname, void *(*fn)(void *), const impl *im, int nthreads, long ops) {
+    pthread_t tid[64];
+    job jobs[64];
+    pthread_barrier_t bar;
+    pthread_barrier_init(&bar, NULL, (unsigned)nthreads);
+    void **batches = calloc((size_t)nthreads * BATCH, sizeof(void *));
+    long per = ops / nthreads;
+
+    long long t0 = now_ns();
+    for (int i = 0; i < nthreads; i++) {
+        jobs[i] = (job){ im, i, nthreads, per, batches, &bar, 0 };
+        pthread_create(&tid[i], NULL, fn, &jobs[i]);
+    }
+    for (int i = 0; i < nthreads; i++) { pthread_join(tid[i], NULL); sink_total += jobs[i].sink; }
+    long long ns = now_ns() - t0;
+
+    long total = per * nthreads;
+    printf("TASK=alloc,CASE=%s,IMPL=%s,THREADS=%d,N=%ld,TIME_NS=%lld,NS_PER_OP=%.1f,MOPS=%.1f\n",
+           cname, im->name, nthreads, total, ns, (double)ns / (double)total, (double)total * 1e3 / (double)ns);
+    fflush(stdout);
+    free(batches);
+    pthread_barrier_destroy(&bar);
+}
+
+int main(int argc, char **argv) {
+    long ops = argc > 1 ? atol(argv[1]) : 4000000;
+    const char *list = argc > 2 ? argv[2] : "1,2,4,8,16,32";
+    if (ops <= 0) { fprintf(stderr, "alloc_bench: ops must be > 0\n"); return 1; }
+
+    int threads[16], nt = 0;
+    for (const char *p = list; *p && nt < 16; ) {
+        int t = atoi(p);
+        if (t < 1 || t > 64) { fprintf(stderr, "alloc_bench: thread counts are 1..64\n"); return 1; }
+        threads[nt++] = t;
+        p = strchr(p, ',');
+        if (!p) break;
+        p++;
+    }
+
+    static const struct { const char *name; void *(*fn)(void *); } CASES[] = {
+        { "churn", run_churn }, { "handoff", run_handoff }, { "tree", run_tree },
+    };
+    for (size_t c = 0; c < sizeof(CASES) / sizeof(CASES[0]); c++)
+        for (int t = 0; t < nt; t++)
+            for (size_t i = 0; i < sizeof(IMPLS) / sizeof(IMPLS[0]); i++)
+                bench(CASES[c].name, CASES[c].fn, &IMPLS[i], threads[t], ops);
+    fprintf(stderr, "checksum %lld\n", sink_total);
+    return 0;
+}
@@ -0,0 +1,55 @@
+#!/usr/bin/env bash
+# Bounds-check overhead: builds the AOT targets that keep checks after range analysis
+# (sort, n-body, VaR quickselect, GARCH and yield-curve setup) twice from the same emitted C, with slice bounds checks (the default) and with -DRT_NO_BOUNDS_CHECK, and
+# reports the best of REPS runs of each and the overhead of the checks.
+set -euo pipefail
+
+: "${SORT_N:=1000000}"
+: "${NBODY_N:=4096}"
+: "${NBODY_STEPS:=10}"
+: "${VAR_N:=1000000}"
+: "${GARCH_N:=200}"
+: "${CURVES:=2000}"
+: "${REPS:=5}"
+: "${CC:=gcc}"
+: "${CFLAGS_NATIVE:=-O3 -march=native -fno-math-errno}"
+
+RT=internal/aotminic/runtime
+mkdir -p .bin
+
+[[ -x .bin/tenge ]] || go build -o .bin/tenge ./cmd/tenge
+
+best() {   # best TIME_NS of REPS runs
+  local b=""
+  for _ in $(seq "$REPS"); do
+    ns=$("$@" | sed -n 's/.*TIME_NS=\([0-9]*\).*/\1/p')
+    [[ -z "$b" || "$ns" -lt "$b" ]] && b=$ns
+  done
+  echo "$b"
+}
+
+printf '%-11s %14s %14s %9s\n' target checked_ns unchecked_ns overhead
+for t in sort_pdq sort_radix nbody nbody_sym var_mc_qsel var_mc_zig garch yield_curve; do
+  case $t in
+    var_mc_zig)  extra=("$RT/rt_sched.c") ;;
+    garch)       extra=("$RT/rt_garch.c" "$RT/rt_sched.c") ;;
+    yield_curve) extra=("$RT/rt_nss.c" "$RT/rt_sched.c") ;;
+    *)           extra=() ;;
+  esac
+  ./.bin/tenge -o ".bin/${t}_tng.c" "benchmarks/src/tenge/${t}_cli.tng" >/dev/null
+  for mode in checked unchecked; do
+    flags=""; [[ $mode == unchecked ]] && flags="-DRT_NO_BOUNDS_CHECK"
+    # shellcheck disable=SC2086
+    $CC $CFLAGS_NATIVE $flags -I"$RT" ".bin/${t}_tng.c" "$RT/runtime.c" "$RT/rt_alloc.c" "${extra[@]}" -lm -lpthread -o ".bin/${t}_${mode}"
+  done
+  case $t in
+    sort_*)      args=("$SORT_N") ;;
+    var_mc_*)    args=("$VAR_N") ;;
+    garch)       args=("$GARCH_N") ;;
+    yield_curve) args=("$CURVES") ;;
+    *)           args=("$NBODY_N" "$NBODY_STEPS") ;;
+  esac
+  c=$(best ".bin/${t}_checked" "${args[@]}")
+  u=$(best ".bin/${t}_unchecked" "${args[@]}")
+  awk -v t="$t" -v c="$c" -v u="$u" 'BEGIN { printf "%-11s %14d %14d %8.1f%%\n", t, c, u, 100 * (c - u) / u }'
+done
@@ -0,0 +1,28 @@
+#!/usr/bin/env bash
+# GARCH(1,1) calibration sweep: 1k..100k series x 2500 observations.
+# Builds the AOT garch target and appends TASK=...,TIME_NS=... lines to
+# benchmarks/results/garch_<stamp>.csv. 100k series hold 2 GB of returns.
+set -euo pipefail
+
+: "${SERIES:=1000 10000 100000}"
+: "${OBS:=2500}"
+: "${THREADS:=0}"                # 0 => all cores
+: "${CC:=cc}"
+: "${CFLAGS_NATIVE:=-O3 -march=native}"
+
+RT=internal/aotminic/runtime
+mkdir -p .bin benchmarks/results
+
+[[ -x .bin/tenge ]] || go build -o .bin/tenge ./cmd/tenge
+./.bin/tenge -o .bin/garch_tng.c benchmarks/src/tenge/garch_cli.tng
+$CC $CFLAGS_NATIVE -I"$RT" .bin/garch_tng.c "$RT/runtime.c" "$RT/rt_alloc.c" "$RT/rt_garch.c" "$RT/rt_sched.c" \
+    -lm -lpthread -o .bin/garch_tng
+
+stamp="$(date +%Y%m%d_%H%M%S)"
+csv="benchmarks/results/garch_${stamp}.csv"
+printf "" >"$csv"
+
+for n in $SERIES; do
+  .bin/garch_tng "$n" "$OBS" "$THREADS" | tee -a "$csv"
+done
+echo "[bench] GARCH sweep: $csv"
@@ -0,0 +1,134 @@
+// FILE: benchmarks/interp/main.go
+// Purpose: call-heavy interpreted workloads on each execution tier
+// Engines:
+//
+//	ast   tree-walking evaluator: an Environment map per call, QaytarValue returns,
+//	      boxed san values
+//	vm    bytecode VM: frames on a preallocated value stack, results returned in the
+//	      caller's register, inline-cached call sites, unboxed san values
+//	jit   the VM with its baseline JIT: functions past the call or loop threshold run
+//	      as template-compiled machine code (linux/amd64; elsewhere the same as vm)
+//
+// Each engine loads the source and does REPS runs of INNER calls of FN(ARGS...). It
+// reports the first run (COLD_NS: for jit, interpreting until tier-up, compiling and
+// then running compiled code), the fastest run, the time per call in that run and the
+// heap allocations of one run; jit also reports what it compiled and deoptimized.
+//
+//	go run ./benchmarks/interp [-engine ast,vm,jit] [-reps 5] benchmarks/interp/fib_rec.tng fib 27
+//	go run ./benchmarks/interp -inner 100000 benchmarks/interp/fib_iter.tng fib_iter 90
+//	go run ./benchmarks/interp benchmarks/interp/tak.tng tak 18 12 6
+package main
+
+import (
+	"flag"
+	"fmt"
+	"os"
+	"runtime"
+	"strconv"
+	"strings"
+	"time"
+
+	"github.com/DauletBai/tenge/internal/lang/ast"
+	"github.com/DauletBai/tenge/internal/lang/evaluator"
+	"github.com/DauletBai/tenge/internal/lang/lexer"
+	"github.com/DauletBai/tenge/internal/lang/object"
+	"github.com/DauletBai/tenge/internal/lang/parser"
+	"github.com/DauletBai/tenge/internal/lang/vm"
+)
+
+func die(format string, a ...interface{}) {
+	fmt.Fprintf(os.Stderr, "interp: "+format+"\n", a...)
+	os.Exit(1)
+}
+
+// caller returns a function that calls fn(args...) on engine, and for jit the VM.
+func caller(engine string, program *ast.Program, fn string, args []object.Object) (func() object.Object, *vm.VM) {
+	switch engine {
+	case "ast":
+		env := object.NewEnvironment()
+		if r := evaluator.Eval(program, env); r.Type() == object.ERROR_OBJ {
+			die("%s", r.Inspect())
+		}
+		f, ok := env.Get(fn)
+		if !ok {
+			die("undefined: %s", fn)
+		}
+		return func() object.Object { return evaluator.Apply(f, args) }, nil
+	case "vm", "jit":
+		prog, err := vm.Compile(program)
+		if err != nil {
+			die("%v", err)
+		}
+		m := vm.New(prog)
+		m.JIT = engine == "jit"
+		if r := m.Run(); r.Type() == object.ERROR_OBJ {
+			die("%s", r.Inspect())
+		}
+		return func() object.Object { return m.Call(fn, args...) }, m
+	}
+	die("unknown engine %q (ast, vm, jit)", engine)
+	return nil, nil
+}
+
+func main() {
+	engines := flag.String("engine", "ast,vm,jit", "comma-separated engines: ast, vm, jit")
+	reps := flag.Int("reps", 5, "runs per engine (the fastest is reported)")
+	inner := flag.Int("inner", 1, "calls per run")
+	flag.Parse()
+	if flag.NArg() < 2 || *inner < 1 {
+		die("usage: interp [-engine ast,vm,jit] [-reps N] [-inner K] file.tng fn [san args...]")
+	}
+	src, err := os.ReadFile(flag.Arg(0))
+	if err != nil {
+		die("%v", err)
+	}
+	p := parser.New(lexer.New(string(src)))
+	program := p.ParseProgram()
+	if len(p.Errors()) > 0 {
+		die("%s: %s", flag.Arg(0), strings.Join(p.Errors(), "; "))
+	}
+	fn := flag.Arg(1)
+	var args []object.Object
+	for _, a := range flag.Args()[2:] {
+		n, err := strconv.ParseInt(a, 10, 64)
+		if err != nil {
+			die("argument %q: want a san", a)
+		}
+		args = append(args, &object.San{Value: n})
+	}
+
+	for _, engine := range strings.Split(*engines, ",") {
+		call, m := caller(engine, program, fn, args)
+		var cold, best time.Duration
+		var result object.Object
+		var ms0, ms1 runtime.MemStats
+		for r := 0; r < *reps; r++ {
+			runtime.GC()
+			runtime.ReadMemStats(&ms0)
+			t0 := time.Now()
+			for k := 0; k < *inner; k++ {
+				result = call()
+			}
+			d := time.Since(t0)
+			runtime.ReadMemStats(&ms1)
+			if result.Type() == object.ERROR_OBJ {
+				die("%s: %s", engine, result.Inspect())
+			}
+			if r == 0 {
+				cold = d
+			}
+			if r == 0 || d < best {
+				best = d
+			}
+		}
+		fmt.Printf("TASK=interp_call,ENGINE=%s,FN=%s,ARGS=%s,RESULT=%s,INNER=%d,COLD_NS=%d,TIME_NS=%d,NS_PER_CALL=%.1f,ALLOCS=%d",
+			engine, fn, strings.Join(flag.Args()[2:], " "), result.Inspect(), *inner, cold.Nanoseconds(), best.Nanoseconds(),
+			float64(best.Nanoseconds())/float64(*inner), ms1.Mallocs-ms0.Mallocs)
+		if m != nil && m.JIT {
+			st := m.Stats()
+			fmt.Printf(",COMPILED=%d,COMPILE_NS=%d,FIRST_CODE_NS=%d,ENTRIES=%d,DEOPTS=%d",
+				st.Compiled, st.Compile.Nanoseconds(), st.FirstCode.Nanoseconds(), st.Entries, st.Deopts)
+		}
+		fmt.Println()
+	}
+}
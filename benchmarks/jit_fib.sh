@@ -0,0 +1,48 @@
+#!/usr/bin/env bash
+# Baseline JIT vs bytecode VM vs AOT C on fib_iter and fib_rec. For the interpreter
+# tiers the harness (benchmarks/interp) reports the first run, which for jit includes
+# interpreting until tier-up and compiling, and the steady state (the best of REPS
+# runs); the AOT numbers come from the C that `tenge -o` emits for the same workloads.
+set -euo pipefail
+
+: "${ITER_N:=90}"
+: "${ITER_INNER:=100000}"
+: "${REC_N:=30}"
+: "${REPS:=5}"
+: "${CC:=gcc}"
+: "${CFLAGS_NATIVE:=-O3 -march=native}"
+
+RT=internal/aotminic/runtime
+mkdir -p .bin
+
+[[ -x .bin/tenge ]] || go build -o .bin/tenge ./cmd/tenge
+[[ -x .bin/interp ]] || go build -o .bin/interp ./benchmarks/interp
+
+field() { sed -n "s/.*[,]$1=\([0-9.]*\).*/\1/p"; }
+
+best() {   # best TIME_NS of REPS runs
+  local b=""
+  for _ in $(seq "$REPS"); do
+    ns=$("$@" | field TIME_NS)
+    [[ -z "$b" || "$ns" -lt "$b" ]] && b=$ns
+  done
+  echo "$b"
+}
+
+printf '%-9s %-6s %14s %14s %14s %12s\n' task engine cold_ns steady_ns ns_per_call compile_ns
+for t in fib_iter fib_rec; do
+  case $t in
+    fib_iter) fn=fib_iter; n=$ITER_N; inner=$ITER_INNER ;;
+    fib_rec)  fn=fib;      n=$REC_N;  inner=1 ;;
+  esac
+  for engine in vm jit; do
+    line=$(.bin/interp -engine "$engine" -reps "$REPS" -inner "$inner" "benchmarks/interp/$t.tng" "$fn" "$n")
+    printf '%-9s %-6s %14s %14s %14s %12s\n' "$t" "$engine" "$(field COLD_NS <<<"$line")" \
+      "$(field TIME_NS <<<"$line")" "$(field NS_PER_CALL <<<"$line")" "$(field COMPILE_NS <<<"$line")"
+  done
+  ./.bin/tenge -o ".bin/${t}_tng.c" "benchmarks/src/tenge/${t}_cli.tng" >/dev/null
+  # shellcheck disable=SC2086
+  $CC $CFLAGS_NATIVE -I"$RT" ".bin/${t}_tng.c" "$RT/runtime.c" -lm -o ".bin/${t}_aot"
+  ns=$(best ".bin/${t}_aot" "$n")
+  printf '%-9s %-6s %14s %14s %14s %12s\n' "$t" aot - "$ns" "$ns" -
+done
@@ -0,0 +1,32 @@
+#!/usr/bin/env bash
+# N-body vectorization check: builds the AOT nbody targets with -fno-math-errno,
+# records GCC's -fopt-info-vec report for each emitted C file in
+# benchmarks/results/vec/<target>.txt and times both with NBODY_N bodies.
+# TENGE_DEFINES (e.g. "-D N=4096 -D steps=10") adds a size-specialized variant.
+set -euo pipefail
+
+: "${NBODY_N:=4096}"
+: "${NBODY_STEPS:=10}"
+: "${TENGE_DEFINES:=}"
+: "${CC:=gcc}"
+: "${CFLAGS_NATIVE:=-O3 -march=native}"
+CFLAGS_VEC="$CFLAGS_NATIVE -fno-math-errno"   # Tenge math never uses errno
+
+RT=internal/aotminic/runtime
+mkdir -p .bin benchmarks/results/vec
+
+[[ -x .bin/tenge ]] || go build -o .bin/tenge ./cmd/tenge
+for t in nbody nbody_sym; do
+  # shellcheck disable=SC2086
+  ./.bin/tenge $TENGE_DEFINES -o ".bin/${t}_tng.c" "benchmarks/src/tenge/${t}_cli.tng"
+  report="benchmarks/results/vec/${t}.txt"
+  {
+    echo "# $($CC --version | head -1)"
+    echo "# $CC $CFLAGS_VEC -fopt-info-vec-optimized ${t}_tng.c"
+    $CC $CFLAGS_VEC -I"$RT" -c ".bin/${t}_tng.c" -o /dev/null -fopt-info-vec-optimized 2>&1 \
+      | sed "s|^\.bin/||" | sort -t: -k2,2n -k3,3n | uniq
+  } >"$report"
+  $CC $CFLAGS_VEC -I"$RT" ".bin/${t}_tng.c" "$RT/runtime.c" "$RT/rt_alloc.c" -lm -o ".bin/${t}_tng"
+  ".bin/${t}_tng" "$NBODY_N" "$NBODY_STEPS"
+  echo "[vec] $report"
+done
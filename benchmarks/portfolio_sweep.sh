@@ -0,0 +1,32 @@
+#!/usr/bin/env bash
+# Portfolio optimizer sweep: min-variance and max-Sharpe at 100..5000 assets.
+# Builds the AOT portfolio target and appends TASK=...,TIME_NS=... lines to
+# benchmarks/results/portfolio_<stamp>.csv.
+set -euo pipefail
+
+: "${SIZES:=100 250 500 1000 2000 5000}"
+: "${MAX_WEIGHT:=0.05}"          # per-asset cap; 0 disables the box (closed-form path)
+: "${THREADS:=0}"                # 0 => all cores
+: "${CC:=cc}"
+: "${CFLAGS_NATIVE:=-O3 -march=native}"
+
+RT=internal/aotminic/runtime
+mkdir -p .bin benchmarks/results
+
+[[ -x .bin/tenge ]] || go build -o .bin/tenge ./cmd/tenge
+./.bin/tenge -o .bin/portfolio_tng.c benchmarks/src/tenge/portfolio_opt_cli.tng
+$CC $CFLAGS_NATIVE -I"$RT" .bin/portfolio_tng.c "$RT/runtime.c" "$RT/rt_alloc.c" "$RT/rt_matrix.c" "$RT/rt_portfolio.c" "$RT/rt_sched.c" \
+    -lm -lpthread -o .bin/portfolio_tng
+
+stamp="$(date +%Y%m%d_%H%M%S)"
+csv="benchmarks/results/portfolio_${stamp}.csv"
+printf "" >"$csv"
+
+for n in $SIZES; do
+  # Keep the box feasible (n * cap >= 1) at small n.
+  cap="$(python3 -c "import sys; n=int(sys.argv[1]); c=float(sys.argv[2]); print(c if c==0 else max(c, 2.0/n))" "$n" "$MAX_WEIGHT")"
+  for mode in minvar sharpe; do
+    .bin/portfolio_tng "$n" "$mode" "$cap" "$THREADS" | tee -a "$csv"
+  done
+done
+echo "[bench] Portfolio sweep: $csv"
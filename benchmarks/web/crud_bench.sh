@@ -1,7 +1,204 @@
 #!/usr/bin/env bash
 # Simple timing harness for CRUD demo.
+#
+#   crud_bench.sh [runs]                     time the CLI demo
+#   crud_bench.sh http [clients] [requests]  keep-alive load against the HTTP server
+#   crud_bench.sh commit [requests]          group commit vs per-request commit, 1..256 clients
+#   crud_bench.sh pages [requests]           full /list vs keyset pages (cold / cached) at 10k..1M rows
+#   crud_bench.sh export [requests]          streamed /list vs sendfile /export of ROWS rows
+#   crud_bench.sh load [http_load options]   http_load.c against a fresh server (TASK= CSV lines)
+#
+# The http mode builds examples/crud_todos/crud_http into a temp dir, seeds a few rows and
+# drives GET /get and /list over persistent connections with curl --parallel, then reports
+# requests/s, latency percentiles and how many TCP connections were opened.
+# WRITES=<percent> turns that share of the requests into /add inserts (default 0).
+# The commit mode runs /add only, once with COMMIT_MAX=1 (every write its own transaction)
+# and once with the server's group-commit defaults. Server knobs (COMMIT_MAX, COMMIT_US,
+# DB_SYNC, HTTP_WORKERS) are passed through from the environment.
+# The pages mode seeds the table with seed_todos.sh and compares a full /list with
+# /list?after=&limit=50 at random cursors (page cache misses) and at 16 hot cursors (hits).
+# The http and export modes also report the server's syscalls per request (/metrics).
+# The load mode builds http_load.c and passes its options through, e.g.
+#   crud_bench.sh load -c 64 -n 200000 -m get=90,add=10 -o results/web.csv
+#   crud_bench.sh load -R 5000 -n 50000      (open loop at 5000 req/s)
 
 set -euo pipefail
+HERE="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+URL=http://127.0.0.1:8080
+
+build_server() {
+  local rt="$HERE/../../internal/aotminic/runtime"
+  cc -O3 -std=c11 -pthread -I"$rt" "$HERE/../../examples/crud_todos/http_server.c" "$rt/rt_sqlite.c" "$rt/rt_json.c" "$rt/rt_http.c" "$rt/rt_arena.c" \
+     -o "$work/crud_http" -lsqlite3 -pthread
+}
+
+# start_server [VAR=value ...]: fresh database with SEED_ROWS rows (default: 100 via /add).
+start_server() {
+  rm -f "$work"/todos.db*
+  if [[ -n "${SEED_ROWS:-}" ]]; then "$HERE/seed_todos.sh" "$work/todos.db" "$SEED_ROWS" >/dev/null; fi
+  (cd "$work" && exec env "$@" ./crud_http >/dev/null 2>&1) & pid=$!
+  for _ in $(seq 50); do curl -s -o /dev/null "$URL/get?id=1" && break; sleep 0.1; done
+  if [[ -z "${SEED_ROWS:-}" ]]; then
+    for i in $(seq 1 100); do curl -s -o /dev/null "$URL/add?title=item$i&priority=$((i % 3))"; done
+  fi
+}
+
+stop_server() { kill "$pid" 2>/dev/null || true; wait "$pid" 2>/dev/null || true; pid=; }
+
+# run_urls clients: fetches every URL of "$work/urls", writes "$work/out" (one
+# "code connects seconds x-cache" line per request) and sets elapsed_ns.
+run_urls() {
+  local t0 t1
+  t0=$(date +%s%N)
+  curl -s -Z --parallel-max "$1" -K "$work/urls" \
+       -w '%{http_code} %{num_connects} %{time_total} %header{x-cache}\n' > "$work/out" 2>/dev/null
+  t1=$(date +%s%N)
+  elapsed_ns=$((t1 - t0))
+}
+
+# load clients requests writes-percent: /get with every 10th request a full /list.
+load() {
+  local clients=$1 reqs=$2 writes=$3
+  for i in $(seq 1 "$reqs"); do
+    if (( i % 100 < writes )); then echo "url = \"$URL/add?title=w$i&priority=1\""
+    elif (( i % 10 == 0 )); then echo "url = \"$URL/list\""
+    else echo "url = \"$URL/get?id=$(( i % 100 + 1 ))\""; fi
+    echo "output = \"/dev/null\""
+  done > "$work/urls"
+  run_urls "$clients"
+}
+
+# scrape: "requests syscalls" totals from /metrics.
+scrape() {
+  curl -s "$URL/metrics" | awk '/^http_requests_total/ { r = $2 } /^http_syscalls_total/ { s += $2 }
+                               END { print r + 0, s + 0 }'
+}
+
+# syscalls_since "requests syscalls": per-request syscalls since that scrape (the
+# scrape request itself is included).
+syscalls_since() {
+  scrape | awk -v r0="${1% *}" -v s0="${1#* }" '{ printf "%.2f", ($1 > r0) ? ($2 - s0) / ($1 - r0) : 0 }'
+}
+
+STATS='
+  function pct(q,  i) { i = int(NR * q); if (i < 1) i = 1; return t[i] * 1000 }
+  { t[NR] = $3; conns += $2; if ($1 != 200) bad++; if ($4 == "hit") hits++ }'
+
+if [[ "${1:-}" == "http" ]]; then
+  clients=${2:-16}
+  reqs=${3:-20000}
+  writes=${WRITES:-0}
+  work="$(mktemp -d)"
+  trap 'stop_server; rm -rf "$work"' EXIT
+  build_server
+  start_server
+
+  echo "[bench] crud_http keep-alive: $clients clients, $reqs requests, $writes% writes"
+  before=$(scrape)
+  load "$clients" "$reqs" "$writes"
+  echo "syscalls   $(syscalls_since "$before") per request"
+  sort -k3 -g "$work/out" | awk -v ns="$elapsed_ns" "$STATS"'
+    END {
+      printf "requests   %d (non-200: %d)\n", NR, bad + 0
+      printf "req/s      %.0f\n", NR / (ns / 1e9)
+      printf "p50        %.3f ms\n", pct(0.50)
+      printf "p99        %.3f ms\n", pct(0.99)
+      printf "max        %.3f ms\n", t[NR] * 1000
+      printf "connects   %d (%.1f requests per connection)\n", conns, conns ? NR / conns : 0
+    }'
+  exit 0
+fi
+
+if [[ "${1:-}" == "commit" ]]; then
+  reqs=${2:-4000}
+  work="$(mktemp -d)"
+  trap 'stop_server; rm -rf "$work"' EXIT
+  build_server
+
+  echo "[bench] crud_http /add only, $reqs requests per run"
+  printf "%-10s %8s %10s %10s %10s\n" mode clients req/s p50_ms p99_ms
+  for mode in per-request group; do
+    for clients in 1 4 16 64 256; do
+      if [[ $mode == per-request ]]; then start_server COMMIT_MAX=1; else start_server; fi
+      load "$clients" "$reqs" 100
+      stop_server
+      sort -k3 -g "$work/out" | awk -v ns="$elapsed_ns" -v m="$mode" -v c="$clients" "$STATS"'
+        END { printf "%-10s %8d %10.0f %10.3f %10.3f%s\n", m, c, NR / (ns / 1e9), pct(0.50), pct(0.99),
+                     bad ? sprintf("  (non-200: %d)", bad) : "" }'
+    done
+  done
+  exit 0
+fi
+
+if [[ "${1:-}" == "pages" ]]; then
+  reqs=${2:-2000}
+  clients=${PAGES_CLIENTS:-8}
+  work="$(mktemp -d)"
+  trap 'stop_server; rm -rf "$work"' EXIT
+  build_server
+
+  echo "[bench] crud_http /list: full vs keyset pages of 50, $clients clients"
+  printf "%-9s %-12s %8s %10s %10s %10s %6s\n" rows query requests req/s p50_ms p99_ms hit%
+  report() {
+    sort -k3 -g "$work/out" | awk -v ns="$elapsed_ns" -v rows="$1" -v q="$2" "$STATS"'
+      END { printf "%-9d %-12s %8d %10.0f %10.3f %10.3f %6.1f%s\n", rows, q, NR, NR / (ns / 1e9),
+                   pct(0.50), pct(0.99), 100 * hits / NR, bad ? sprintf("  (non-200: %d)", bad) : "" }'
+  }
+  for rows in 10000 100000 1000000; do
+    SEED_ROWS=$rows start_server
+
+    for _ in $(seq 5); do printf 'url = "%s/list"\noutput = "/dev/null"\n' "$URL"; done > "$work/urls"
+    run_urls 1; report "$rows" "full"
+
+    for _ in $(seq "$reqs"); do
+      printf 'url = "%s/list?after=%d&limit=50"\noutput = "/dev/null"\n' "$URL" $(( (RANDOM * 32768 + RANDOM) % rows ))
+    done > "$work/urls"
+    run_urls "$clients"; report "$rows" "page-random"
+
+    for i in $(seq "$reqs"); do
+      printf 'url = "%s/list?after=%d&limit=50"\noutput = "/dev/null"\n' "$URL" $(( (i % 16) * 50 ))
+    done > "$work/urls"
+    run_urls "$clients"; report "$rows" "page-hot"
+
+    stop_server
+  done
+  exit 0
+fi
+
+if [[ "${1:-}" == "load" ]]; then
+  shift
+  work="$(mktemp -d)"
+  trap 'stop_server; rm -rf "$work"' EXIT
+  build_server
+  cc -O2 -std=c11 -pthread "$HERE/http_load.c" -o "$work/http_load"
+  start_server
+  "$work/http_load" "$@"
+  exit 0
+fi
+
+if [[ "${1:-}" == "export" ]]; then
+  reqs=${2:-200}
+  rows=${ROWS:-100000}
+  work="$(mktemp -d)"
+  trap 'stop_server; rm -rf "$work"' EXIT
+  build_server
+  SEED_ROWS=$rows start_server
+
+  bytes=$(curl -s "$URL/export" | wc -c)   # also builds the export file
+  echo "[bench] crud_http full table, $rows rows ($bytes bytes), $reqs requests, 4 clients"
+  printf "%-8s %10s %10s %10s %10s %12s\n" path req/s MB/s p50_ms p99_ms syscalls/req
+  for path in list export; do
+    for _ in $(seq "$reqs"); do printf 'url = "%s/%s"\noutput = "/dev/null"\n' "$URL" "$path"; done > "$work/urls"
+    before=$(scrape)
+    run_urls 4
+    sc=$(syscalls_since "$before")
+    sort -k3 -g "$work/out" | awk -v ns="$elapsed_ns" -v p="$path" -v b="$bytes" -v sc="$sc" "$STATS"'
+      END { printf "%-8s %10.0f %10.1f %10.3f %10.3f %12s%s\n", p, NR / (ns / 1e9), NR * b / (ns / 1e3),
+                   pct(0.50), pct(0.99), sc, bad ? sprintf("  (non-200: %d)", bad) : "" }'
+  done
+  exit 0
+fi
+
 BIN="../examples/.bin/crud"
 
 if [[ ! -x "$BIN" ]]; then
@@ -13,4 +210,4 @@ runs=${1:-5}
 echo "[bench] crud demo $runs runs"
 for i in $(seq 1 "$runs"); do
   /usr/bin/time -lp "$BIN" >/dev/null
-done
\ No newline at end of file
+done
@@ -0,0 +1,470 @@
+// FILE: benchmarks/web/http_load.c
+// Purpose: HTTP load generator for examples/crud_todos/http_server.c
+// Opens C keep-alive connections from T threads (each thread runs its own epoll loop
+// over its share of the connections) and replays a weighted mix of /add, /get, /list
+// and /done, one request in flight per connection.
+//   closed loop (default): a connection sends its next request as soon as the previous
+//     response is complete; latency is measured from the send.
+//   open loop (-R rate): requests fall due at a fixed total rate whether or not the
+//     server keeps up; latency is measured from the time a request was due, so waiting
+//     for a free connection is counted (no coordinated omission).
+// Latencies are recorded in an HDR histogram (3 significant digits, 1 ns .. 68 s).
+// Results are printed as TASK=...,TIME_NS=... lines like the other suite benchmarks;
+// -o also appends them as CSV (header written once) for benchmarks/aggregate_results.py:
+//   TASK=http_load          TIME_NS = wall time for all N requests
+//   TASK=http_load_latency  TIME_NS = mean latency of one request type (VARIANT .../op);
+//                           its ERRORS and NON2XX count that type's requests only
+//
+//   cc -O2 -std=c11 -pthread http_load.c -o http_load
+//   ./http_load [-c conns] [-t threads] [-n requests] [-R rate] [-m mix] [-i ids]
+//               [-l limit] [-H host] [-p port] [-o out.csv]
+//   mix    weights, default "get=70,list=5,add=20,done=5"
+//   ids    /get and /done pick ids in [1, ids] (default 100)
+//   limit  /list page size, /list?after=<id>&limit=<limit> (default 50; 0 = full /list)
+#define _GNU_SOURCE
+#include "../src/c/runtime.h"
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// ---- HDR histogram ----
+// Slots 0 .. 2047 hold the values 0 .. 2047 exactly; bucket b >= 1 covers
+// [1024 << b, 2048 << b) in 1024 slots of width 1 << b, so a recorded value is within
+// 1/1024 of the value reported for its slot.
+#define SUB_BITS  11
+#define SUB_HALF  (1 << (SUB_BITS - 1))
+#define HDR_MAXV  ((1ULL << 36) - 1)
+#define HDR_SLOTS ((36 - SUB_BITS + 2) * SUB_HALF)
+
+typedef struct {
+    uint64_t counts[HDR_SLOTS];
+    uint64_t total, max;
+    double   sum;
+} hdr;
+
+static int hdr_index(uint64_t v) {
+    if (v > HDR_MAXV) v = HDR_MAXV;
+    int pow2 = 63 - __builtin_clzll(v | ((1ULL << SUB_BITS) - 1));
+    int b = pow2 - (SUB_BITS - 1);
+    return b * SUB_HALF + (int)(v >> b);
+}
+
+// Largest value that maps to slot i.
+static uint64_t hdr_value(int i) {
+    int b = i < 2 * SUB_HALF ? 0 : i / SUB_HALF - 1;
+    uint64_t sub = (uint64_t)(i - b * SUB_HALF);
+    return ((sub + 1) << b) - 1;
+}
+
+static void hdr_record(hdr *h, uint64_t v) {
+    h->counts[hdr_index(v)]++;
+    h->total++; h->sum += (double)v;
+    if (v > h->max) h->max = v;
+}
+
+static void hdr_merge(hdr *dst, const hdr *src) {
+    for (int i = 0; i < HDR_SLOTS; i++) dst->counts[i] += src->counts[i];
+    dst->total += src->total; dst->sum += src->sum;
+    if (src->max > dst->max) dst->max = src->max;
+}
+
+static uint64_t hdr_pct(const hdr *h, double q) {
+    if (!h->total) return 0;
+    uint64_t want = (uint64_t)(q * (double)h->total + 0.5), seen = 0;
+    if (want < 1) want = 1;
+    for (int i = 0; i < HDR_SLOTS; i++) {
+        seen += h->counts[i];
+        if (seen >= want) { uint64_t v = hdr_value(i); return v < h->max ? v : h->max; }
+    }
+    return h->max;
+}
+
+// ---- configuration ----
+enum { OP_GET, OP_LIST, OP_ADD, OP_DONE, OP_COUNT };
+static const char *const OP_NAME[OP_COUNT] = { "get", "list", "add", "done" };
+
+static int         n_conns = 64, n_threads = 1, id_max = 100, list_limit = 50;
+static long        n_reqs = 100000;
+static double      rate;                  // total req/s; 0 = closed loop
+static int         weight[OP_COUNT] = { 70, 5, 20, 5 };
+static const char *host = "127.0.0.1";
+static int         port = 8080;
+
+// ---- per-connection state ----
+enum { RS_HEAD, RS_BODY, RS_CHUNK_SIZE, RS_CHUNK_DATA, RS_TRAILER };
+
+typedef struct {
+    int       fd, busy, op, want_out;
+    long long start_ns;                   // send time (closed loop) or due time (open)
+    char      out[256];
+    size_t    out_len, out_off;
+    char      head[8192];                 // response head being assembled
+    size_t    head_len;
+    int       rs, status, close_after, line_blank;
+    long long left;                       // body / chunk bytes still to skip
+} conn;
+
+typedef struct {
+    int       id;
+    pthread_t tid;
+    long      quota;                      // requests this thread issues
+    long      sent, done, errors, non2xx;
+    long      op_errors[OP_COUNT], op_non2xx[OP_COUNT];
+    double    interval_ns;                // open loop: time between due requests
+    uint64_t  rng;
+    int       ep, n;
+    conn     *conns;
+    int      *idle, n_idle;
+    long long t0, t_end;
+    hdr       all, per_op[OP_COUNT];
+} worker;
+
+static void die(const char *m) { perror(m); exit(1); }
+
+static int connect_one(void) {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    struct sockaddr_in a = { .sin_family = AF_INET, .sin_port = htons((uint16_t)port) };
+    if (inet_pton(AF_INET, host, &a.sin_addr) != 1 ||
+        connect(fd, (struct sockaddr *)&a, sizeof(a)) < 0) { close(fd); return -1; }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    return fd;
+}
+
+static void conn_open(worker *w, int i) {
+    conn *c = &w->conns[i];
+    c->fd = connect_one();
+    if (c->fd < 0) die("connect");
+    struct epoll_event ev = { .events = EPOLLIN, .data.u32 = (uint32_t)i };
+    if (epoll_ctl(w->ep, EPOLL_CTL_ADD, c->fd, &ev) < 0) die("epoll_ctl");
+    c->busy = 0; c->want_out = 0;
+}
+
+static void watch_out(worker *w, int i, int on) {
+    conn *c = &w->conns[i];
+    if (c->want_out == on) return;
+    struct epoll_event ev = { .events = EPOLLIN | (on ? EPOLLOUT : 0), .data.u32 = (uint32_t)i };
+    epoll_ctl(w->ep, EPOLL_CTL_MOD, c->fd, &ev);
+    c->want_out = on;
+}
+
+static int pick_op(worker *w) {
+    int sum = 0;
+    for (int k = 0; k < OP_COUNT; k++) sum += weight[k];
+    int x = (int)(splitmix64(&w->rng) % (uint64_t)sum);
+    for (int k = 0; k < OP_COUNT; k++) { if (x < weight[k]) return k; x -= weight[k]; }
+    return OP_GET;
+}
+
+static void build_request(worker *w, conn *c) {
+    char target[128];
+    long id = 1 + (long)(splitmix64(&w->rng) % (uint64_t)id_max);
+    switch (c->op) {
+    case OP_GET:  snprintf(target, sizeof(target), "/get?id=%ld", id); break;
+    case OP_DONE: snprintf(target, sizeof(target), "/done?id=%ld", id); break;
+    case OP_ADD:  snprintf(target, sizeof(target), "/add?title=load%d-%ld&priority=%ld", w->id, w->sent, id % 3); break;
+    default:
+        if (list_limit > 0) snprintf(target, sizeof(target), "/list?after=%ld&limit=%d", id, list_limit);
+        else                snprintf(target, sizeof(target), "/list");
+    }
+    int n = snprintf(c->out, sizeof(c->out), "GET %s HTTP/1.1\r\nHost: %s\r\n\r\n", target, host);
+    c->out_len = (size_t)n; c->out_off = 0;
+    c->head_len = 0; c->rs = RS_HEAD;
+}
+
+// Writes what is left of c's request. Returns -1 if the connection failed.
+static int send_rest(worker *w, int i) {
+    conn *c = &w->conns[i];
+    while (c->out_off < c->out_len) {
+        ssize_t n = write(c->fd, c->out + c->out_off, c->out_len - c->out_off);
+        if (n > 0) { c->out_off += (size_t)n; continue; }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) { watch_out(w, i, 1); return 0; }
+        return -1;
+    }
+    watch_out(w, i, 0);
+    return 0;
+}
+
+// Status, framing and Connection of a complete response head.
+static void parse_head(conn *c) {
+    c->head[c->head_len] = '\0';
+    c->status = c->head_len > 12 ? atoi(c->head + 9) : 0;
+    long long cl = 0;
+    int chunked = 0;
+    c->close_after = 0;
+    for (char *p = strchr(c->head, '\n'); p && p[1]; p = strchr(p + 1, '\n')) {
+        const char *h = p + 1;
+        if (strncasecmp(h, "content-length:", 15) == 0) cl = atoll(h + 15);
+        else if (strncasecmp(h, "transfer-encoding:", 18) == 0) chunked = strstr(h, "chunked") != NULL;
+        else if (strncasecmp(h, "connection:", 11) == 0) c->close_after = strstr(h, "close") != NULL;
+    }
+    if (chunked) { c->rs = RS_CHUNK_SIZE; c->left = 0; }
+    else         { c->rs = RS_BODY; c->left = cl; }
+}
+
+// Consumes response bytes. Returns 1 once the response is complete.
+static int feed(conn *c, const char *p, size_t n) {
+    while (n || (c->rs == RS_BODY && !c->left)) {
+        switch (c->rs) {
+        case RS_HEAD: {
+            size_t room = sizeof(c->head) - 1 - c->head_len, take = n < room ? n : room;
+            size_t from = c->head_len > 3 ? c->head_len - 3 : 0;
+            memcpy(c->head + c->head_len, p, take);
+            c->head_len += take;
+            char *e = memmem(c->head + from, c->head_len - from, "\r\n\r\n", 4);
+            if (!e) { if (take == room) { c->status = 0; return 1; } p += take; n -= take; break; }
+            size_t used = (size_t)(e + 4 - c->head) - (c->head_len - take);
+            c->head_len = (size_t)(e + 4 - c->head);
+            p += used; n -= used;
+            parse_head(c);
+            break;
+        }
+        case RS_BODY: {
+            size_t k = (size_t)c->left < n ? (size_t)c->left : n;
+            c->left -= (long long)k; p += k; n -= k;
+            if (!c->left) return 1;
+            break;
+        }
+        case RS_CHUNK_SIZE: {
+            char ch = *p++; n--;
+            if (ch == '\n') {
+                if (c->left) { c->rs = RS_CHUNK_DATA; c->left += 2; }   // data + CRLF
+                else         { c->rs = RS_TRAILER; c->line_blank = 1; }
+            } else if (ch >= '0' && ch <= '9') c->left = c->left * 16 + (ch - '0');
+            else if ((ch | 0x20) >= 'a' && (ch | 0x20) <= 'f') c->left = c->left * 16 + ((ch | 0x20) - 'a' + 10);
+            break;
+        }
+        case RS_CHUNK_DATA: {
+            size_t k = (size_t)c->left < n ? (size_t)c->left : n;
+            c->left -= (long long)k; p += k; n -= k;
+            if (!c->left) c->rs = RS_CHUNK_SIZE;
+            break;
+        }
+        case RS_TRAILER: {
+            char ch = *p++; n--;
+            if (ch == '\n') { if (c->line_blank) return 1; c->line_blank = 1; }
+            else if (ch != '\r') c->line_blank = 0;
+            break;
+        }
+        }
+    }
+    return 0;
+}
+
+static void finish(worker *w, int i, int failed) {
+    conn *c = &w->conns[i];
+    if (failed) { w->errors++; w->op_errors[c->op]++; }
+    else {
+        uint64_t lat = (uint64_t)(now_ns() - c->start_ns);
+        hdr_record(&w->all, lat);
+        hdr_record(&w->per_op[c->op], lat);
+        if (c->status >= 500 || c->status < 200) { w->errors++; w->op_errors[c->op]++; }
+        else if (c->status >= 300) { w->non2xx++; w->op_non2xx[c->op]++; }
+    }
+    w->done++;
+    c->busy = 0;
+    if (failed || c->close_after) { close(c->fd); conn_open(w, i); }
+    w->idle[w->n_idle++] = i;
+}
+
+static void on_readable(worker *w, int i) {
+    conn *c = &w->conns[i];
+    char buf[65536];
+    for (;;) {
+        ssize_t n = read(c->fd, buf, sizeof(buf));
+        if (n > 0) {
+            if (c->busy && feed(c, buf, (size_t)n)) { finish(w, i, c->status == 0); return; }
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+        // EOF or error: the request in flight failed; reconnect.
+        if (c->busy) finish(w, i, 1);
+        else { close(c->fd); conn_open(w, i); }
+        return;
+    }
+}
+
+static void *run(void *arg) {
+    worker *w = arg;
+    w->ep = epoll_create1(EPOLL_CLOEXEC);
+    if (w->ep < 0) die("epoll_create1");
+    w->idle = malloc((size_t)w->n * sizeof(int));
+    if (!w->idle) die("malloc");
+    for (int i = 0; i < w->n; i++) { conn_open(w, i); w->idle[w->n_idle++] = i; }
+
+    struct epoll_event evs[64];
+    w->t0 = now_ns();
+    while (w->done < w->quota) {
+        long long now = now_ns(), due = now;
+        while (w->sent < w->quota && w->n_idle) {
+            due = rate > 0 ? w->t0 + (long long)((double)w->sent * w->interval_ns) : now;
+            if (due > now) break;
+            int i = w->idle[--w->n_idle];
+            conn *c = &w->conns[i];
+            c->op = pick_op(w);
+            build_request(w, c);
+            c->busy = 1; c->start_ns = due;
+            w->sent++;
+            if (send_rest(w, i)) finish(w, i, 1);
+        }
+        // Sleep until the next request falls due, or until a response arrives.
+        long long wait = (rate > 0 && w->sent < w->quota && w->n_idle) ? due - now : 1000000000LL;
+        if (wait < 0) wait = 0;
+        struct timespec ts = { .tv_sec = wait / 1000000000LL, .tv_nsec = wait % 1000000000LL };
+        int n = epoll_pwait2(w->ep, evs, 64, &ts, NULL);
+        if (n < 0) { if (errno == EINTR) continue; die("epoll_pwait2"); }
+        for (int k = 0; k < n; k++) {
+            int i = (int)evs[k].data.u32;
+            if ((evs[k].events & EPOLLOUT) && w->conns[i].busy && send_rest(w, i)) { finish(w, i, 1); continue; }
+            if (evs[k].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) on_readable(w, i);
+        }
+    }
+    w->t_end = now_ns();
+    for (int i = 0; i < w->n; i++) close(w->conns[i].fd);
+    close(w->ep);
+    return NULL;
+}
+
+// ---- reporting ----
+
+static FILE *csv;
+
+static void emit(const char *task, const char *variant, long n, long long time_ns, double rps,
+                 const hdr *h, long errors, long non2xx, const char *mix) {
+    char line[512];
+    snprintf(line, sizeof(line),
+             "%s,c,%s,%ld,%lld,%.0f,%llu,%llu,%llu,%llu,%llu,%ld,%ld,%s",
+             task, variant, n, time_ns, rps,
+             (unsigned long long)hdr_pct(h, 0.50), (unsigned long long)hdr_pct(h, 0.90),
+             (unsigned long long)hdr_pct(h, 0.99), (unsigned long long)hdr_pct(h, 0.999),
+             (unsigned long long)h->max, errors, non2xx, mix);
+    printf("TASK=%s,LANG=c,VARIANT=%s,N=%ld,TIME_NS=%lld,REQ_PER_S=%.0f,P50_NS=%llu,P90_NS=%llu,"
+           "P99_NS=%llu,P999_NS=%llu,MAX_NS=%llu,ERRORS=%ld,NON2XX=%ld,MIX=%s\n",
+           task, variant, n, time_ns, rps,
+           (unsigned long long)hdr_pct(h, 0.50), (unsigned long long)hdr_pct(h, 0.90),
+           (unsigned long long)hdr_pct(h, 0.99), (unsigned long long)hdr_pct(h, 0.999),
+           (unsigned long long)h->max, errors, non2xx, mix);
+    if (csv) fprintf(csv, "%s\n", line);
+}
+
+static void parse_mix(const char *s) {
+    char *dup = strdup(s), *save = NULL;
+    for (int k = 0; k < OP_COUNT; k++) weight[k] = 0;
+    for (char *tok = strtok_r(dup, ",", &save); tok; tok = strtok_r(NULL, ",", &save)) {
+        char *eq = strchr(tok, '=');
+        int k = 0;
+        if (eq) *eq = '\0';
+        while (k < OP_COUNT && strcmp(tok, OP_NAME[k]) != 0) k++;
+        if (k == OP_COUNT || !eq || atoi(eq + 1) < 0) {
+            fprintf(stderr, "http_load: bad mix entry '%s' (ops: get list add done)\n", tok);
+            exit(1);
+        }
+        weight[k] = atoi(eq + 1);
+    }
+    free(dup);
+    int sum = 0;
+    for (int k = 0; k < OP_COUNT; k++) sum += weight[k];
+    if (sum <= 0) { fprintf(stderr, "http_load: mix has no weight\n"); exit(1); }
+}
+
+int main(int argc, char **argv) {
+    const char *csv_path = NULL;
+    int opt;
+    while ((opt = getopt(argc, argv, "c:t:n:R:m:i:l:H:p:o:")) != -1) {
+        switch (opt) {
+        case 'c': n_conns = atoi(optarg); break;
+        case 't': n_threads = atoi(optarg); break;
+        case 'n': n_reqs = atol(optarg); break;
+        case 'R': rate = atof(optarg); break;
+        case 'm': parse_mix(optarg); break;
+        case 'i': id_max = atoi(optarg); break;
+        case 'l': list_limit = atoi(optarg); break;
+        case 'H': host = optarg; break;
+        case 'p': port = atoi(optarg); break;
+        case 'o': csv_path = optarg; break;
+        default:
+            fprintf(stderr, "usage: %s [-c conns] [-t threads] [-n requests] [-R rate] [-m mix] "
+                            "[-i ids] [-l limit] [-H host] [-p port] [-o out.csv]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (n_threads < 1 || n_conns < n_threads || n_reqs < 1 || id_max < 1 || rate < 0) {
+        fprintf(stderr, "http_load: need threads >= 1, conns >= threads, requests >= 1, ids >= 1, rate >= 0\n");
+        return 1;
+    }
+
+    worker *ws = calloc((size_t)n_threads, sizeof(worker));
+    conn *conns = calloc((size_t)n_conns, sizeof(conn));
+    if (!ws || !conns) die("calloc");
+    for (int t = 0, first = 0; t < n_threads; t++) {
+        worker *w = &ws[t];
+        w->id = t;
+        w->n = n_conns / n_threads + (t < n_conns % n_threads);
+        w->conns = conns + first; first += w->n;
+        w->quota = n_reqs / n_threads + (t < n_reqs % n_threads);
+        w->interval_ns = rate > 0 ? 1e9 * n_threads / rate : 0;
+        w->rng = 0x9E3779B97F4A7C15ULL * (uint64_t)(t + 1);
+    }
+    for (int t = 0; t < n_threads; t++) {
+        if (pthread_create(&ws[t].tid, NULL, run, &ws[t]) != 0) die("pthread_create");
+    }
+
+    hdr *all = calloc(1, sizeof(hdr)), *per_op = calloc(OP_COUNT, sizeof(hdr));
+    if (!all || !per_op) die("calloc");
+    long errors = 0, non2xx = 0, op_errors[OP_COUNT] = {0}, op_non2xx[OP_COUNT] = {0};
+    long long t0 = 0, t1 = 0;
+    for (int t = 0; t < n_threads; t++) {
+        worker *w = &ws[t];
+        pthread_join(w->tid, NULL);
+        hdr_merge(all, &w->all);
+        for (int k = 0; k < OP_COUNT; k++) {
+            hdr_merge(&per_op[k], &w->per_op[k]);
+            op_errors[k] += w->op_errors[k]; op_non2xx[k] += w->op_non2xx[k];
+        }
+        errors += w->errors; non2xx += w->non2xx;
+        if (!t0 || w->t0 < t0) t0 = w->t0;
+        if (w->t_end > t1) t1 = w->t_end;
+    }
+
+    char variant[96], mix[96] = "", sub[128];
+    if (rate > 0) snprintf(variant, sizeof(variant), "open%.0f_c%d_t%d", rate, n_conns, n_threads);
+    else          snprintf(variant, sizeof(variant), "closed_c%d_t%d", n_conns, n_threads);
+    for (int k = 0; k < OP_COUNT; k++) {
+        if (!weight[k]) continue;
+        size_t l = strlen(mix);
+        snprintf(mix + l, sizeof(mix) - l, "%s%s%d", l ? "/" : "", OP_NAME[k], weight[k]);
+    }
+    if (csv_path) {
+        struct stat st;
+        int fresh = stat(csv_path, &st) != 0 || st.st_size == 0;
+        csv = fopen(csv_path, "a");
+        if (!csv) die(csv_path);
+        if (fresh) fprintf(csv, "TASK,LANG,VARIANT,N,TIME_NS,REQ_PER_S,P50_NS,P90_NS,P99_NS,P999_NS,MAX_NS,ERRORS,NON2XX,MIX\n");
+    }
+    double secs = (double)(t1 - t0) / 1e9;
+    emit("http_load", variant, n_reqs, t1 - t0, (double)n_reqs / secs, all, errors, non2xx, mix);
+    for (int k = 0; k < OP_COUNT; k++) {
+        if (!per_op[k].total && !op_errors[k]) continue;
+        snprintf(sub, sizeof(sub), "%s/%s", variant, OP_NAME[k]);
+        long long mean = per_op[k].total ? (long long)(per_op[k].sum / (double)per_op[k].total) : 0;
+        emit("http_load_latency", sub, (long)per_op[k].total, mean,
+             (double)per_op[k].total / secs, &per_op[k], op_errors[k], op_non2xx[k], mix);
+    }
+    if (csv) fclose(csv);
+    return errors ? 2 : 0;
+}
@@ -0,0 +1,159 @@
+// FILE: benchmarks/web/http_parse_bench.c
+// Purpose: HTTP request-head parsing microbenchmark (single core, no sockets)
+// Compares rt_http_parse with the framing the CRUD server used before it: memmem for the
+// blank line, strstr-style header lookups, then sscanf of the request line into copies.
+// Cases: a short curl request, a ~10-header browser request, and the browser request
+// arriving in 64-byte reads (the old framing rescans the whole buffer on every read).
+//
+//   cc -O3 -std=c11 -I../../internal/aotminic/runtime http_parse_bench.c
+//      ../../internal/aotminic/runtime/rt_http.c -o http_parse_bench
+//   ./http_parse_bench [iterations]     default 2000000
+#define _GNU_SOURCE
+#include "../src/c/runtime.h"
+#include "rt_http.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+static const char CURL_REQ[] =
+    "GET /get?id=42 HTTP/1.1\r\n"
+    "Host: 127.0.0.1:8080\r\n"
+    "User-Agent: curl/7.88.1\r\n"
+    "Accept: */*\r\n"
+    "\r\n";
+
+static const char BROWSER_REQ[] =
+    "GET /list?after=1200&limit=50 HTTP/1.1\r\n"
+    "Host: todos.example.com\r\n"
+    "Connection: keep-alive\r\n"
+    "sec-ch-ua: \"Chromium\";v=\"124\", \"Google Chrome\";v=\"124\", \"Not-A.Brand\";v=\"99\"\r\n"
+    "sec-ch-ua-mobile: ?0\r\n"
+    "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/124.0.0.0 Safari/537.36\r\n"
+    "sec-ch-ua-platform: \"Linux\"\r\n"
+    "Accept: application/json, text/plain, */*\r\n"
+    "Sec-Fetch-Site: same-origin\r\n"
+    "Sec-Fetch-Mode: cors\r\n"
+    "Referer: https://todos.example.com/\r\n"
+    "Accept-Encoding: gzip, deflate, br, zstd\r\n"
+    "Accept-Language: en-US,en;q=0.9\r\n"
+    "Cookie: session=4f2a9c1e8b7d6a5f; theme=dark\r\n"
+    "\r\n";
+
+// ---- previous framing (as in examples/crud_todos/http_server.c before rt_http) ----
+
+static const char *old_find_header(const char *h, size_t n, const char *name, size_t *vlen) {
+    size_t nl = strlen(name);
+    const char *end = h + n, *p = memchr(h, '\n', n);
+    while (p && ++p < end) {
+        const char *eol = memchr(p, '\n', (size_t)(end - p)); if (!eol) break;
+        if ((size_t)(eol - p) > nl && p[nl] == ':' && strncasecmp(p, name, nl) == 0) {
+            const char *v = p + nl + 1, *e = eol;
+            while (v < e && (*v == ' ' || *v == '\t')) v++;
+            while (e > v && (e[-1] == '\r' || e[-1] == ' ' || e[-1] == '\t')) e--;
+            *vlen = (size_t)(e - v); return v;
+        }
+        p = eol;
+    }
+    return NULL;
+}
+
+static int old_has_token(const char *v, size_t n, const char *tok) {
+    size_t tl = strlen(tok);
+    for (size_t i = 0; i + tl <= n; i++) { if (strncasecmp(v + i, tok, tl) == 0) return 1; }
+    return 0;
+}
+
+// Returns the head length (0 if incomplete); sums a few fields into *sink.
+static size_t old_parse(char *buf, size_t len, long *sink) {
+    const char *eoh = memmem(buf, len, "\r\n\r\n", 4);
+    if (!eoh) return 0;
+    size_t head = (size_t)(eoh - buf) + 4, vl;
+    const char *cl = old_find_header(buf, head, "content-length", &vl);
+    long body = cl ? strtol(cl, NULL, 10) : 0;
+    const char *eol = memchr(buf, '\n', head);
+    int http11 = eol && eol - buf >= 9 && memcmp(eol - 9, "HTTP/1.1", 8) == 0;
+    const char *cv = old_find_header(buf, head, "connection", &vl);
+    int keep = cv && old_has_token(cv, vl, "close") ? 0 : cv && old_has_token(cv, vl, "keep-alive") ? 1 : http11;
+    char saved = buf[head - 1]; buf[head - 1] = '\0';
+    char method[8] = {0}, path[1024] = {0};
+    int ok = sscanf(buf, "%7s %1023s", method, path) == 2;
+    buf[head - 1] = saved;
+    char *qs = strchr(path, '?'); if (qs) *qs++ = '\0';
+    *sink += body + keep + ok + (long)strlen(path) + (qs ? (long)strlen(qs) : 0) + method[0];
+    return head;
+}
+
+static size_t new_parse(rt_http_parser *ps, const char *buf, size_t len, long *sink) {
+    rt_http_req q;
+    int rc = rt_http_parse(ps, buf, len, &q);
+    if (rc <= 0) return 0;
+    *sink += (q.content_length > 0 ? q.content_length : 0) + q.keep_alive + 1
+           + (long)q.path.n + (long)q.query.n + q.method.p[0];
+    return (size_t)rc;
+}
+
+// ---- driver ----
+
+static long long sink_total;
+
+static void report(const char *name, const char *impl, long iters, long long ns) {
+    printf("TASK=http_parse,CASE=%s,IMPL=%s,N=%ld,TIME_NS=%lld,NS_PER_REQ=%.1f,REQ_PER_S=%.0f\n",
+           name, impl, iters, ns, (double)ns / (double)iters, (double)iters * 1e9 / (double)ns);
+}
+
+// Whole head in one read.
+static void run_whole(const char *name, const char *req, long iters) {
+    size_t len = strlen(req);
+    char *buf = malloc(len + 1);
+    memcpy(buf, req, len + 1);
+    long sink = 0;
+
+    long long t0 = now_ns();
+    for (long i = 0; i < iters; i++) { if (!old_parse(buf, len, &sink)) abort(); }
+    report(name, "sscanf", iters, now_ns() - t0);
+
+    t0 = now_ns();
+    for (long i = 0; i < iters; i++) {
+        rt_http_parser ps = {0};
+        if (!new_parse(&ps, buf, len, &sink)) abort();
+    }
+    report(name, "rt_http", iters, now_ns() - t0);
+    sink_total += sink;
+    free(buf);
+}
+
+// Head delivered `step` bytes at a time; every read re-runs the framing.
+static void run_fragmented(const char *name, const char *req, size_t step, long iters) {
+    size_t len = strlen(req);
+    char *buf = malloc(len + 1);
+    memcpy(buf, req, len + 1);
+    long sink = 0;
+
+    long long t0 = now_ns();
+    for (long i = 0; i < iters; i++) {
+        size_t got = 0, head = 0;
+        while (!head) { got = got + step < len ? got + step : len; head = old_parse(buf, got, &sink); }
+    }
+    report(name, "sscanf", iters, now_ns() - t0);
+
+    t0 = now_ns();
+    for (long i = 0; i < iters; i++) {
+        rt_http_parser ps = {0};
+        size_t got = 0, head = 0;
+        while (!head) { got = got + step < len ? got + step : len; head = new_parse(&ps, buf, got, &sink); }
+    }
+    report(name, "rt_http", iters, now_ns() - t0);
+    sink_total += sink;
+    free(buf);
+}
+
+int main(int argc, char **argv) {
+    long iters = argc > 1 ? atol(argv[1]) : 2000000;
+    if (iters <= 0) { fprintf(stderr, "http_parse_bench: iterations must be > 0\n"); return 1; }
+    run_whole("curl", CURL_REQ, iters);
+    run_whole("browser", BROWSER_REQ, iters);
+    run_fragmented("browser_64B_reads", BROWSER_REQ, 64, iters / 4);
+    fprintf(stderr, "checksum %lld\n", sink_total);
+    return 0;
+}
@@ -0,0 +1,28 @@
+#!/usr/bin/env bash
+# Seeds a CRUD demo database with generated todos for list/pagination benchmarks.
+#
+#   seed_todos.sh <db> [rows]      rows defaults to 1000000
+#
+# Creates the table with the HTTP server's schema if needed and appends the rows in one
+# transaction (a recursive CTE inside sqlite3, about a second per million rows).
+
+set -euo pipefail
+db=${1:?usage: seed_todos.sh <db> [rows]}
+rows=${2:-1000000}
+
+sqlite3 "$db" <<SQL
+PRAGMA journal_mode=WAL;
+CREATE TABLE IF NOT EXISTS todos (
+  id INTEGER PRIMARY KEY AUTOINCREMENT,
+  title TEXT NOT NULL,
+  priority INTEGER NOT NULL DEFAULT 0,
+  done INTEGER NOT NULL DEFAULT 0,
+  created_at TEXT NOT NULL DEFAULT (datetime('now'))
+);
+BEGIN;
+WITH RECURSIVE n(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM n WHERE x < $rows)
+INSERT INTO todos(title, priority, done)
+  SELECT 'task ' || x || ' "seeded"', x % 3, (x % 7 = 0) FROM n;
+COMMIT;
+SQL
+echo "[seed] $db: $(sqlite3 "$db" 'SELECT count(*) FROM todos;') rows"
@@ -0,0 +1,389 @@
+// cmd/tenge/bounds.go
+package main
+
+// Bounds checks for slice indexing in emitted C, and the range analysis that removes
+// the ones it can prove redundant.
+//
+// A template names its slices (identifier -> C expression for the length) and
+// checkSlices rewrites every `name[index]` in its C source:
+//   - provably in range: left as is. Proofs come from counted loops
+//     `for(int v=lo; v<hi; v++)` (also `<=`, `v+=K`) whose body assigns neither v nor
+//     anything in lo and hi: v[i] is in range when lo is provably >= 0 (a literal, or a
+//     loop variable that is) and hi is the slice's length;
+//   - the index is such a loop variable, but lo or hi is not provable: the loop gets a
+//     single RT_CHECK_RANGE(len, lo, hi) in front of it, and the accesses stay as is.
+//     The check moves further out past every enclosing counted loop whose variable it
+//     does not read and whose body is straight-line code that assigns nothing it reads;
+//     each such loop adds the guard lo<hi, so the check still runs only when the inner
+//     loop would (nbody's `if(j0<jn) RT_CHECK_RANGE(N, i0, in);` ahead of the j loop);
+//   - anything else: RT_AT(name, len, index).
+// The templates are written in the subset of C this needs: loops over slices are for
+// loops with simple bounds (the lowering of `while i < n { ...; i = i + 1 }`).
+
+import (
+	"fmt"
+	"regexp"
+	"strings"
+)
+
+type loopFact struct {
+	v      string
+	lo, hi string // v in [lo, hi)
+	nonneg bool   // lo >= 0 and v only grows
+}
+
+// hoist is what a loop body leaves to the loops around it: an access name[v] that the
+// loop over v covers with one range check, or (check != "") a finished check to be
+// placed in front of the enclosing loop at depth.
+type hoist struct {
+	v, len string
+	check  string
+	depth  int
+}
+
+// encl is an enclosing for loop: its fact (nil if the header is not a counted loop) and
+// its body before rewriting.
+type encl struct {
+	f    *loopFact
+	body string
+}
+
+type boundsPass struct {
+	slices map[string]string
+}
+
+func checkSlices(src string, slices map[string]string) string {
+	p := boundsPass{slices}
+	out, _ := p.rewrite(src, nil, nil)
+	return out
+}
+
+var (
+	forHeader  = regexp.MustCompile(`^\s*(?:int|long|size_t)\s+(\w+)\s*=\s*([^;]+?)\s*;\s*(\w+)\s*(<=|<)\s*([^;]+?)\s*;\s*(?:(\w+)\s*\+\+|\+\+\s*(\w+)|(\w+)\s*\+=\s*(\w+))\s*$`)
+	pureExpr   = regexp.MustCompile(`^[\w\s+\-*]+$`)
+	identRe    = regexp.MustCompile(`[A-Za-z_]\w*`)
+	decimalLit = regexp.MustCompile(`^\d+$`)
+)
+
+func isIdent(c byte) bool {
+	return c == '_' || c >= 'a' && c <= 'z' || c >= 'A' && c <= 'Z' || c >= '0' && c <= '9'
+}
+
+func compact(s string) string { return strings.Join(strings.Fields(s), "") }
+
+// paren wraps e for use as an operand unless it is an identifier or a literal.
+func paren(e string) string {
+	if identRe.FindString(e) == e || decimalLit.MatchString(e) {
+		return e
+	}
+	return "(" + e + ")"
+}
+
+// skipQuoted returns the index after the string, char literal or comment at i (or i).
+func skipQuoted(s string, i int) int {
+	switch {
+	case strings.HasPrefix(s[i:], "//"):
+		if e := strings.IndexByte(s[i:], '\n'); e >= 0 {
+			return i + e
+		}
+		return len(s)
+	case strings.HasPrefix(s[i:], "/*"):
+		if e := strings.Index(s[i+2:], "*/"); e >= 0 {
+			return i + 2 + e + 2
+		}
+		return len(s)
+	case s[i] == '"' || s[i] == '\'':
+		q := s[i]
+		for j := i + 1; j < len(s); j++ {
+			if s[j] == '\\' {
+				j++
+			} else if s[j] == q {
+				return j + 1
+			}
+		}
+		return len(s)
+	}
+	return i
+}
+
+// match returns the index just past the bracket that closes s[i] ('(', '[' or '{').
+func match(s string, i int) int {
+	depth := 0
+	for j := i; j < len(s); {
+		if k := skipQuoted(s, j); k != j {
+			j = k
+			continue
+		}
+		switch s[j] {
+		case '(', '[', '{':
+			depth++
+		case ')', ']', '}':
+			depth--
+			if depth == 0 {
+				return j + 1
+			}
+		}
+		j++
+	}
+	return len(s)
+}
+
+func skipSpace(s string, i int) int {
+	for i < len(s) && (s[i] == ' ' || s[i] == '\t' || s[i] == '\n' || s[i] == '\r') {
+		i++
+	}
+	return i
+}
+
+// statement returns the end of the C statement starting at s[i].
+func statement(s string, i int) int {
+	i = skipSpace(s, i)
+	if i < len(s) && s[i] == '{' {
+		return match(s, i)
+	}
+	for _, kw := range []string{"for", "while", "if"} {
+		if strings.HasPrefix(s[i:], kw) && i+len(kw) < len(s) && !isIdent(s[i+len(kw)]) {
+			h := skipSpace(s, i+len(kw))
+			end := statement(s, match(s, h))
+			if kw == "if" {
+				e := skipSpace(s, end)
+				if strings.HasPrefix(s[e:], "else") && e+4 < len(s) && !isIdent(s[e+4]) {
+					end = statement(s, e+4)
+				}
+			}
+			return end
+		}
+	}
+	depth := 0
+	for j := i; j < len(s); {
+		if k := skipQuoted(s, j); k != j {
+			j = k
+			continue
+		}
+		switch s[j] {
+		case '(', '[', '{':
+			depth++
+		case ')', ']', '}':
+			depth--
+		case ';':
+			if depth == 0 {
+				return j + 1
+			}
+		}
+		j++
+	}
+	return len(s)
+}
+
+// assigns reports whether body may change the variable name.
+func assigns(body, name string) bool {
+	for i := 0; ; {
+		k := strings.Index(body[i:], name)
+		if k < 0 {
+			return false
+		}
+		k += i
+		i = k + len(name)
+		if k > 0 && isIdent(body[k-1]) || i < len(body) && isIdent(body[i]) {
+			continue
+		}
+		before := strings.TrimRight(body[:k], " \t")
+		if strings.HasSuffix(before, "++") || strings.HasSuffix(before, "--") || strings.HasSuffix(before, "&") && !strings.HasSuffix(before, "&&") {
+			return true
+		}
+		after := strings.TrimLeft(body[i:], " \t")
+		if strings.HasPrefix(after, "++") || strings.HasPrefix(after, "--") {
+			return true
+		}
+		for _, op := range []string{"=", "+=", "-=", "*=", "/=", "%=", "&=", "|=", "^=", "<<=", ">>="} {
+			if strings.HasPrefix(after, op) && !strings.HasPrefix(after, "==") {
+				return true
+			}
+		}
+	}
+}
+
+// straight reports whether, once body is entered, every statement directly in it runs:
+// no branches, while/do loops or jumps (inner for loops end by their condition alone).
+func straight(body string) bool {
+	for _, w := range identRe.FindAllString(body, -1) {
+		switch w {
+		case "if", "while", "do", "switch", "break", "continue", "return", "goto":
+			return false
+		}
+	}
+	return true
+}
+
+// liftable reports whether a check reading ids can move in front of the loop e.
+func liftable(e encl, ids []string) bool {
+	if e.f == nil || !straight(e.body) {
+		return false
+	}
+	for _, id := range ids {
+		if id == e.f.v || assigns(e.body, id) {
+			return false
+		}
+	}
+	return true
+}
+
+// declares reports whether the name that follows before is being declared (`unsigned cnt[256]`).
+func declares(before string) bool {
+	before = strings.TrimRight(before, " \t")
+	k := len(before)
+	for k > 0 && isIdent(before[k-1]) {
+		k--
+	}
+	switch w := before[k:]; w {
+	case "", "return", "case", "else", "do":
+		return false
+	}
+	return true
+}
+
+func (p boundsPass) nonneg(e string, facts []loopFact) bool {
+	e = compact(e)
+	if decimalLit.MatchString(e) {
+		return true
+	}
+	for _, part := range strings.Split(e, "+") {
+		if decimalLit.MatchString(part) {
+			continue
+		}
+		ok := false
+		for k := len(facts) - 1; k >= 0; k-- {
+			if facts[k].v == part {
+				ok = facts[k].nonneg
+				break
+			}
+		}
+		if !ok {
+			return false
+		}
+	}
+	return true
+}
+
+// forLoop rewrites the loop whose header starts at s[h] ('(') and whose body ends at end;
+// outer are the loops around it, innermost last.
+func (p boundsPass) forLoop(s string, h, end int, facts []loopFact, outer []encl) (string, []hoist) {
+	he := match(s, h)
+	header, body := s[h+1:he-1], s[he:end]
+	newHeader, hs := p.rewrite(header, facts, outer)
+	m := forHeader.FindStringSubmatch(header)
+	var f *loopFact
+	if m != nil {
+		v, lo, op, hi := m[1], m[2], m[4], m[5]
+		step := m[9]
+		inc := m[6] + m[7] + m[8]
+		ok := m[3] == v && inc == v && pureExpr.MatchString(lo) && pureExpr.MatchString(hi) && !assigns(body, v)
+		for _, id := range identRe.FindAllString(lo+" "+hi, -1) {
+			ok = ok && !assigns(body, id)
+		}
+		if ok {
+			if op == "<=" {
+				if identRe.FindString(hi) != hi && !decimalLit.MatchString(hi) {
+					hi = "(" + hi + ")"
+				}
+				hi += "+1"
+			}
+			f = &loopFact{v: v, lo: lo, hi: hi, nonneg: (step == "" || decimalLit.MatchString(step)) && p.nonneg(lo, facts)}
+		}
+	}
+	inner := facts
+	if f != nil {
+		inner = append(append([]loopFact(nil), facts...), *f)
+	}
+	depth := len(outer)
+	newBody, bh := p.rewrite(body, inner, append(outer[:depth:depth], encl{f, body}))
+	var checks []string
+	seen := map[string]bool{}
+	for _, x := range bh {
+		if x.check == "" && f != nil && x.v == f.v {
+			// Walk out while the enclosing loop neither moves nor skips the range.
+			ids := identRe.FindAllString(x.len+" "+f.lo+" "+f.hi, -1)
+			var guards []string
+			at := depth
+			for at > 0 && liftable(outer[at-1], ids) {
+				e := outer[at-1].f
+				guards = append(guards, paren(e.lo)+"<"+paren(e.hi))
+				ids = append(ids, identRe.FindAllString(e.lo+" "+e.hi, -1)...)
+				at--
+			}
+			x = hoist{check: fmt.Sprintf("RT_CHECK_RANGE(%s, %s, %s);", x.len, f.lo, f.hi), depth: at}
+			if len(guards) > 0 {
+				x.check = "if(" + strings.Join(guards, " && ") + ") " + x.check
+			}
+		}
+		if x.check == "" || x.depth != depth {
+			hs = append(hs, x)
+		} else if !seen[x.check] {
+			seen[x.check] = true
+			checks = append(checks, x.check)
+		}
+	}
+	loop := "for(" + newHeader + ")" + newBody
+	if len(checks) > 0 {
+		loop = "{ " + strings.Join(checks, " ") + " " + loop + " }"
+	}
+	return loop, hs
+}
+
+// index decides how to emit name[idx].
+func (p boundsPass) index(name, idx string, facts []loopFact) (string, []hoist) {
+	n := p.slices[name]
+	v := compact(idx)
+	for k := len(facts) - 1; k >= 0; k-- {
+		f := facts[k]
+		if f.v != v {
+			continue
+		}
+		if f.nonneg && compact(f.hi) == compact(n) {
+			return name + "[" + idx + "]", nil
+		}
+		return name + "[" + idx + "]", []hoist{{v: v, len: n}}
+	}
+	return fmt.Sprintf("RT_AT(%s, %s, %s)", name, n, idx), nil
+}
+
+func (p boundsPass) rewrite(s string, facts []loopFact, loops []encl) (string, []hoist) {
+	var out strings.Builder
+	var hs []hoist
+	for i := 0; i < len(s); {
+		if k := skipQuoted(s, i); k != i {
+			out.WriteString(s[i:k])
+			i = k
+			continue
+		}
+		if !isIdent(s[i]) || i > 0 && isIdent(s[i-1]) {
+			out.WriteByte(s[i])
+			i++
+			continue
+		}
+		j := i
+		for j < len(s) && isIdent(s[j]) {
+			j++
+		}
+		w, next := s[i:j], skipSpace(s, j)
+		switch {
+		case w == "for" && next < len(s) && s[next] == '(':
+			end := statement(s, match(s, next))
+			loop, h := p.forLoop(s, next, end, facts, loops)
+			out.WriteString(loop)
+			hs = append(hs, h...)
+			i = end
+		case p.slices[w] != "" && next < len(s) && s[next] == '[' && !declares(s[:i]):
+			e := match(s, next)
+			idx, h := p.rewrite(s[next+1:e-1], facts, loops)
+			acc, h2 := p.index(w, idx, facts)
+			out.WriteString(acc)
+			hs = append(append(hs, h...), h2...)
+			i = e
+		default:
+			out.WriteString(w)
+			i = j
+		}
+	}
+	return out.String(), hs
+}
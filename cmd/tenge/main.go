@@ -6,29 +6,47 @@ import (
 	"fmt"
 	"os"
 	"path/filepath"
+	"sort"
+	"strconv"
 	"strings"
 )
 
 func usage() {
-	fmt.Fprintln(os.Stderr, "usage: tenge -o <out.c> <demo_source.tng>")
+	fmt.Fprintln(os.Stderr, "usage: tenge [build] [--profile] [-D name=value]... -o <out.c> <demo_source.tng>")
 	os.Exit(2)
 }
 
 func main() {
+	// `tenge build ...` is the same as `tenge ...`.
+	args := os.Args[1:]
+	if len(args) > 0 && args[0] == "build" {
+		args = args[1:]
+	}
+	defs := defines{}
 	out := flag.String("o", "", "output C file")
-	flag.Parse()
-	args := flag.Args()
+	flag.Var(defs, "D", "name=value: emit a variant specialized for this argument (repeatable)")
+	profile := flag.Bool("profile", false, "count entries and cycles of every function and loop; link with runtime/rt_prof.c")
+	flag.CommandLine.Parse(args)
+	args = flag.Args()
 	if *out == "" || len(args) != 1 {
 		usage()
 	}
 	src := args[0]
 	base := strings.ToLower(filepath.Base(src))
 
-	code, ok := emitC(base)
+	sp, err := specFor(base, defs)
+	if err != nil {
+		fmt.Fprintf(os.Stderr, "error: %v\n", err)
+		os.Exit(2)
+	}
+	code, ok := emitC(base, sp)
 	if !ok {
 		fmt.Fprintf(os.Stderr, "error: unsupported AOT demo source: %s\n", src)
 		os.Exit(1)
 	}
+	if *profile {
+		code = profileC(code)
+	}
 	if err := os.WriteFile(*out, []byte(code), 0o644); err != nil {
 		fmt.Fprintf(os.Stderr, "error: write %s: %v\n", *out, err)
 		os.Exit(1)
@@ -45,6 +63,8 @@ func commonIncludes() string {
 #include <stdlib.h>
 #include <math.h>
 #include "runtime.h"    // now_ns()
+#include "rt_alloc.h"   // rt_alloc(), rt_free(): link with runtime/rt_alloc.c
+#include "rt_slice.h"   // RT_AT(), RT_CHECK_RANGE(): slice bounds checks
 `
 }
 
@@ -57,9 +77,116 @@ static inline double u01(uint64_t* s){ return (xorshift64(s)>>11)*(1.0/900719925
 `
 }
 
+// ---------- par loops ----------
+
+// parLoop is the lowering input for an ast.ParStatement:
+//
+//	par Index = From..To { Body }
+//	par Index = From..To : Reduce(Acc) { Body }
+//
+// The range is cut into fixed chunks of Chunk iterations, and rt_parallel_for hands
+// chunk ranges to the rt_sched pool. A reduction folds each chunk into its own partial,
+// and the partials are folded into Acc in chunk order. Chunk boundaries do not depend on
+// the thread count, so neither does the result. The template includes rt_sched.h (and
+// limits.h for integer min/max).
+type parLoop struct {
+	Name     string   // C symbol prefix, unique per loop
+	Index    string   // loop variable (long inside the body)
+	From, To string   // C expressions, evaluated once at the loop
+	Chunk    int      // iterations per chunk
+	Captures []string // "type name" of the outer locals the body reads
+	Body     string   // C statements
+	Reduce   string   // "", "sum", "min" or "max"
+	Acc      string   // reduction target (an outer local)
+	AccType  string   // its C type: double, long or int
+}
+
+func parIdentity(op, typ string) string {
+	lim := map[string][2]string{"double": {"INFINITY", "-INFINITY"}, "long": {"LONG_MAX", "LONG_MIN"}, "int": {"INT_MAX", "INT_MIN"}}[typ]
+	switch op {
+	case "min":
+		return lim[0]
+	case "max":
+		return lim[1]
+	}
+	return "0"
+}
+
+func parFold(op, acc, x string) string {
+	switch op {
+	case "min":
+		return fmt.Sprintf("if (%s < %s) %s = %s;", x, acc, acc, x)
+	case "max":
+		return fmt.Sprintf("if (%s > %s) %s = %s;", x, acc, acc, x)
+	}
+	return fmt.Sprintf("%s += %s;", acc, x)
+}
+
+// parFor returns the file-scope declarations of p (context struct and chunk function)
+// and the statement block that replaces the loop at its site.
+func parFor(p parLoop) (decl, site string) {
+	var d, c strings.Builder
+	fmt.Fprintf(&d, "\n// par %s = %s..%s", p.Index, p.From, p.To)
+	if p.Reduce != "" {
+		fmt.Fprintf(&d, " : %s(%s)", p.Reduce, p.Acc)
+	}
+	fmt.Fprintf(&d, "\ntypedef struct {\n")
+	for _, v := range p.Captures {
+		fmt.Fprintf(&d, "    %s;\n", v)
+	}
+	d.WriteString("    long from, to;\n")
+	if p.Reduce != "" {
+		fmt.Fprintf(&d, "    %s *part;\n", p.AccType)
+	}
+	fmt.Fprintf(&d, "} %s_ctx;\n", p.Name)
+	fmt.Fprintf(&d, "static void %s_chunks(long c0, long c1, void* vctx){\n", p.Name)
+	fmt.Fprintf(&d, "    const %s_ctx* ctx = (const %s_ctx*)vctx;\n", p.Name, p.Name)
+	for _, v := range p.Captures {
+		name := v[strings.LastIndexAny(v, " *")+1:]
+		fmt.Fprintf(&d, "    %s = ctx->%s;\n", v, name)
+	}
+	d.WriteString("    for(long c=c0;c<c1;c++){\n")
+	fmt.Fprintf(&d, "        long lo = ctx->from + c*%dL, hi = lo + %dL < ctx->to ? lo + %dL : ctx->to;\n", p.Chunk, p.Chunk, p.Chunk)
+	if p.Reduce != "" {
+		fmt.Fprintf(&d, "        %s %s = %s;\n", p.AccType, p.Acc, parIdentity(p.Reduce, p.AccType))
+	}
+	fmt.Fprintf(&d, "        for(long %s=lo;%s<hi;%s++){\n", p.Index, p.Index, p.Index)
+	for _, line := range strings.Split(strings.Trim(p.Body, "\n"), "\n") {
+		fmt.Fprintf(&d, "            %s\n", line)
+	}
+	d.WriteString("        }\n")
+	if p.Reduce != "" {
+		fmt.Fprintf(&d, "        ctx->part[c] = %s;\n", p.Acc)
+	}
+	d.WriteString("    }\n}\n")
+
+	c.WriteString("{\n")
+	fmt.Fprintf(&c, "        long from_ = %s, to_ = %s;\n", p.From, p.To)
+	fmt.Fprintf(&c, "        long nchunks_ = to_ > from_ ? (to_ - from_ + %dL - 1) / %dL : 0;\n", p.Chunk, p.Chunk)
+	fmt.Fprintf(&c, "        %s_ctx ctx_ = {", p.Name)
+	for _, v := range p.Captures {
+		fmt.Fprintf(&c, " %s,", v[strings.LastIndexAny(v, " *")+1:])
+	}
+	c.WriteString(" from_, to_")
+	if p.Reduce != "" {
+		fmt.Fprintf(&c, ", (%s*)rt_alloc((size_t)(nchunks_ ? nchunks_ : 1)*sizeof(%s))", p.AccType, p.AccType)
+	}
+	c.WriteString(" };\n")
+	if p.Reduce != "" {
+		c.WriteString("        if(!ctx_.part){ fprintf(stderr,\"oom\\n\"); exit(1); }\n")
+	}
+	fmt.Fprintf(&c, "        rt_parallel_for(0, nchunks_, 1, %s_chunks, &ctx_);\n", p.Name)
+	if p.Reduce != "" {
+		fmt.Fprintf(&c, "        for(long c=0;c<nchunks_;c++){ %s }\n", parFold(p.Reduce, p.Acc, "ctx_.part[c]"))
+		c.WriteString("        rt_free(ctx_.part);\n")
+	}
+	c.WriteString("    }")
+	return d.String(), c.String()
+}
+
 // ---------- dispatch ----------
 
-func emitC(base string) (string, bool) {
+func emitC(base string, sp nbodySpec) (string, bool) {
 	switch base {
 
 	// Fibonacci
@@ -68,7 +195,7 @@ func emitC(base string) (string, bool) {
 	case "fib_rec_cli.tng":
 		return cFibRec(), true
 
-	// Sort family (AOT demos)
+	// Sort family (AOT demos; link with runtime/rt_alloc.c)
 	case "sort_qsort_cli.tng":
 		return cSortQsort(), true
 	case "sort_msort_cli.tng":
@@ -78,7 +205,7 @@ func emitC(base string) (string, bool) {
 	case "sort_radix_cli.tng":
 		return cSortRadix(), true
 
-	// VaR Monte Carlo — ваши текущие имена
+	// VaR Monte Carlo — ваши текущие имена (link with runtime/rt_alloc.c; var_mc_zig also rt_sched.c)
 	case "var_mc_sort_cli.tng":
 		return cVarMCSort(), true
 	case "var_mc_zig_cli.tng":
@@ -96,15 +223,33 @@ func emitC(base string) (string, bool) {
 
 	// N-body — текущие имена
 	case "nbody_cli.tng":
-		return cNBody(), true
+		return cNBody(sp), true
 	case "nbody_sym_cli.tng":
-		return cNBodySym(), true
+		return cNBodySym(sp), true
 
 	// N-body — старые имена
 	case "nbody_tng.tng":
-		return cNBody(), true
+		return cNBody(sp), true
 	case "nbody_tng_sym.tng":
-		return cNBodySym(), true
+		return cNBodySym(sp), true
+
+	// Spectral kernels (link with runtime/rt_fft.c, rt_alloc.c)
+	case "fft_cli.tng":
+		return cFFT(), true
+
+	// Dense linear algebra (link with runtime/rt_matrix.c, rt_alloc.c, rt_sched.c; portfolio also rt_portfolio.c)
+	case "matrix_ops_cli.tng":
+		return cMatrixOps(), true
+	case "portfolio_opt_cli.tng":
+		return cPortfolioOpt(), true
+
+	// Volatility models (link with runtime/rt_garch.c, rt_alloc.c, rt_sched.c)
+	case "garch_cli.tng":
+		return cGarchFit(), true
+
+	// Curve fitting (link with runtime/rt_nss.c, rt_alloc.c, rt_sched.c)
+	case "yield_curve_cli.tng":
+		return cYieldCurveFit(), true
 	}
 	return "", false
 }
@@ -142,15 +287,16 @@ int main(int argc, char** argv){
 `
 }
 
+// a is a []i32 of length n.
 func cSortQsort() string {
-	return commonIncludes() + `
+	return checkSlices(commonIncludes()+`
 static int cmp_int(const void* a, const void* b){
     int x = *(const int*)a, y = *(const int*)b;
     return (x>y)-(x<y);
 }
 int main(int argc, char** argv){
     int n = (argc>1)? atoi(argv[1]) : 100000;
-    int* a = (int*)malloc(n*sizeof(int));
+    int* a = (int*)rt_alloc(n*sizeof(int));
     if(!a){ fprintf(stderr,"oom\n"); return 1; }
     uint64_t x=88172645463393265ULL;
     for(int i=0;i<n;i++){ x = x*2862933555777941757ULL + 3037000493ULL; a[i] = (int)(x>>33); }
@@ -158,14 +304,15 @@ int main(int argc, char** argv){
     qsort(a,n,sizeof(int),cmp_int);
     long long t1 = now_ns();
     printf("TASK=sort_qsort,N=%d,TIME_NS=%lld\n", n, (t1 - t0));
-    free(a);
+    rt_free(a);
     return 0;
 }
-`
+`, map[string]string{"a": "n"})
 }
 
+// a is a []i32 of length n.
 func cSortMergesort() string {
-	return commonIncludes() + `
+	return checkSlices(commonIncludes()+`
 #if defined(__APPLE__) || defined(__BSD_LIBC) || defined(__GLIBC__)
 int mergesort(void *base, size_t nmemb, size_t size,
               int (*compar)(const void *, const void *));
@@ -176,7 +323,7 @@ static int cmp_int(const void* a, const void* b){
 }
 int main(int argc, char** argv){
     int n = (argc>1)? atoi(argv[1]) : 100000;
-    int* a = (int*)malloc(n*sizeof(int));
+    int* a = (int*)rt_alloc(n*sizeof(int));
     if(!a){ fprintf(stderr,"oom\n"); return 1; }
     uint64_t x=88172645463393265ULL;
     for(int i=0;i<n;i++){ x = x*2862933555777941757ULL + 3037000493ULL; a[i] = (int)(x>>33); }
@@ -188,38 +335,39 @@ int main(int argc, char** argv){
 #endif
     long long t1 = now_ns();
     printf("TASK=sort_msort,N=%d,TIME_NS=%lld\n", n, (t1 - t0));
-    free(a);
+    rt_free(a);
     return 0;
 }
-`
+`, map[string]string{"a": "n"})
 }
 
+// The array is a []i32: a pointer and its length a_len, bounds-checked.
 func cSortPDQ() string {
-	return commonIncludes() + `
+	return checkSlices(commonIncludes()+`
 static inline void iswap(int* a, int* b){ int t=*a; *a=*b; *b=t; }
-static int median3(int* a,int i,int j,int k){
+static int median3(int* a,size_t a_len,int i,int j,int k){
     int x=a[i], y=a[j], z=a[k];
     if((x<y) ^ (x<z)) return i;
     if((y<x) ^ (y<z)) return j;
     return k;
 }
-static int part(int* a,int l,int r){
+static int part(int* a,size_t a_len,int l,int r){
     int m = l + (r-l)/2;
-    int p = median3(a,l,m,r);
+    int p = median3(a,a_len,l,m,r);
     iswap(&a[p], &a[r]);
     int pivot = a[r], i=l;
     for(int j=l;j<r;j++) if(a[j] <= pivot){ iswap(&a[i], &a[j]); i++; }
     iswap(&a[i], &a[r]);
     return i;
 }
-static void insertion(int* a,int l,int r){
+static void insertion(int* a,size_t a_len,int l,int r){
     for(int i=l+1;i<=r;i++){
         int x=a[i], j=i-1;
         while(j>=l && a[j]>x){ a[j+1]=a[j]; j--; }
         a[j+1]=x;
     }
 }
-static void introsort_rec(int* a,int l,int r,int depth){
+static void introsort_rec(int* a,size_t a_len,int l,int r,int depth){
     while(r-l>32){
         if(depth==0){
             for(int i=l;i<=r;i++){
@@ -229,35 +377,37 @@ static void introsort_rec(int* a,int l,int r,int depth){
             }
             return;
         }
-        int p = part(a,l,r);
-        if(p-l < r-p){ introsort_rec(a,l,p-1,depth-1); l=p+1; }
-        else         { introsort_rec(a,p+1,r,depth-1); r=p-1; }
+        int p = part(a,a_len,l,r);
+        if(p-l < r-p){ introsort_rec(a,a_len,l,p-1,depth-1); l=p+1; }
+        else         { introsort_rec(a,a_len,p+1,r,depth-1); r=p-1; }
     }
-    insertion(a,l,r);
+    insertion(a,a_len,l,r);
 }
 int main(int argc, char** argv){
     int n = (argc>1)? atoi(argv[1]) : 100000;
-    int* a = (int*)malloc(n*sizeof(int));
+    int* a = (int*)rt_alloc(n*sizeof(int));
     if(!a){ fprintf(stderr,"oom\n"); return 1; }
+    size_t a_len = (size_t)n;
     uint64_t x=88172645463393265ULL;
-    for(int i=0;i<n;i++){ x = x*2862933555777941757ULL + 3037000493ULL; a[i] = (int)(x>>33); }
+    for(size_t i=0;i<a_len;i++){ x = x*2862933555777941757ULL + 3037000493ULL; a[i] = (int)(x>>33); }
     long long t0 = now_ns();
     int depth = 2; while((1<<depth) < n) depth++;
-    introsort_rec(a,0,n-1,depth*2);
+    introsort_rec(a,a_len,0,n-1,depth*2);
     long long t1 = now_ns();
     printf("TASK=sort_pdq,N=%d,TIME_NS=%lld\n", n, (t1 - t0));
-    free(a);
+    rt_free(a);
     return 0;
 }
-`
+`, map[string]string{"a": "a_len"})
 }
 
+// a and b are []u32 of length n; cnt is a [256]u32.
 func cSortRadix() string {
-	return commonIncludes() + `
+	return checkSlices(commonIncludes()+`
 int main(int argc, char** argv){
     int n = (argc>1)? atoi(argv[1]) : 100000;
-    uint32_t* a = (uint32_t*)malloc(n*sizeof(uint32_t));
-    uint32_t* b = (uint32_t*)malloc(n*sizeof(uint32_t));
+    uint32_t* a = (uint32_t*)rt_alloc(n*sizeof(uint32_t));
+    uint32_t* b = (uint32_t*)rt_alloc(n*sizeof(uint32_t));
     if(!a || !b){ fprintf(stderr,"oom\n"); return 1; }
     uint64_t x=88172645463393265ULL;
     for(int i=0;i<n;i++){ x = x*2862933555777941757ULL + 3037000493ULL; a[i] = (uint32_t)(x>>32); }
@@ -273,14 +423,15 @@ int main(int argc, char** argv){
     }
     long long t1 = now_ns();
     printf("TASK=sort_radix,N=%d,TIME_NS=%lld\n", n, (t1 - t0));
-    free(a); free(b);
+    rt_free(a); rt_free(b);
     return 0;
 }
-`
+`, map[string]string{"a": "n", "b": "n", "cnt": "256"})
 }
 
+// pnl is a []f64 of length N.
 func cVarMCSort() string {
-	return commonIncludes() + rngHelpers() + `
+	return checkSlices(commonIncludes()+rngHelpers()+`
 static int cmp_d(const void* a,const void* b){
     double x=*(const double*)a, y=*(const double*)b;
     return (x>y)-(x<y);
@@ -289,7 +440,7 @@ int main(int argc, char** argv){
     int N    = (argc>1)? atoi(argv[1]) : 1000000;
     int steps= (argc>2)? atoi(argv[2]) : 1;
     double a = (argc>3)? atof(argv[3]) : 0.99;
-    double* pnl = (double*)malloc(N*sizeof(double));
+    double* pnl = (double*)rt_alloc(N*sizeof(double));
     if(!pnl){ fprintf(stderr,"oom\n"); return 1; }
     long long t0 = now_ns();
     uint64_t s=123456789;
@@ -309,14 +460,34 @@ int main(int argc, char** argv){
     long long t1 = now_ns();
     (void)var;
     printf("TASK=var_mc_sort,N=%d,TIME_NS=%lld\n", N, (t1 - t0));
-    free(pnl);
+    rt_free(pnl);
     return 0;
 }
-`
+`, map[string]string{"pnl": "N"})
 }
 
 func cVarMCZig() string {
-	return commonIncludes() + rngHelpers() + `
+	// var_mc_zig_cli.tng: par i = 0..N : sum(pnl_sum) { ... }
+	decl, paths := parFor(parLoop{
+		Name: "paths", Index: "i", From: "0", To: "N", Chunk: 4096,
+		Captures: []string{"int N", "int steps", "double* pnl"},
+		Body: `
+uint64_t s = path_seed(987654321, (uint64_t)i);
+double x=0.0;
+for(int k=0;k<steps;k++) x += znormal(&s);
+pnl[i] = x;
+pnl_sum += x;`,
+		Reduce: "sum", Acc: "pnl_sum", AccType: "double",
+	})
+	return checkSlices(commonIncludes()+`#include "rt_sched.h"   // rt_parallel_for(): link with runtime/rt_sched.c
+`+rngHelpers()+`
+// One stream per path, so the paths do not depend on how the range is split.
+static inline uint64_t path_seed(uint64_t seed, uint64_t i){
+    uint64_t z = seed + (i+1)*0x9E3779B97F4A7C15ULL;
+    z = (z^(z>>30))*0xBF58476D1CE4E5B9ULL; z = (z^(z>>27))*0x94D049BB133111EBULL;
+    z ^= z>>31;
+    return z ? z : 0x9E3779B97F4A7C15ULL;
+}
 static double znormal(uint64_t* s){
     double u,v, ss;
     do {
@@ -326,19 +497,16 @@ static double znormal(uint64_t* s){
     } while(ss<=1e-16 || ss>=1.0);
     return u*sqrt(-2.0*log(ss)/ss);
 }
+`+decl+`
 int main(int argc, char** argv){
     int N    = (argc>1)? atoi(argv[1]) : 1000000;
     int steps= (argc>2)? atoi(argv[2]) : 1;
     double a = (argc>3)? atof(argv[3]) : 0.99;
-    double* pnl = (double*)malloc(N*sizeof(double));
+    double* pnl = (double*)rt_alloc(N*sizeof(double));
     if(!pnl){ fprintf(stderr,"oom\n"); return 1; }
     long long t0 = now_ns();
-    uint64_t s=987654321;
-    for(int i=0;i<N;i++){
-        double x=0.0;
-        for(int k=0;k<steps;k++) x += znormal(&s);
-        pnl[i] = x;
-    }
+    double pnl_sum = 0.0;
+    `+paths+`
     int idx = (int)((1.0-a)*N); if(idx<0) idx=0; if(idx>=N) idx=N-1;
     int l=0, r=N-1;
     while(l<r){
@@ -351,23 +519,23 @@ int main(int argc, char** argv){
         }
         if(idx<=j) r=j; else if(idx>=i) l=i; else break;
     }
-    volatile double var = -pnl[idx];
+    double var = -pnl[idx];
     long long t1 = now_ns();
-    (void)var;
-    printf("TASK=var_mc_zig,N=%d,TIME_NS=%lld\n", N, (t1 - t0));
-    free(pnl);
+    printf("TASK=var_mc_zig,N=%d,TIME_NS=%lld,VAR=%.6f,MEAN=%.6f\n", N, (t1 - t0), var, pnl_sum/N);
+    rt_free(pnl);
     return 0;
 }
-`
+`, map[string]string{"pnl": "N"})
 }
 
+// pnl is a []f64 of length N.
 func cVarMCQSel() string {
-	return commonIncludes() + rngHelpers() + `
+	return checkSlices(commonIncludes()+rngHelpers()+`
 int main(int argc, char** argv){
     int N    = (argc>1)? atoi(argv[1]) : 1000000;
     int steps= (argc>2)? atoi(argv[2]) : 1;
     double a = (argc>3)? atof(argv[3]) : 0.99;
-    double* pnl = (double*)malloc(N*sizeof(double));
+    double* pnl = (double*)rt_alloc(N*sizeof(double));
     if(!pnl){ fprintf(stderr,"oom\n"); return 1; }
     long long t0 = now_ns();
     uint64_t s=1234567;
@@ -397,26 +565,294 @@ int main(int argc, char** argv){
     long long t1 = now_ns();
     (void)var;
     printf("TASK=var_mc_qsel,N=%d,TIME_NS=%lld\n", N, (t1 - t0));
-    free(pnl);
+    rt_free(pnl);
     return 0;
 }
+`, map[string]string{"pnl": "N"})
+}
+
+// ---------- slices ----------
+
+// soaSlice is a `[]T` of a struct with f64 fields, laid out as one array per field
+// (structure of arrays), so a loop over one field reads contiguous doubles. Each array
+// is 64-byte aligned; kernels take them as restrict pointers (distinct slices never
+// alias) and re-assert the alignment with __builtin_assume_aligned.
+type soaSlice struct {
+	Len    string   // C expression for the element count
+	Fields []string // f64 fields, each becomes an array of the same name
+}
+
+// alloc declares and allocates the field arrays and returns 1 on failure.
+func (s soaSlice) alloc() string {
+	var b strings.Builder
+	for _, f := range s.Fields {
+		fmt.Fprintf(&b, "    double* %s = f64_alloc(%s);\n", f, s.Len)
+	}
+	fmt.Fprintf(&b, "    if(!%s){ fprintf(stderr,\"oom\\n\"); return 1; }\n", strings.Join(s.Fields, "||!"))
+	return b.String()
+}
+
+func (s soaSlice) free() string {
+	var b strings.Builder
+	b.WriteString("   ")
+	for _, f := range s.Fields {
+		fmt.Fprintf(&b, " rt_free(%s);", f)
+	}
+	return b.String() + "\n"
+}
+
+// params lists the fields as kernel parameters; ro fields are const.
+func (s soaSlice) params(ro ...string) string {
+	var out []string
+	for _, f := range s.Fields {
+		q := ""
+		for _, r := range ro {
+			if r == f {
+				q = "const "
+			}
+		}
+		out = append(out, q+"double* restrict "+f)
+	}
+	return strings.Join(out, ", ")
+}
+
+func (s soaSlice) args() string { return strings.Join(s.Fields, ", ") }
+
+// addLens enters the field arrays into a checkSlices table.
+func (s soaSlice) addLens(m map[string]string) map[string]string {
+	for _, f := range s.Fields {
+		m[f] = s.Len
+	}
+	return m
+}
+
+// assumeAligned re-asserts the alignment of the field arrays inside a kernel.
+func (s soaSlice) assumeAligned() string {
+	var b strings.Builder
+	for _, f := range s.Fields {
+		fmt.Fprintf(&b, "    %s = __builtin_assume_aligned(%s, F64_ALIGN);\n", f, f)
+	}
+	return b.String()
+}
+
+// f64Helpers: aligned f64 slices. Kernels with sqrt() vectorize only when built with
+// -fno-math-errno (GCC then defines __NO_MATH_ERRNO__); Tenge math never reports errors
+// through errno, so that flag is always safe for emitted code.
+func f64Helpers() string {
+	return `
+#define F64_ALIGN 64
+static inline double* f64_alloc(long n){ return (double*)rt_alloc_aligned((size_t)n*sizeof(double), F64_ALIGN); }
 `
 }
 
-func cNBody() string {
-	return commonIncludes() + `
+// ---------- size specialization ----------
+
+// defines collects `-D name=value` flags.
+type defines map[string]string
+
+func (d defines) String() string {
+	var kv []string
+	for k, v := range d {
+		kv = append(kv, k+"="+v)
+	}
+	sort.Strings(kv)
+	return strings.Join(kv, ",")
+}
+
+func (d defines) Set(s string) error {
+	name, val, ok := strings.Cut(s, "=")
+	if !ok || name == "" || val == "" {
+		return fmt.Errorf("want name=value, got %q", s)
+	}
+	d[name] = val
+	return nil
+}
+
+// Per-core cache sizes the specialized tiles are cut for.
+const (
+	l1Bytes = 32 << 10
+	l2Bytes = 512 << 10
+)
+
+// nbodySpec holds the -D values of an n-body build (zero: not given). With N given, the
+// target gets a second set of kernels with N (and dt, if given) as constants and tiles
+// sized for the caches, used when the run's arguments match; other runs take the
+// generic kernels.
+type nbodySpec struct {
+	N, Steps int
+	Dt       string // as written, a C double literal
+}
+
+func parseNBodySpec(d defines) (nbodySpec, error) {
+	var sp nbodySpec
+	for k, v := range d {
+		switch k {
+		case "N", "steps":
+			n, err := strconv.Atoi(v)
+			if err != nil || n < 1 {
+				return sp, fmt.Errorf("-D %s=%s: want a positive integer", k, v)
+			}
+			if k == "N" {
+				sp.N = n
+			} else {
+				sp.Steps = n
+			}
+		case "dt":
+			if _, err := strconv.ParseFloat(v, 64); err != nil || strings.ContainsAny(v, "xXpP") {
+				return sp, fmt.Errorf("-D dt=%s: want a decimal number", v)
+			}
+			sp.Dt = v
+		default:
+			return sp, fmt.Errorf("-D %s: n-body targets take N, steps and dt", k)
+		}
+	}
+	if sp.N == 0 && len(d) > 0 {
+		return sp, fmt.Errorf("-D: specializing n-body needs N")
+	}
+	return sp, nil
+}
+
+// specFor validates the -D flags for a target.
+func specFor(base string, d defines) (nbodySpec, error) {
+	switch base {
+	case "nbody_cli.tng", "nbody_sym_cli.tng", "nbody_tng.tng", "nbody_tng_sym.tng":
+		return parseNBodySpec(d)
+	}
+	if len(d) > 0 {
+		return nbodySpec{}, fmt.Errorf("-D: %s has no size-specialized variant (n-body targets do)", base)
+	}
+	return nbodySpec{}, nil
+}
+
+// nbodyVariant is one set of n-body kernels: generic (N and dt are arguments) or
+// specialized (given as constants, kernel names end in _spec).
+type nbodyVariant struct {
+	suffix string
+	n      int    // 0: argument
+	dt     string // "": argument
+	itile  int    // bodies i per tile: their positions and accelerations stay in L1
+	jtile  string // bodies j per block: their positions stay in L2 across the i tiles
+}
+
+func genericVariant() nbodyVariant { return nbodyVariant{itile: 256, jtile: "N"} }
+
+func (sp nbodySpec) variant() nbodyVariant {
+	v := nbodyVariant{suffix: "_spec", n: sp.N, dt: sp.Dt, jtile: "N"}
+	v.itile = floorPow2(l1Bytes / 48) // x, y, z, ax, ay, az per i
+	if v.itile > sp.N {
+		v.itile = (sp.N + 3) &^ 3
+	}
+	jt := floorPow2(l2Bytes / 2 / 24) // x, y, z per j, in half of L2
+	if jt < sp.N {
+		v.jtile = strconv.Itoa(jt)
+	}
+	return v
+}
+
+func floorPow2(n int) int {
+	p := 1
+	for p*2 <= n {
+		p *= 2
+	}
+	return p
+}
+
+func (v nbodyVariant) head(name, params string) string {
+	var args []string
+	if v.n == 0 {
+		args = append(args, "int N")
+	}
+	if v.dt == "" {
+		args = append(args, "double dt")
+	}
+	s := fmt.Sprintf("\nstatic void %s%s(%s){\n", name, v.suffix, strings.Join(append(args, params), ", "))
+	if v.n > 0 {
+		s += fmt.Sprintf("    enum { N = %d };\n", v.n)
+	}
+	if v.dt != "" {
+		s += fmt.Sprintf("    const double dt = %s;\n", v.dt)
+	}
+	return s
+}
+
+func (v nbodyVariant) call(name, args string) string {
+	var a []string
+	if v.n == 0 {
+		a = append(a, "N")
+	}
+	if v.dt == "" {
+		a = append(a, "dt")
+	}
+	return fmt.Sprintf("%s%s(%s)", name, v.suffix, strings.Join(append(a, args), ", "))
+}
+
+// N-body bodies: []Body{x, y, z, vx, vy, vz: f64}; kernel scratch: one f64 per body.
+var (
+	nbodyBodies  = soaSlice{Len: "N", Fields: []string{"x", "y", "z", "vx", "vy", "vz"}}
+	nbodyScratch = map[string]soaSlice{
+		"nbody":     {Len: "N", Fields: []string{"ax", "ay", "az"}},
+		"nbody_sym": {Len: "N", Fields: []string{"fx", "fy", "fz"}},
+	}
+)
+
+func nbodyMain(task string, sp nbodySpec, kernels func(v nbodyVariant) string) string {
+	b, scr := nbodyBodies, nbodyScratch[task]
+	defN, defSteps, defDt := "4096", "10", "0.001"
+	if sp.N > 0 {
+		defN = strconv.Itoa(sp.N)
+	}
+	if sp.Steps > 0 {
+		defSteps = strconv.Itoa(sp.Steps)
+	}
+	if sp.Dt != "" {
+		defDt = sp.Dt
+	}
+	loop := func(v nbodyVariant, steps, indent string) string {
+		return indent + "for(int t=0;t<" + steps + ";t++){\n" +
+			indent + "    " + v.call("kick", b.args()+", "+scr.args()) + ";\n" +
+			indent + "    " + v.call("drift", b.args()) + ";\n" +
+			indent + "}\n"
+	}
+	var body string
+	if sp.N > 0 {
+		cond, steps := []string{fmt.Sprintf("N==%d", sp.N)}, "steps"
+		if sp.Steps > 0 {
+			cond, steps = append(cond, fmt.Sprintf("steps==%d", sp.Steps)), strconv.Itoa(sp.Steps)
+		}
+		if sp.Dt != "" {
+			cond = append(cond, "dt=="+sp.Dt)
+		}
+		body = "    if(" + strings.Join(cond, " && ") + "){\n" + loop(sp.variant(), steps, "        ") +
+			"    } else {\n" + loop(genericVariant(), "steps", "        ") + "    }\n"
+	} else {
+		body = loop(genericVariant(), "steps", "    ")
+	}
+	// No FP contraction in any n-body build, -D or not: constant folding in the _spec
+	// kernels would fuse different multiply-adds than in the generic ones, so results
+	// would depend on -D even for runs that fall back to the generic kernels.
+	src := commonIncludes() + f64Helpers() + `#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize ("fp-contract=off")
+#endif
+`
+	src += kernels(genericVariant())
+	if sp.N > 0 {
+		src += "\n// -D N=" + strconv.Itoa(sp.N)
+		if sp.Steps > 0 {
+			src += " -D steps=" + strconv.Itoa(sp.Steps)
+		}
+		if sp.Dt != "" {
+			src += " -D dt=" + sp.Dt
+		}
+		src += kernels(sp.variant())
+	}
+	return src + `
 int main(int argc, char** argv){
-    int N     = (argc>1)? atoi(argv[1]) : 4096;
-    int steps = (argc>2)? atoi(argv[2]) : 10;
-    double dt = (argc>3)? atof(argv[3]) : 0.001;
-    double* x = (double*)malloc(N*sizeof(double));
-    double* y = (double*)malloc(N*sizeof(double));
-    double* z = (double*)malloc(N*sizeof(double));
-    double* vx= (double*)malloc(N*sizeof(double));
-    double* vy= (double*)malloc(N*sizeof(double));
-    double* vz= (double*)malloc(N*sizeof(double));
-    if(!x||!y||!z||!vx||!vy||!vz){ fprintf(stderr,"oom\n"); return 1; }
-    uint64_t s=1;
+    int N     = (argc>1)? atoi(argv[1]) : ` + defN + `;
+    int steps = (argc>2)? atoi(argv[2]) : ` + defSteps + `;
+    double dt = (argc>3)? atof(argv[3]) : ` + defDt + `;
+` + b.alloc() + scr.alloc() + `    uint64_t s=1;
     for(int i=0;i<N;i++){
         s = s*2862933555777941757ULL + 3037000493ULL; x[i]=(double)((s>>20)&1023)/1024.0;
         s = s*2862933555777941757ULL + 3037000493ULL; y[i]=(double)((s>>20)&1023)/1024.0;
@@ -424,66 +860,313 @@ int main(int argc, char** argv){
         vx[i]=vy[i]=vz[i]=0.0;
     }
     long long t0 = now_ns();
-    for(int t=0;t<steps;t++){
-        for(int i=0;i<N;i++){
-            double ax=0, ay=0, az=0;
-            double xi=x[i], yi=y[i], zi=z[i];
-            for(int j=0;j<N;j++){
-                double dx=x[j]-xi, dy=y[j]-yi, dz=z[j]-zi;
-                double r2=dx*dx+dy*dy+dz*dz+1e-9, inv=1.0/(r2*sqrt(r2));
-                ax+=dx*inv; ay+=dy*inv; az+=dz*inv;
+` + body + `    long long t1 = now_ns();
+    double checksum = 0.0;
+    for(int i=0;i<N;i++) checksum += x[i] + y[i] + z[i];
+    printf("TASK=` + task + `,N=%d,TIME_NS=%lld,CHECKSUM=%.17g\n", N, (t1 - t0), checksum);
+` + b.free() + scr.free() + `    return 0;
+}
+`
+}
+
+func nbodyDrift(v nbodyVariant) string {
+	b := nbodyBodies
+	return v.head("drift", b.params()) + b.assumeAligned() +
+		`    for(int i=0;i<N;i++){ x[i]+=vx[i]*dt; y[i]+=vy[i]*dt; z[i]+=vz[i]*dt; }
+}
+`
+}
+
+func cNBody(sp nbodySpec) string {
+	b, a := nbodyBodies, nbodyScratch["nbody"]
+	// Bodies j come in blocks and bodies i in tiles; for each j the tile's accelerations
+	// are updated in a loop over i, which vectorizes. Every ax[i] still sums over j in
+	// ascending order, so the results are those of the plain i-then-j loop.
+	kick := func(v nbodyVariant) string {
+		return v.head("kick", b.params("x", "y", "z")+", "+a.params()) + b.assumeAligned() + a.assumeAligned() +
+			fmt.Sprintf(`    for(int i=0;i<N;i++){ ax[i]=0; ay[i]=0; az[i]=0; }
+    for(int j0=0;j0<N;j0+=%[2]s){
+        int jn = N-j0 < %[2]s ? N : j0+%[2]s;
+        for(int i0=0;i0<N;i0+=%[1]d){
+            int in = N-i0 < %[1]d ? N : i0+%[1]d;
+            for(int j=j0;j<jn;j++){
+                double xj=x[j], yj=y[j], zj=z[j];
+                for(int i=i0;i<in;i++){
+                    double dx=xj-x[i], dy=yj-y[i], dz=zj-z[i];
+                    double r2=dx*dx+dy*dy+dz*dz+1e-9, inv=1.0/(r2*sqrt(r2));
+                    ax[i]+=dx*inv; ay[i]+=dy*inv; az[i]+=dz*inv;
+                }
             }
-            vx[i]+=ax*dt; vy[i]+=ay*dt; vz[i]+=az*dt;
         }
-        for(int i=0;i<N;i++){ x[i]+=vx[i]*dt; y[i]+=vy[i]*dt; z[i]+=vz[i]*dt; }
     }
+    for(int i=0;i<N;i++){ vx[i]+=ax[i]*dt; vy[i]+=ay[i]*dt; vz[i]+=az[i]*dt; }
+}
+`, v.itile, v.jtile) + nbodyDrift(v)
+	}
+	return checkSlices(nbodyMain("nbody", sp, kick), a.addLens(b.addLens(map[string]string{})))
+}
+
+func cNBodySym(sp nbodySpec) string {
+	b, f := nbodyBodies, nbodyScratch["nbody_sym"]
+	// With vector math the j loop stores each pair force in f[xyz][j] and applies the
+	// reaction to body j, which vectorizes; body i's sums are then taken over f in
+	// ascending j. Without it the fused scalar loop is faster. Both sum in the same order.
+	kick := func(v nbodyVariant) string {
+		return v.head("kick", b.params()+", "+f.params()) + b.assumeAligned() + f.assumeAligned() +
+			`    for(int i=0;i<N;i++){
+        double xi=x[i], yi=y[i], zi=z[i];
+        double ax=0, ay=0, az=0;
+#ifdef __NO_MATH_ERRNO__
+        for(int j=i+1;j<N;j++){
+            double dx=x[j]-xi, dy=y[j]-yi, dz=z[j]-zi;
+            double r2=dx*dx+dy*dy+dz*dz+1e-9, inv=1.0/(r2*sqrt(r2));
+            fx[j]=dx*inv; fy[j]=dy*inv; fz[j]=dz*inv;
+            vx[j]-=fx[j]*dt; vy[j]-=fy[j]*dt; vz[j]-=fz[j]*dt;
+        }
+        for(int j=i+1;j<N;j++){ ax+=fx[j]; ay+=fy[j]; az+=fz[j]; }
+#else
+        for(int j=i+1;j<N;j++){
+            double dx=x[j]-xi, dy=y[j]-yi, dz=z[j]-zi;
+            double r2=dx*dx+dy*dy+dz*dz+1e-9, inv=1.0/(r2*sqrt(r2));
+            double f0=dx*inv, f1=dy*inv, f2=dz*inv;
+            ax+=f0; ay+=f1; az+=f2;
+            vx[j]-=f0*dt; vy[j]-=f1*dt; vz[j]-=f2*dt;
+        }
+#endif
+        vx[i]+=ax*dt; vy[i]+=ay*dt; vz[i]+=az*dt;
+    }
+}
+` + nbodyDrift(v)
+	}
+	return checkSlices(nbodyMain("nbody_sym", sp, kick), f.addLens(b.addLens(map[string]string{})))
+}
+
+// re and im are []f64 of length n.
+func cFFT() string {
+	return checkSlices(commonIncludes()+`#include "rt_fft.h"     // rt_fft_forward()
+
+int main(int argc, char** argv){
+    int n = (argc>1)? atoi(argv[1]) : 1048576;
+    if(n<2 || (n&(n-1))!=0 || n > (1<<RT_FFT_MAX_LOG2)){
+        fprintf(stderr,"fft: N must be a power of two in [2, 2^%d]\n", RT_FFT_MAX_LOG2); return 1;
+    }
+    double* re = (double*)rt_alloc_aligned((size_t)n*sizeof(double),64);
+    double* im = (double*)rt_alloc_aligned((size_t)n*sizeof(double),64);
+    if(!re || !im){ fprintf(stderr,"oom\n"); return 1; }
+    for(int i=0;i<n;i++){
+        double t = i*2.0*M_PI/n;
+        re[i] = sin(t) + 0.5*sin(3*t) + 0.25*sin(5*t);
+        im[i] = 0.0;
+    }
+    if(rt_fft_prepare((size_t)n)){ fprintf(stderr,"oom\n"); return 1; }
+    long long t0 = now_ns();
+    rt_fft_forward(re, im, (size_t)n);
+    double power_sum = 0.0;
+    for(int i=0;i<n;i++) power_sum += re[i]*re[i] + im[i]*im[i];
+    long long t1 = now_ns();
+    printf("TASK=fft,N=%d,TIME_NS=%lld,POWER_SUM=%.6f\n", n, (t1 - t0), power_sum);
+    rt_free(re); rt_free(im);
+    rt_fft_release();
+    return 0;
+}
+`, map[string]string{"re": "n", "im": "n"})
+}
+
+// The matrices are rt_mat and go through RT_MAT_AT (rt_matrix.h); there is no []T
+// for the slice pass to check.
+func cMatrixOps() string {
+	return commonIncludes() + `#include "rt_matrix.h"  // rt_mat, rt_gemm()
+
+int main(int argc, char** argv){
+    int n       = (argc>1)? atoi(argv[1]) : 200;
+    int threads = (argc>2)? atoi(argv[2]) : 0;
+    if(n<=0){ fprintf(stderr,"matrix_ops: N must be positive\n"); return 1; }
+    rt_mat a, b, c;
+    if(rt_mat_alloc(&a,n,n) || rt_mat_alloc(&b,n,n) || rt_mat_alloc(&c,n,n)){ fprintf(stderr,"oom\n"); return 1; }
+    for(int i=0;i<n;i++){
+        for(int j=0;j<n;j++){
+            RT_MAT_AT(&a,i,j) = (i + j) * 0.01;
+            RT_MAT_AT(&b,i,j) = (i - j) * 0.01;
+        }
+    }
+    long long t0 = now_ns();
+    if(rt_gemm(&a, &b, &c, 1.0, 0.0, threads)){ fprintf(stderr,"rt_gemm failed\n"); return 1; }
+    double trace = 0.0;
+    for(int i=0;i<n;i++) trace += RT_MAT_AT(&c,i,i);
     long long t1 = now_ns();
-    printf("TASK=nbody,N=%d,TIME_NS=%lld\n", N, (t1 - t0));
-    free(x);free(y);free(z);free(vx);free(vy);free(vz);
+    double gflops = 2.0 * (double)n * (double)n * (double)n / (double)(t1 - t0);
+    // trace(A*B) is 0 for these inputs at every N; the sum of C is n^3 (n^2 - 1) / 12 * 1e-4.
+    double sum = 0.0, nn = (double)n;
+    for(int i=0;i<n;i++) for(int j=0;j<n;j++) sum += RT_MAT_AT(&c,i,j);
+    double want = nn * nn * nn * (nn * nn - 1.0) / 12.0 * 1e-4;
+    printf("TASK=matrix_ops,N=%d,TIME_NS=%lld,GFLOPS=%.3f,TRACE=%.6f,SUM=%.6f\n", n, (t1 - t0), gflops, trace, sum);
+    rt_mat_free(&a); rt_mat_free(&b); rt_mat_free(&c);
+    if(fabs(sum - want) > 1e-9 * want){ fprintf(stderr,"matrix_ops: SUM=%.6f, expected %.6f\n", sum, want); return 2; }
     return 0;
 }
 `
 }
 
-func cNBodySym() string {
-	return commonIncludes() + `
+// mu, w, lo and hi are []f64 of length n. The matrices are rt_mat and go through
+// RT_MAT_AT (rt_matrix.h), which the slice pass does not check.
+func cPortfolioOpt() string {
+	return checkSlices(commonIncludes()+`#include <string.h>
+#include "rt_portfolio.h" // rt_portfolio_min_variance(), rt_portfolio_max_sharpe()
+`+rngHelpers()+`
+// Usage: portfolio_opt [n_assets=100] [minvar|sharpe] [max_weight=0.05, 0 = no box] [threads=0]
+// Covariance is a 10-factor model S = B B^T + D (positive definite), mu ~ U[2%, 10%].
 int main(int argc, char** argv){
-    int N     = (argc>1)? atoi(argv[1]) : 4096;
-    int steps = (argc>2)? atoi(argv[2]) : 10;
-    double dt = (argc>3)? atof(argv[3]) : 0.001;
-    double* x = (double*)malloc(N*sizeof(double));
-    double* y = (double*)malloc(N*sizeof(double));
-    double* z = (double*)malloc(N*sizeof(double));
-    double* vx= (double*)malloc(N*sizeof(double));
-    double* vy= (double*)malloc(N*sizeof(double));
-    double* vz= (double*)malloc(N*sizeof(double));
-    if(!x||!y||!z||!vx||!vy||!vz){ fprintf(stderr,"oom\n"); return 1; }
-    uint64_t s=1;
-    for(int i=0;i<N;i++){
-        s = s*2862933555777941757ULL + 3037000493ULL; x[i]=(double)((s>>20)&1023)/1024.0;
-        s = s*2862933555777941757ULL + 3037000493ULL; y[i]=(double)((s>>20)&1023)/1024.0;
-        s = s*2862933555777941757ULL + 3037000493ULL; z[i]=(double)((s>>20)&1023)/1024.0;
-        vx[i]=vy[i]=vz[i]=0.0;
+    int n          = (argc>1)? atoi(argv[1]) : 100;
+    int sharpe     = (argc>2) && strcmp(argv[2],"sharpe")==0;
+    double cap     = (argc>3)? atof(argv[3]) : 0.05;
+    int threads    = (argc>4)? atoi(argv[4]) : 0;
+    const int k    = 10;
+    const double rf = 0.01;
+    if(n<=0){ fprintf(stderr,"portfolio_opt: n_assets must be positive\n"); return 1; }
+
+    rt_mat B, Bt, S;
+    double* mu = (double*)rt_alloc((size_t)n*sizeof(double));
+    double* w  = (double*)rt_alloc((size_t)n*sizeof(double));
+    double* lo = (double*)rt_alloc((size_t)n*sizeof(double));
+    double* hi = (double*)rt_alloc((size_t)n*sizeof(double));
+    if(!mu||!w||!lo||!hi|| rt_mat_alloc(&B,n,k) || rt_mat_alloc(&Bt,k,n) || rt_mat_alloc(&S,n,n)){
+        fprintf(stderr,"oom\n"); return 1;
+    }
+    uint64_t s=20250923;
+    for(int i=0;i<n;i++){
+        for(int f=0;f<k;f++){
+            double b = (f==0)? 0.8+0.4*u01(&s) : 0.3*(u01(&s)-0.5);
+            RT_MAT_AT(&B,i,f) = 0.15*b; RT_MAT_AT(&Bt,f,i) = 0.15*b;
+        }
+        mu[i] = 0.02 + 0.08*u01(&s);
+        lo[i] = 0.0; hi[i] = cap;
     }
+    rt_gemm(&B, &Bt, &S, 1.0, 0.0, threads);
+    for(int i=0;i<n;i++){ double d = 0.1 + 0.2*u01(&s); RT_MAT_AT(&S,i,i) += d*d; }
+
+    rt_portfolio_opts o = { NULL, NULL, 0, 0.0, threads };
+    if(cap > 0.0){ o.lo = lo; o.hi = hi; }
+    rt_portfolio_result r;
     long long t0 = now_ns();
-    for(int t=0;t<steps;t++){
-        for(int i=0;i<N;i++){
-            double ax=0, ay=0, az=0;
-            for(int j=i+1;j<N;j++){
-                double dx=x[j]-x[i], dy=y[j]-y[i], dz=z[j]-z[i];
-                double r2=dx*dx+dy*dy+dz*dz+1e-9, inv=1.0/(r2*sqrt(r2));
-                double fx=dx*inv, fy=dy*inv, fz=dz*inv;
-                ax+=fx; ay+=fy; az+=fz;
-                vx[j]-=fx*dt; vy[j]-=fy*dt; vz[j]-=fz*dt;
-            }
-            vx[i]+=ax*dt; vy[i]+=ay*dt; vz[i]+=az*dt;
+    int rc = sharpe ? rt_portfolio_max_sharpe(&S, mu, rf, &o, w, &r)
+                    : rt_portfolio_min_variance(&S, mu, &o, w, &r);
+    long long t1 = now_ns();
+    if(rc){ fprintf(stderr,"portfolio_opt: solver failed (rc=%d)\n", rc); return 1; }
+    printf("TASK=%s,N=%d,TIME_NS=%lld,PORTFOLIO_VAR=%.8f,SHARPE=%.6f,ITERS=%d\n",
+           sharpe? "portfolio_sharpe" : "portfolio_minvar", n, (t1 - t0), r.risk*r.risk, r.sharpe, r.iters);
+    rt_mat_free(&B); rt_mat_free(&Bt); rt_mat_free(&S);
+    rt_free(mu); rt_free(w); rt_free(lo); rt_free(hi);
+    return 0;
+}
+`, map[string]string{"mu": "n", "w": "n", "lo": "n", "hi": "n"})
+}
+
+// r is a []f64 of ns*T returns; persist and fit hold one entry per series.
+func cGarchFit() string {
+	return checkSlices(commonIncludes()+`#include "rt_garch.h"   // rt_garch_fit_batch()
+`+rngHelpers()+`
+// Usage: garch_fit [n_series=1000] [n_obs=2500] [threads=0]
+// Each series is simulated from its own GARCH(1,1) (alpha in [0.03, 0.12], beta in [0.80, 0.97 - alpha],
+// daily vol 1%..3%) after a 500-step burn-in, stored time-major: r[t*n_series + s].
+int main(int argc, char** argv){
+    long ns     = (argc>1)? atol(argv[1]) : 1000;
+    long T      = (argc>2)? atol(argv[2]) : 2500;
+    int threads = (argc>3)? atoi(argv[3]) : 0;
+    if(ns<=0 || T<2){ fprintf(stderr,"garch_fit: need n_series > 0 and n_obs >= 2\n"); return 1; }
+
+    double* r = (double*)rt_alloc_aligned((size_t)ns*(size_t)T*sizeof(double),64);
+    if(!r){ fprintf(stderr,"oom\n"); return 1; }
+    double* persist = (double*)rt_alloc((size_t)ns*sizeof(double));
+    rt_garch_fit* fit = (rt_garch_fit*)rt_alloc((size_t)ns*sizeof(rt_garch_fit));
+    if(!persist || !fit){ fprintf(stderr,"oom\n"); return 1; }
+    uint64_t s=20250929;
+    for(long i=0;i<ns;i++){
+        double a = 0.03 + 0.09*u01(&s), b = 0.80 + (0.17 - a)*u01(&s);
+        double vol = 0.01 + 0.02*u01(&s);
+        double w = vol*vol*(1.0 - a - b), h = vol*vol, x = 0.0;
+        persist[i] = a + b;
+        for(long t=-500;t<T;t++){
+            h = w + a*x*x + b*h;
+            double u1 = u01(&s), u2 = u01(&s);
+            x = sqrt(h) * sqrt(-2.0*log(u1 + 1e-300)) * cos(2.0*M_PI*u2);
+            if(t>=0) r[(size_t)t*(size_t)ns + (size_t)i] = x;
         }
-        for(int i=0;i<N;i++){ x[i]+=vx[i]*dt; y[i]+=vy[i]*dt; z[i]+=vz[i]*dt; }
     }
+
+    rt_garch_opts o = { 0, 0.0, threads };
+    long long t0 = now_ns();
+    int rc = rt_garch_fit_batch(r, (size_t)ns, (size_t)T, &o, fit);
     long long t1 = now_ns();
-    printf("TASK=nbody_sym,N=%d,TIME_NS=%lld\n", N, (t1 - t0));
-    free(x);free(y);free(z);free(vx);free(vy);free(vz);
+    if(rc){ fprintf(stderr,"garch_fit: rt_garch_fit_batch failed (rc=%d)\n", rc); return 1; }
+
+    long conv = 0; double iters = 0.0, pmean = 0.0, perr = 0.0;
+    for(long i=0;i<ns;i++){
+        conv  += fit[i].status == RT_GARCH_CONVERGED;
+        iters += fit[i].iters;
+        pmean += fit[i].alpha + fit[i].beta;
+        perr  += fabs(fit[i].alpha + fit[i].beta - persist[i]);
+    }
+    printf("TASK=garch_fit,N=%ld,T=%ld,TIME_NS=%lld,SERIES_PER_SEC=%.1f,CONVERGED=%ld,MEAN_ITERS=%.2f,MEAN_PERSIST=%.6f,PERSIST_MAE=%.6f\n",
+           ns, T, (t1 - t0), (double)ns*1e9/(double)(t1 - t0), conv, iters/ns, pmean/ns, perr/ns);
+    rt_free(r); rt_free(persist); rt_free(fit);
     return 0;
 }
-`
-}
\ No newline at end of file
+`, map[string]string{"r": "(size_t)ns*(size_t)T", "persist": "ns", "fit": "ns"})
+}
+
+// y is a []f64 of nc*nm quotes and fit holds one entry per curve; mat is a fixed C array
+// sized by its initializer, so it is left unchecked.
+func cYieldCurveFit() string {
+	return checkSlices(commonIncludes()+`#include "rt_nss.h"     // rt_nss_fit_batch()
+`+rngHelpers()+`
+static double gauss(uint64_t* s){
+    double u1 = u01(s), u2 = u01(s);
+    return sqrt(-2.0*log(u1 + 1e-300)) * cos(2.0*M_PI*u2);
+}
+
+// Usage: yield_curve [n_curves=5040 (20y of business days)] [threads=0]
+// Daily NSS curves follow a slow random walk; quotes on 16 tenors carry 1bp noise
+// and about 2% of them are missing (NaN). Quotes are maturity-major: y[k*n_curves + c].
+int main(int argc, char** argv){
+    long nc     = (argc>1)? atol(argv[1]) : 5040;
+    int threads = (argc>2)? atoi(argv[2]) : 0;
+    static const double mat[] = { 1.0/12, 0.25, 0.5, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 15, 20, 30 };
+    const int nm = (int)(sizeof(mat)/sizeof(mat[0]));
+    if(nc<=0){ fprintf(stderr,"yield_curve: n_curves must be positive\n"); return 1; }
+
+    double* y = (double*)rt_alloc((size_t)nc*nm*sizeof(double));
+    rt_nss_fit* fit = (rt_nss_fit*)rt_alloc((size_t)nc*sizeof(rt_nss_fit));
+    if(!y || !fit){ fprintf(stderr,"oom\n"); return 1; }
+    uint64_t s=20250930;
+    double b0=0.045, b1=-0.02, b2=0.01, b3=0.005, t1=1.5, t2=8.0;
+    for(long c=0;c<nc;c++){
+        b0 += 0.0004*gauss(&s); b1 += 0.0005*gauss(&s); b2 += 0.0008*gauss(&s); b3 += 0.0008*gauss(&s);
+        t1 = fmin(4.0, fmax(0.5, t1*exp(0.02*gauss(&s))));
+        t2 = fmin(25.0, fmax(5.0, t2*exp(0.02*gauss(&s))));
+        for(int k=0;k<nm;k++){
+            double x1 = mat[k]/t1, x2 = mat[k]/t2, e1 = exp(-x1), e2 = exp(-x2);
+            double l1 = (1-e1)/x1, l2 = (1-e2)/x2;
+            double v = b0 + b1*l1 + b2*(l1-e1) + b3*(l2-e2) + 0.0001*gauss(&s);
+            y[(size_t)k*nc + c] = (u01(&s) < 0.02)? NAN : v;
+        }
+    }
+
+    rt_nss_opts o = { 0, 0.0, threads };
+    long long t0 = now_ns();
+    int rc = rt_nss_fit_batch(mat, (size_t)nm, y, (size_t)nc, &o, fit);
+    long long t1ns = now_ns();
+    if(rc){ fprintf(stderr,"yield_curve: rt_nss_fit_batch failed (rc=%d)\n", rc); return 1; }
+
+    long conv = 0; double iters = 0.0, rmse = 0.0;
+    for(long c=0;c<nc;c++){
+        conv  += fit[c].status == RT_NSS_CONVERGED;
+        iters += fit[c].iters;
+        rmse  += fit[c].rmse;
+    }
+    printf("TASK=yield_curve_fit,N=%ld,TIME_NS=%lld,CURVES_PER_SEC=%.1f,CONVERGED=%ld,MEAN_ITERS=%.2f,RMSE_BP=%.4f\n",
+           nc, (t1ns - t0), (double)nc*1e9/(double)(t1ns - t0), conv, iters/nc, 1e4*rmse/nc);
+    rt_free(y); rt_free(fit);
+    return 0;
+}
+`, map[string]string{"y": "(size_t)nc*nm", "fit": "nc"})
+}
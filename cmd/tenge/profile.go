@@ -0,0 +1,184 @@
+// cmd/tenge/profile.go
+package main
+
+// Profiling instrumentation for emitted C (`tenge build --profile`).
+//
+// profileC opens an RT_PROF_REGION (runtime/rt_prof.h) at the top of every function
+// body and around every for, while and do loop, and appends the table of region names.
+// A region closes with its C scope, so returns, breaks and gotos need no rewriting: a
+// loop `for(...) body` becomes `{ RT_PROF_REGION(k); for(...) body }`. static inline
+// helpers get no regions; their time counts towards their callers. Region names are
+// `function` and `function:for@L<line>`, the line being the loop's in the instrumented
+// file.
+
+import (
+	"fmt"
+	"regexp"
+	"sort"
+	"strings"
+)
+
+type profSite struct {
+	name, kind string
+	at         int // source offset of the function name or loop keyword
+}
+
+type insertion struct {
+	at   int
+	text string
+}
+
+type profPass struct {
+	src   string
+	ins   []insertion
+	sites []profSite
+}
+
+var (
+	funcHead = regexp.MustCompile(`([A-Za-z_]\w*)\s*\((?:[^;{}()]|\([^;{}()]*\))*\)\s*$`)
+	inlineKw = regexp.MustCompile(`\binline\b`)
+)
+
+func profileC(src string) string {
+	p := &profPass{src: src}
+	p.insert(0, "#include \"rt_prof.h\"   // RT_PROF_REGION(): --profile, link with runtime/rt_prof.c\n")
+	p.functions()
+
+	sort.SliceStable(p.ins, func(i, j int) bool { return p.ins[i].at < p.ins[j].at })
+	var out strings.Builder
+	last := 0
+	for _, in := range p.ins {
+		out.WriteString(src[last:in.at])
+		out.WriteString(in.text)
+		last = in.at
+	}
+	out.WriteString(src[last:])
+	code := out.String()
+
+	code += "\n// --profile: region names, by RT_PROF_REGION index\nstatic const rt_prof_site rt_prof_sites_[] = {\n"
+	for _, s := range p.sites {
+		name := s.name
+		if s.kind != "func" {
+			name += fmt.Sprintf("@L%d", 1+strings.Count(code[:p.moved(s.at)], "\n"))
+		}
+		code += fmt.Sprintf("    {%q, %q},\n", name, s.kind)
+	}
+	code += "};\n__attribute__((constructor)) static void rt_prof_init_(void){\n" +
+		"    rt_prof_register(rt_prof_sites_, (int)(sizeof rt_prof_sites_ / sizeof rt_prof_sites_[0]));\n}\n"
+	return code
+}
+
+func (p *profPass) insert(at int, text string) { p.ins = append(p.ins, insertion{at, text}) }
+
+// moved returns where source offset at ends up once the insertions are applied.
+func (p *profPass) moved(at int) int {
+	d := 0
+	for _, in := range p.ins {
+		if in.at <= at {
+			d += len(in.text)
+		}
+	}
+	return at + d
+}
+
+func (p *profPass) site(name, kind string, at int) int {
+	p.sites = append(p.sites, profSite{name, kind, at})
+	return len(p.sites) - 1
+}
+
+// skipDirective returns the index after the preprocessor line at s[i] when s[i] starts
+// one (a '#' first on its line), else i.
+func skipDirective(s string, i int) int {
+	if s[i] != '#' || strings.TrimLeft(s[strings.LastIndexByte(s[:i], '\n')+1:i], " \t") != "" {
+		return i
+	}
+	for j := i; j < len(s); j++ {
+		if s[j] == '\n' && s[j-1] != '\\' {
+			return j
+		}
+	}
+	return len(s)
+}
+
+// functions instruments the bodies of the file-scope function definitions.
+func (p *profPass) functions() {
+	s := p.src
+	head := 0
+	for i := 0; i < len(s); {
+		if k := skipQuoted(s, i); k != i {
+			i = k
+			continue
+		}
+		if k := skipDirective(s, i); k != i {
+			i, head = k, k
+			continue
+		}
+		switch s[i] {
+		case ';':
+			head = i + 1
+		case '{':
+			e := match(s, i)
+			h := s[head:i]
+			if m := funcHead.FindStringSubmatchIndex(h); m != nil && !inlineKw.MatchString(h) {
+				name := h[m[2]:m[3]]
+				k := p.site(name, "func", head+m[2])
+				p.insert(i+1, fmt.Sprintf(" RT_PROF_REGION(%d);", k))
+				p.loops(name, i+1, e-1)
+			}
+			i, head = e, e
+			continue
+		}
+		i++
+	}
+}
+
+// loops wraps every loop in s[lo:hi] in a region, the loops nested in it included.
+func (p *profPass) loops(fn string, lo, hi int) {
+	s := p.src
+	for i := lo; i < hi; {
+		if k := skipQuoted(s, i); k != i {
+			i = k
+			continue
+		}
+		if k := skipDirective(s, i); k != i {
+			i = k
+			continue
+		}
+		if !isIdent(s[i]) {
+			i++
+			continue
+		}
+		j := i
+		for j < hi && isIdent(s[j]) {
+			j++
+		}
+		if i > lo && isIdent(s[i-1]) {
+			i = j
+			continue
+		}
+		w, next := s[i:j], skipSpace(s, j)
+		var bodyLo, bodyHi, end int
+		switch {
+		case (w == "for" || w == "while") && next < hi && s[next] == '(':
+			bodyLo = match(s, next)
+			end = statement(s, bodyLo)
+			bodyHi = end
+		case w == "do":
+			bodyLo, bodyHi = j, statement(s, j)
+			t := skipSpace(s, bodyHi)
+			if !strings.HasPrefix(s[t:], "while") {
+				i = j
+				continue
+			}
+			end = skipSpace(s, match(s, skipSpace(s, t+len("while")))) + 1 // past the ';'
+		default:
+			i = j
+			continue
+		}
+		k := p.site(fmt.Sprintf("%s:%s", fn, w), "loop", i)
+		p.insert(i, fmt.Sprintf("{ RT_PROF_REGION(%d); ", k))
+		p.loops(fn, bodyLo, bodyHi)
+		p.insert(end, " }")
+		i = end
+	}
+}
@@ -1,14 +1,78 @@
+// Event-driven CRUD server: one edge-triggered epoll loop per core. Every worker owns
+// a SO_REUSEPORT listener on :8080, so the kernel spreads new connections across loops
+// and no accept lock is shared. Sockets are non-blocking; each connection is a small
+// state machine that survives partial reads and writes.
+// HTTP/1.1 connections stay open (keep-alive) until the client asks to close or is idle
+// for IDLE_MS. Pipelined requests are answered in order: each gets a slot in the
+// connection's response ring and the ring is flushed with one sendmsg.
+// The database runs in WAL mode behind an rt_db_pool: each loop holds one read-only
+// connection for /list and /get, so reads proceed while another loop writes; writes go
+// through a writer thread that owns the pool's writer connection. Every statement is
+// prepared once (rt_stmt_cache); handlers only bind, step and reset.
+// Group commit: loops push /add, /done, /rm and /purge onto a lock-free MPSC queue and
+// leave the request's response slot pending. The writer thread applies every queued
+// write in one transaction (up to COMMIT_MAX, optionally lingering COMMIT_US for more),
+// commits, and hands each result back to its loop (MPSC queue + eventfd); only then is
+// the response sent. Writes arriving during a commit form the next batch.
+// /list streams: rows are serialized with rt_json straight into the response slot, one
+// CHUNK at a time (HTTP/1.1 chunked encoding), and the next chunk is produced only once
+// the previous one has left, so memory stays constant however long the list is.
+// /list?after=<id>&limit=<n> returns one keyset page (primary-key seek, cost independent
+// of table size). Each loop caches recent pages; an entry is valid while data_gen, which
+// the writer thread bumps after every commit, still matches the value read before the
+// page was queried.
+// Requests are framed by rt_http: a zero-copy parser that resumes its end-of-head scan
+// where the previous read left off and hands back slices into the connection buffer.
+// Parameters come from the query string or, for POST, a form-urlencoded body.
+// Fixed replies (errors, {"status":"ok"}) are prebuilt at startup for both connection
+// modes, so a response costs a memcpy into its slot and the slot ring goes out with one
+// sendmsg(MSG_NOSIGNAL). /export serves the whole table through sendfile from a file
+// that an export thread rebuilds, off the event loops, only after commits. /metrics reports the server's syscalls per request.
+// Per-request state (a queued write and its strings) is bump-allocated from an rt_arena
+// owned by the response slot and released when the slot is reused, so steady-state
+// requests make no malloc calls.
+#define _GNU_SOURCE
 #include <arpa/inet.h>
-#include <ctype.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <netinet/in.h>
-#include <sqlite3.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <signal.h>
+#include "rt_arena.h"
+#include "rt_http.h"
+#include "rt_json.h"
+#include "rt_sqlite.h"
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <poll.h>
+#include <stdatomic.h>
+#include <sys/epoll.h>
+#include <sys/sendfile.h>
+#include <sys/eventfd.h>
 #include <sys/socket.h>
+#include <time.h>
 #include <unistd.h>
 
+#define PORT        8080
+#define MAX_EVENTS  256
+#define REQ_MAX     8192   // request line + headers (+ body) of the requests being read
+#define PIPE_MAX    32     // responses queued per connection before reading pauses
+#define IDLE_MS     5000   // keep-alive connections idle this long are closed
+#define STEP_ROUNDS 16     // read/serve/write rounds a connection gets per loop turn
+#define BUSY_MS     5000   // a checkpoint or external writer is waited for instead of failing
+#define MMAP_BYTES  (256LL << 20)
+#define CACHE_KIB   16384
+#define CHUNK       16384  // /list body bytes produced per chunk
+#define PAGE_DEFAULT 100   // /list page size when only `after` is given
+#define PAGE_MAX    1000
+#define PAGE_CACHE  64     // cached pages per loop (direct-mapped, power of two)
+#define COMMIT_MAX  128    // writes per transaction (env COMMIT_MAX; 1 = commit per request)
+#define COMMIT_US   0      // how long a batch waits for more writes once the queue is empty
+                           // (env COMMIT_US; 0: commit as soon as the queue drains)
+
 static const char *DB_PATH = "todos.db";
 static const char *DDL =
     "CREATE TABLE IF NOT EXISTS todos ("
@@ -19,209 +83,1039 @@ static const char *DDL =
     "  created_at TEXT NOT NULL DEFAULT (datetime('now'))"
     ");";
 
+// Read statements, prepared on every loop's reader connection.
+enum { RD_LIST, RD_PAGE, RD_GET, RD_COUNT };
+static const char *const READ_SQL[RD_COUNT] = {
+    // Resumed per chunk after the last id sent, so no read transaction spans chunks.
+    [RD_LIST] = "SELECT id,title,priority,done,created_at FROM todos WHERE id>? ORDER BY id ASC;",
+    [RD_PAGE] = "SELECT id,title,priority,done,created_at FROM todos WHERE id>? ORDER BY id ASC LIMIT ?;",
+    [RD_GET]  = "SELECT id,title,priority,done,created_at FROM todos WHERE id=?;",
+};
+
+// Write statements, prepared once on the pool's writer connection.
+enum { WR_ADD, WR_DONE, WR_RM, WR_PURGE, WR_PURGE_SEQ, WR_COUNT };
+static const char *const WRITE_SQL[WR_COUNT] = {
+    [WR_ADD]       = "INSERT INTO todos(title,priority) VALUES(?,?);",
+    [WR_DONE]      = "UPDATE todos SET done=1 WHERE id=?;",
+    [WR_RM]        = "DELETE FROM todos WHERE id=?;",
+    [WR_PURGE]     = "DELETE FROM todos;",
+    [WR_PURGE_SEQ] = "DELETE FROM sqlite_sequence WHERE name='todos';",
+};
+
+static rt_db_pool    POOL;
+static rt_stmt_cache WRITE_SC;   // on POOL.writer; only used by the writer thread
+static atomic_ullong data_gen;   // bumped after every commit; page cache validity
+static int           commit_max = COMMIT_MAX;
+static long long     commit_us = COMMIT_US;
+
+// Intrusive multi-producer / single-consumer queue (Vyukov): push is one atomic
+// exchange, pop never blocks. pop can return NULL while a push is half done; the
+// pusher then always issues a wakeup, so the consumer retries.
+typedef struct mpsc_node { _Atomic(struct mpsc_node *) next; } mpsc_node;
+typedef struct {
+    _Atomic(mpsc_node *) head;   // producers
+    mpsc_node           *tail;   // consumer
+    mpsc_node            stub;
+} mpsc;
+
+typedef rt_jbuf obuf;
+
+typedef struct {
+    obuf     b;
+    rt_arena a;            // request-scoped allocations; rewound with the slot
+    int  keep;             // 0: close the connection once this response is written
+    int  http11;
+    int  pending;          // filled in when its write commits; flushing stops here
+    struct {
+        int       on;      // b holds one chunk of a /list body; refill once it is sent
+        int       chunked; // else HTTP/1.0: body runs until the connection closes
+        long long after;   // last id serialized
+        long long rows;    // -1 before the opening '['
+    } ls;
+    struct {
+        int   on;          // once b is out, send bytes [off, len) of fd (sendfile)
+        int   fd;          // owned by the slot
+        off_t off, len;
+    } f;
+} resp;
+
+// Syscalls issued by the server itself (SQLite's file I/O is not included).
+enum { SC_ACCEPT, SC_READ, SC_SEND, SC_SENDFILE, SC_EPOLL_WAIT, SC_EPOLL_CTL, SC_SETSOCKOPT,
+       SC_CLOSE, SC_EVENTFD, SC_POLL, SC_FILE, SC_COUNT };
+static const char *const SC_NAME[SC_COUNT] = {
+    "accept", "read", "send", "sendfile", "epoll_wait", "epoll_ctl", "setsockopt",
+    "close", "eventfd", "poll", "file",
+};
+
+// Per-thread counters: one writer each, so increments are a relaxed load and store
+// (no locked instruction); /metrics sums them from any loop.
+typedef struct {
+    atomic_ullong sc[SC_COUNT];
+    atomic_ullong requests;
+} counters;
+
+struct worker;
+
+typedef struct conn {
+    int            fd;
+    int            closing;      // no further requests: flush the ring, then close
+    struct worker *w;
+    struct conn   *prev, *next;  // worker's idle list, least recently active first
+    struct conn   *rprev, *rnext;  // worker's ready list (used up its rounds, not blocked)
+    int            ready;
+    long long      last_ms;
+    size_t         in_len;
+    rt_http_parser ps;           // scan state of the request at the front of in
+    unsigned       q_head, q_tail;  // responses [q_head, q_tail) await writing, in request order
+    size_t         q_off;           // bytes of the head response already written
+    int            writes;          // writes queued on the writer thread, exports waiting for a file
+    int            dead;            // closed while writes were queued; freed by the last one
+    resp           q[PIPE_MAX];     // buffers are kept across requests
+    char           in[REQ_MAX + 1];
+} conn;
+
+typedef struct {
+    int                used;
+    long long          after;
+    int                limit;
+    unsigned long long gen;    // data_gen when the page was queried
+    long long          next;   // X-Next-After value; -1 on the last page
+    rt_jbuf            body;
+} page_ent;
+
+typedef struct worker {
+    int       id;
+    int       lfd;         // SO_REUSEPORT listener owned by this loop
+    int       ep;
+    pthread_t tid;
+    long long now_ms;
+    conn     *idle_head, *idle_tail;
+    conn     *ready_head, *ready_tail;
+    rt_db        *rdb;     // reader checked out of POOL for the loop's lifetime
+    rt_stmt_cache rsc;     // READ_SQL on rdb
+    rt_jbuf       scratch; // a body built before its headers (/get, /add)
+    page_ent      pages[PAGE_CACHE];
+    mpsc          done;    // committed writes coming back from the writer thread
+    int           efd;     // eventfd in ep, signalled when done gains entries
+    atomic_int    notified;
+    counters      m;
+} worker;
+
 static void die(const char *m) { perror(m); exit(1); }
-static void http_400(int fd){ dprintf(fd,"HTTP/1.1 400 Bad Request\r\nContent-Length:0\r\n\r\n"); }
-static void http_404(int fd){ dprintf(fd,"HTTP/1.1 404 Not Found\r\nContent-Length:0\r\n\r\n"); }
-static void http_500(int fd){ dprintf(fd,"HTTP/1.1 500 Internal Server Error\r\nContent-Length:0\r\n\r\n"); }
-
-static sqlite3* open_db(void){
-    sqlite3 *db=NULL; if(sqlite3_open(DB_PATH,&db)!=SQLITE_OK){ return NULL; }
-    char *errmsg=NULL;
-    if(sqlite3_exec(db,DDL,NULL,NULL,&errmsg)!=SQLITE_OK){
-        if(errmsg){ fprintf(stderr,"sqlite: %s\n",errmsg); sqlite3_free(errmsg); }
-        sqlite3_close(db); return NULL;
-    }
-    return db;
-}
-
-static char from_hex(char c){ if(c>='0'&&c<='9') return c-'0'; c=tolower((unsigned char)c);
-    if(c>='a'&&c<='f') return c-'a'+10; return 0; }
-
-static void url_decode(char *s){
-    char *o=s;
-    for(; *s; s++,o++){
-        if(*s=='%' && isxdigit((unsigned char)s[1]) && isxdigit((unsigned char)s[2])){
-            *o = (from_hex(s[1])<<4) | from_hex(s[2]); s+=2;
-        } else if(*s=='+') { *o=' '; } else { *o=*s; }
-    }
-    *o='\0';
-}
-
-static const char* qget(const char *qs, const char *key, char *buf, size_t bufsz){
-    if(!qs) return NULL;
-    size_t klen = strlen(key);
-    const char *p = qs;
-    while(p && *p){
-        const char *eq = strchr(p,'=');
-        const char *amp = strchr(p,'&');
-        if(!amp) amp = p + strlen(p);
-        if(eq && (size_t)(eq-p)==klen && strncmp(p,key,klen)==0){
-            size_t vlen = (size_t)(amp - (eq+1));
-            if(vlen >= bufsz) vlen = bufsz-1;
-            strncpy(buf, eq+1, vlen); buf[vlen]='\0';
-            url_decode(buf);
-            return buf;
-        }
-        p = (*amp) ? amp+1 : NULL;
+
+static counters                 SETUP_M, WRITER_M, EXPORT_M;
+static _Thread_local counters  *M = &SETUP_M;   // the calling thread's counters
+static worker                  *WS;              // every loop, for /metrics
+static int                      NW;
+
+static inline void bump(atomic_ullong *v){
+    atomic_store_explicit(v, atomic_load_explicit(v,memory_order_relaxed) + 1, memory_order_relaxed);
+}
+#define COUNT(k) bump(&M->sc[k])
+
+static void mpsc_init(mpsc *q){
+    atomic_store(&q->stub.next, NULL);
+    atomic_store(&q->head, &q->stub);
+    q->tail = &q->stub;
+}
+
+static void mpsc_push(mpsc *q, mpsc_node *n){
+    atomic_store_explicit(&n->next, NULL, memory_order_relaxed);
+    mpsc_node *prev = atomic_exchange(&q->head, n);
+    atomic_store(&prev->next, n);
+}
+
+static mpsc_node *mpsc_pop(mpsc *q){
+    mpsc_node *tail = q->tail, *next = atomic_load(&tail->next);
+    if(tail == &q->stub){
+        if(!next) return NULL;
+        q->tail = tail = next; next = atomic_load(&next->next);
     }
+    if(next){ q->tail = next; return tail; }
+    if(tail != atomic_load(&q->head)) return NULL;   // a push is in progress
+    mpsc_push(q, &q->stub);
+    next = atomic_load(&tail->next);
+    if(next){ q->tail = next; return tail; }
     return NULL;
 }
 
-static void send_json(int fd, const char *json){
-    dprintf(fd,
+static void efd_signal(int efd){ uint64_t one = 1; COUNT(SC_EVENTFD); ssize_t n = write(efd,&one,sizeof(one)); (void)n; }
+static void efd_drain(int efd){ uint64_t v; COUNT(SC_EVENTFD); ssize_t n = read(efd,&v,sizeof(v)); (void)n; }
+
+static void conn_hdr(resp *r){
+    if(r->keep) RT_JBUF_LIT(&r->b,"Connection: keep-alive\r\n\r\n");
+    else        RT_JBUF_LIT(&r->b,"Connection: close\r\n\r\n");
+}
+
+// Status line and headers of a 200 JSON reply with an n-byte body, up to the
+// Connection header.
+static void json_head(resp *r, size_t n){
+    RT_JBUF_LIT(&r->b,
         "HTTP/1.1 200 OK\r\n"
         "Content-Type: application/json; charset=utf-8\r\n"
         "Cache-Control: no-store\r\n"
-        "Content-Length: %zu\r\n\r\n%s",
-        strlen(json), json);
-}
-
-static void handle_list(int fd){
-    sqlite3 *db = open_db(); if(!db){ http_500(fd); return; }
-    const char *SQL = "SELECT id,title,priority,done,created_at FROM todos ORDER BY id ASC;";
-    sqlite3_stmt *st=NULL; if(sqlite3_prepare_v2(db,SQL,-1,&st,NULL)!=SQLITE_OK){ sqlite3_close(db); http_500(fd); return; }
-    char *out = NULL; size_t cap=1024,len=0; out = malloc(cap); if(!out){ sqlite3_finalize(st); sqlite3_close(db); http_500(fd); return; }
-    len += snprintf(out+len,cap-len,"[");
-    int first=1;
-    while(sqlite3_step(st)==SQLITE_ROW){
-        if(!first){ len += snprintf(out+len,cap-len,","); } first=0;
-        const char *title=(const char*)sqlite3_column_text(st,1);
-        int id=sqlite3_column_int(st,0), pr=sqlite3_column_int(st,2), dn=sqlite3_column_int(st,3);
-        const char *ts=(const char*)sqlite3_column_text(st,4);
-        char obj[1024];
-        int n = snprintf(obj,sizeof(obj),
-            "{\"id\":%d,\"title\":\"%s\",\"priority\":%d,\"done\":%d,\"created_at\":\"%s\"}",
-            id, title?title:"", pr, dn, ts?ts:"");
-        while(len + (size_t)n + 2 > cap){ cap*=2; out = realloc(out,cap); if(!out){ sqlite3_finalize(st); sqlite3_close(db); http_500(fd); return; } }
-        memcpy(out+len,obj,(size_t)n); len += (size_t)n;
-    }
-    sqlite3_finalize(st); sqlite3_close(db);
-    if(len+2>cap){ cap+=2; out=realloc(out,cap); if(!out){ http_500(fd); return; } }
-    out[len++]=']'; out[len]='\0';
-    send_json(fd,out);
-    free(out);
-}
-
-static void handle_add(int fd, const char *qs){
-    char title[512]={0}, prbuf[32]={0};
-    if(!qget(qs,"title",title,sizeof(title)) || !qget(qs,"priority",prbuf,sizeof(prbuf))){ http_400(fd); return; }
-    int pr = atoi(prbuf);
-    sqlite3 *db = open_db(); if(!db){ http_500(fd); return; }
-    const char *SQL="INSERT INTO todos(title,priority) VALUES(?,?);";
-    sqlite3_stmt *st=NULL;
-    if(sqlite3_prepare_v2(db,SQL,-1,&st,NULL)!=SQLITE_OK){ sqlite3_close(db); http_500(fd); return; }
-    sqlite3_bind_text(st,1,title,-1,SQLITE_TRANSIENT);
-    sqlite3_bind_int(st,2,pr);
-    if(sqlite3_step(st)!=SQLITE_DONE){ sqlite3_finalize(st); sqlite3_close(db); http_500(fd); return; }
-    sqlite3_finalize(st);
-    long last_id = sqlite3_last_insert_rowid(db);
-    sqlite3_close(db);
-    char json[128]; snprintf(json,sizeof(json),"{\"status\":\"ok\",\"id\":%ld}", last_id);
-    send_json(fd,json);
-}
-
-static void handle_done(int fd, const char *qs){
-    char idbuf[32]={0}; if(!qget(qs,"id",idbuf,sizeof(idbuf))){ http_400(fd); return; }
-    int id=atoi(idbuf);
-    sqlite3 *db=open_db(); if(!db){ http_500(fd); return; }
-    const char *SQL="UPDATE todos SET done=1 WHERE id=?;";
-    sqlite3_stmt *st=NULL;
-    if(sqlite3_prepare_v2(db,SQL,-1,&st,NULL)!=SQLITE_OK){ sqlite3_close(db); http_500(fd); return; }
-    sqlite3_bind_int(st,1,id);
-    if(sqlite3_step(st)!=SQLITE_DONE){ sqlite3_finalize(st); sqlite3_close(db); http_500(fd); return; }
-    sqlite3_finalize(st); sqlite3_close(db);
-    send_json(fd,"{\"status\":\"ok\"}");
+        "Content-Length: ");
+    rt_json_int(&r->b,(long long)n);
+    RT_JBUF_LIT(&r->b,"\r\n");
 }
 
-static void handle_rm(int fd, const char *qs){
-    char idbuf[32]={0}; if(!qget(qs,"id",idbuf,sizeof(idbuf))){ http_400(fd); return; }
-    int id=atoi(idbuf);
-    sqlite3 *db=open_db(); if(!db){ http_500(fd); return; }
-    const char *SQL="DELETE FROM todos WHERE id=?;";
-    sqlite3_stmt *st=NULL;
-    if(sqlite3_prepare_v2(db,SQL,-1,&st,NULL)!=SQLITE_OK){ sqlite3_close(db); http_500(fd); return; }
-    sqlite3_bind_int(st,1,id);
-    if(sqlite3_step(st)!=SQLITE_DONE){ sqlite3_finalize(st); sqlite3_close(db); http_500(fd); return; }
-    sqlite3_finalize(st); sqlite3_close(db);
-    send_json(fd,"{\"status\":\"ok\"}");
+// Fixed replies, complete with body, built once by build_static for either value of
+// resp.keep.
+enum { ST_OK, ST_OK_PURGE, ST_400, ST_404, ST_413, ST_431, ST_500, ST_501, ST_COUNT };
+static const struct { const char *status, *body; } STATIC_SPEC[ST_COUNT] = {
+    [ST_OK]       = { "200 OK", "{\"status\":\"ok\"}" },
+    [ST_OK_PURGE] = { "200 OK", "{\"status\":\"ok\",\"action\":\"purge\"}" },
+    [ST_400]      = { "400 Bad Request", NULL },
+    [ST_404]      = { "404 Not Found", NULL },
+    [ST_413]      = { "413 Content Too Large", NULL },
+    [ST_431]      = { "431 Request Header Fields Too Large", NULL },
+    [ST_500]      = { "500 Internal Server Error", NULL },
+    [ST_501]      = { "501 Not Implemented", NULL },
+};
+static rt_jbuf STATIC_RESP[ST_COUNT][2];   // [kind][keep]
+
+static void build_static(void){
+    for(int k=0;k<ST_COUNT;k++){
+        for(int keep=0;keep<2;keep++){
+            const char *body = STATIC_SPEC[k].body;
+            resp r = { .keep = keep };
+            if(body) json_head(&r,strlen(body));
+            else {
+                RT_JBUF_LIT(&r.b,"HTTP/1.1 "); rt_jbuf_put(&r.b,STATIC_SPEC[k].status,strlen(STATIC_SPEC[k].status));
+                RT_JBUF_LIT(&r.b,"\r\nContent-Length: 0\r\n");
+            }
+            conn_hdr(&r);
+            if(body) rt_jbuf_put(&r.b,body,strlen(body));
+            if(r.b.oom) die("build_static");
+            STATIC_RESP[k][keep] = r.b;
+        }
+    }
+}
+
+static void http_static(resp *r, int kind){
+    const rt_jbuf *s = &STATIC_RESP[kind][r->keep!=0];
+    rt_jbuf_put(&r->b,s->p,s->len);
+}
+static void http_400(resp *r){ http_static(r,ST_400); }
+static void http_404(resp *r){ http_static(r,ST_404); }
+static void http_413(resp *r){ r->keep=0; http_static(r,ST_413); }
+static void http_501(resp *r){ r->keep=0; http_static(r,ST_501); }
+static void http_431(resp *r){ r->keep=0; http_static(r,ST_431); }
+static void http_500(resp *r){ http_static(r,ST_500); }
+
+// Opens the pool (a reader for each loop and one for the export thread), creates the
+// schema on the writer and prepares WRITE_SQL. Readers are opened after the writer has
+// switched the file to WAL.
+static int open_db(int n_readers){
+    // DB_SYNC=full fsyncs the WAL on every commit (durable across power loss).
+    const char *sync = getenv("DB_SYNC");
+    const rt_sqlite_opts o = {
+        .wal = 1, .mmap_bytes = MMAP_BYTES, .cache_kib = CACHE_KIB, .busy_ms = BUSY_MS,
+        .synchronous = sync && strcmp(sync,"full")==0 ? RT_SQLITE_SYNC_FULL : RT_SQLITE_SYNC_NORMAL,
+    };
+    if(rt_db_pool_open(DB_PATH,&o,n_readers,&POOL)!=0) return 1;
+    if(rt_sqlite_exec(&POOL.writer,DDL)!=0 ||
+       rt_stmt_cache_init(&WRITE_SC,&POOL.writer,WRITE_SQL,WR_COUNT)!=0){
+        rt_db_pool_close(&POOL); return 1;
+    }
+    return 0;
 }
 
-static void handle_get(int fd, const char *qs){
-    char idbuf[32]={0}; if(!qget(qs,"id",idbuf,sizeof(idbuf))){ http_400(fd); return; }
+static int qget(rt_slice qs, const char *key, char *buf, size_t bufsz){
+    return rt_http_form_get(qs,key,buf,bufsz) >= 0;
+}
+
+static int qhas(rt_slice qs, const char *key){ return rt_http_form_get(qs,key,NULL,0) >= 0; }
+
+static void row_json(rt_jbuf *b, sqlite3_stmt *st){
+    RT_JBUF_LIT(b,"{\"id\":");          rt_json_int(b,sqlite3_column_int64(st,0));
+    RT_JBUF_LIT(b,",\"title\":");       rt_json_str(b,(const char*)sqlite3_column_text(st,1),(size_t)sqlite3_column_bytes(st,1));
+    RT_JBUF_LIT(b,",\"priority\":");    rt_json_int(b,sqlite3_column_int64(st,2));
+    RT_JBUF_LIT(b,",\"done\":");        rt_json_int(b,sqlite3_column_int64(st,3));
+    RT_JBUF_LIT(b,",\"created_at\":");  rt_json_str(b,(const char*)sqlite3_column_text(st,4),(size_t)sqlite3_column_bytes(st,4));
+    RT_JBUF_LIT(b,"}");
+}
+
+// Appends the next chunk of a /list body to r->b: rows after r->ls.after until CHUNK
+// bytes are buffered or the table ends, framed as one HTTP chunk (plus the last-chunk
+// marker at the end). Clears r->ls.on after the final chunk. Returns -1 on a database
+// error; the body is then incomplete.
+static int list_fill(rt_stmt_cache *sc, resp *r){
+    obuf *b = &r->b;
+    size_t hdr = b->len;
+    if(r->ls.chunked){ if(rt_jbuf_reserve(b,10)) return -1; b->len += 10; }   // size line, patched below
+    size_t body = b->len;
+    if(r->ls.rows<0){ RT_JBUF_LIT(b,"["); r->ls.rows = 0; }
+    sqlite3_stmt *st = rt_stmt_get(sc,RD_LIST);
+    sqlite3_bind_int64(st,1,r->ls.after);
+    int rc;
+    while((rc = sqlite3_step(st))==SQLITE_ROW){
+        if(r->ls.rows++) RT_JBUF_LIT(b,",");
+        row_json(b,st);
+        r->ls.after = sqlite3_column_int64(st,0);
+        if(b->len - hdr >= CHUNK) break;
+    }
+    rt_stmt_done(st);
+    if(rc!=SQLITE_ROW && rc!=SQLITE_DONE) return -1;
+    if(rc==SQLITE_DONE){ RT_JBUF_LIT(b,"]"); r->ls.on = 0; }
+    if(r->ls.chunked){
+        if(b->oom) return -1;
+        char size[11]; snprintf(size,sizeof(size),"%08zx\r\n",b->len - body);
+        memcpy(b->p + hdr, size, 10);
+        if(r->ls.on) RT_JBUF_LIT(b,"\r\n");
+        else         RT_JBUF_LIT(b,"\r\n0\r\n\r\n");
+    }
+    return b->oom ? -1 : 0;
+}
+
+// Starts a streamed /list response: headers plus the first chunk; flush() produces the
+// rest as the socket drains.
+static void handle_list(rt_stmt_cache *sc, resp *r){
+    r->ls.on = 1; r->ls.chunked = r->http11; r->ls.after = INT64_MIN; r->ls.rows = -1;
+    if(!r->http11) r->keep = 0;
+    RT_JBUF_LIT(&r->b,
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: application/json; charset=utf-8\r\n"
+        "Cache-Control: no-store\r\n");
+    if(r->ls.chunked) RT_JBUF_LIT(&r->b,"Transfer-Encoding: chunked\r\n");
+    conn_hdr(r);
+    if(list_fill(sc,r)){ r->ls.on = 0; r->b.len = 0; http_500(r); }
+}
+
+// Body of one keyset page into e (a JSON array). Returns 0, or -1 on a database error.
+static int page_query(worker *w, page_ent *e){
+    rt_jbuf *b = &e->body; b->len = 0;
+    sqlite3_stmt *st = rt_stmt_get(&w->rsc,RD_PAGE);
+    sqlite3_bind_int64(st,1,e->after);
+    sqlite3_bind_int(st,2,e->limit);
+    RT_JBUF_LIT(b,"[");
+    int rc, rows = 0;
+    long long last = e->after;
+    while((rc = sqlite3_step(st))==SQLITE_ROW){
+        if(rows++) RT_JBUF_LIT(b,",");
+        row_json(b,st);
+        last = sqlite3_column_int64(st,0);
+    }
+    rt_stmt_done(st);
+    RT_JBUF_LIT(b,"]");
+    e->next = rows==e->limit ? last : -1;
+    return rc==SQLITE_DONE && !b->oom ? 0 : -1;
+}
+
+static void handle_page(worker *w, resp *r, rt_slice qs){
+    char buf[32];
+    long long after = qget(qs,"after",buf,sizeof(buf)) ? strtoll(buf,NULL,10) : INT64_MIN;
+    int limit = qget(qs,"limit",buf,sizeof(buf)) ? atoi(buf) : PAGE_DEFAULT;
+    if(limit<=0){ http_400(r); return; }
+    if(limit>PAGE_MAX) limit = PAGE_MAX;
+
+    // Read the generation before querying: a page stored under gen g never predates a
+    // commit that bumped the counter to g.
+    unsigned long long gen = atomic_load(&data_gen);
+    unsigned long long h = ((unsigned long long)after * 0x9E3779B97F4A7C15ULL) ^ (unsigned long long)limit;
+    page_ent *e = &w->pages[(h >> 32) & (PAGE_CACHE-1)];
+    int hit = e->used && e->gen==gen && e->after==after && e->limit==limit;
+    if(!hit){
+        e->used = 0; e->after = after; e->limit = limit; e->gen = gen;
+        if(page_query(w,e)){
+            if(e->body.oom) rt_jbuf_free(&e->body);
+            http_500(r); return;
+        }
+        e->used = 1;
+    }
+    json_head(r,e->body.len);
+    if(hit) RT_JBUF_LIT(&r->b,"X-Cache: hit\r\n"); else RT_JBUF_LIT(&r->b,"X-Cache: miss\r\n");
+    if(e->next>=0){ RT_JBUF_LIT(&r->b,"X-Next-After: "); rt_json_int(&r->b,e->next); RT_JBUF_LIT(&r->b,"\r\n"); }
+    conn_hdr(r);
+    rt_jbuf_put(&r->b,e->body.p,e->body.len);
+}
+
+static void handle_get(worker *w, resp *r, rt_slice qs){
+    char idbuf[32]={0}; if(!qget(qs,"id",idbuf,sizeof(idbuf))){ http_400(r); return; }
     int id=atoi(idbuf);
-    sqlite3 *db=open_db(); if(!db){ http_500(fd); return; }
-    const char *SQL="SELECT id,title,priority,done,created_at FROM todos WHERE id=?;";
-    sqlite3_stmt *st=NULL;
-    if(sqlite3_prepare_v2(db,SQL,-1,&st,NULL)!=SQLITE_OK){ sqlite3_close(db); http_500(fd); return; }
+    sqlite3_stmt *st = rt_stmt_get(&w->rsc,RD_GET);
     sqlite3_bind_int(st,1,id);
     int rc = sqlite3_step(st);
     if(rc==SQLITE_ROW){
-        char json[1024];
-        snprintf(json,sizeof(json),
-            "{\"id\":%d,\"title\":\"%s\",\"priority\":%d,\"done\":%d,\"created_at\":\"%s\"}",
-            sqlite3_column_int(st,0),
-            sqlite3_column_text(st,1),
-            sqlite3_column_int(st,2),
-            sqlite3_column_int(st,3),
-            sqlite3_column_text(st,4));
-        send_json(fd,json);
+        rt_jbuf *body = &w->scratch; body->len = 0;
+        row_json(body,st);
+        if(body->oom){ rt_jbuf_free(body); http_500(r); }
+        else {
+            json_head(r,body->len);
+            conn_hdr(r);
+            rt_jbuf_put(&r->b,body->p,body->len);
+        }
+    } else if(rc==SQLITE_DONE){
+        http_404(r);
     } else {
-        http_404(fd);
+        http_500(r);
     }
-    sqlite3_finalize(st); sqlite3_close(db);
+    rt_stmt_done(st);
 }
 
-static void handle_purge(int fd){
-    sqlite3 *db=open_db(); if(!db){ http_500(fd); return; }
-    char *errmsg=NULL;
-    if(sqlite3_exec(db,"DROP TABLE IF EXISTS todos;",NULL,NULL,&errmsg)!=SQLITE_OK){
-        if(errmsg){ fprintf(stderr,"sqlite: %s\n",errmsg); sqlite3_free(errmsg); }
-        sqlite3_close(db); http_500(fd); return;
+// Prometheus text: requests and syscalls summed over the loops, the writer thread and
+// the export thread.
+static void handle_metrics(resp *r){
+    unsigned long long sc[SC_COUNT] = {0}, req = 0, total = 0;
+    for(int i=0;i<NW+2;i++){
+        counters *m = i<NW ? &WS[i].m : i==NW ? &WRITER_M : &EXPORT_M;
+        req += atomic_load_explicit(&m->requests,memory_order_relaxed);
+        for(int k=0;k<SC_COUNT;k++) sc[k] += atomic_load_explicit(&m->sc[k],memory_order_relaxed);
     }
-    if(sqlite3_exec(db,DDL,NULL,NULL,&errmsg)!=SQLITE_OK){
-        if(errmsg){ fprintf(stderr,"sqlite: %s\n",errmsg); sqlite3_free(errmsg); }
-        sqlite3_close(db); http_500(fd); return;
+    rt_jbuf b = {0};
+    RT_JBUF_LIT(&b,"# TYPE http_requests_total counter\nhttp_requests_total ");
+    rt_json_int(&b,(long long)req);
+    RT_JBUF_LIT(&b,"\n# TYPE http_syscalls_total counter\n");
+    for(int k=0;k<SC_COUNT;k++){
+        RT_JBUF_LIT(&b,"http_syscalls_total{call=\""); rt_jbuf_put(&b,SC_NAME[k],strlen(SC_NAME[k]));
+        RT_JBUF_LIT(&b,"\"} "); rt_json_int(&b,(long long)sc[k]); RT_JBUF_LIT(&b,"\n");
+        total += sc[k];
     }
-    sqlite3_close(db);
-    send_json(fd,"{\"status\":\"ok\",\"action\":\"purge\"}");
+    char line[96];
+    int n = snprintf(line,sizeof(line),"# TYPE http_syscalls_per_request gauge\nhttp_syscalls_per_request %.3f\n",
+                     req ? (double)total / (double)req : 0.0);
+    rt_jbuf_put(&b,line,(size_t)n);
+    if(b.oom){ rt_jbuf_free(&b); http_500(r); return; }
+    RT_JBUF_LIT(&r->b,
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: text/plain; version=0.0.4\r\n"
+        "Cache-Control: no-store\r\n"
+        "Content-Length: ");
+    rt_json_int(&r->b,(long long)b.len);
+    RT_JBUF_LIT(&r->b,"\r\n");
+    conn_hdr(r);
+    rt_jbuf_put(&r->b,b.p,b.len);
+    rt_jbuf_free(&b);
+}
+
+// A write request travelling to the writer thread and back, or an /export request
+// waiting for the export thread.
+enum { OP_ADD, OP_DONE, OP_RM, OP_PURGE, OP_EXPORT };
+typedef struct wop {
+    mpsc_node node;      // first: a popped node is the op
+    int       kind;      // OP_*
+    int       id, pr;
+    char     *title;
+    conn     *c;
+    resp     *r;         // pending slot in c->q
+    int       ok;
+    long long rowid;
+    unsigned long long gen;   // OP_EXPORT: data_gen the file must reach
+    struct wop *wait;         //   next in EXPORT.waiting
+    int       fd;             //   the slot's dup of the file, when ok
+    off_t     size;
+} wop;
+
+static mpsc       WQ;             // loops -> writer thread
+static int        wq_efd;
+static atomic_int wq_sleeping;
+
+static void submit(conn *c, resp *r, wop *op){
+    op->c = c; op->r = r;
+    r->pending = 1; c->writes++;
+    mpsc_push(&WQ, &op->node);
+    if(atomic_exchange(&wq_sleeping,0)) efd_signal(wq_efd);
+}
+
+// A write op in the slot's arena; it lives until the response has been sent.
+static wop *wop_new(resp *r, int kind){
+    wop *op = rt_arena_alloc(&r->a, sizeof(wop), _Alignof(wop));
+    if(op){ memset(op,0,sizeof(*op)); op->kind = kind; }
+    return op;
 }
 
-static void serve(int cfd){
-    char buf[8192]; ssize_t n = read(cfd, buf, sizeof(buf)-1);
-    if(n<=0){ close(cfd); return; } buf[n]='\0';
+// Returns a finished op to its connection's loop.
+static void hand_back(wop *op){
+    worker *w = op->c->w;
+    mpsc_push(&w->done, &op->node);
+    if(!atomic_exchange(&w->notified,1)) efd_signal(w->efd);
+}
+
+static void handle_add(conn *c, resp *r, rt_slice qs){
+    char title[512], prbuf[32];
+    if(!qget(qs,"title",title,sizeof(title)) || !qget(qs,"priority",prbuf,sizeof(prbuf))){ http_400(r); return; }
+    wop *op = wop_new(r, OP_ADD); if(!op){ http_500(r); return; }
+    if(!(op->title = rt_arena_strndup(&r->a, title, strlen(title)))){ http_500(r); return; }
+    op->pr = atoi(prbuf);
+    submit(c, r, op);
+}
 
-    char method[8]={0}, path[1024]={0};
-    if(sscanf(buf,"%7s %1023s", method, path)!=2){ http_400(cfd); close(cfd); return; }
+// Queues a single-id write (done, rm).
+static void handle_by_id(conn *c, int kind, resp *r, rt_slice qs){
+    char idbuf[32]={0}; if(!qget(qs,"id",idbuf,sizeof(idbuf))){ http_400(r); return; }
+    wop *op = wop_new(r, kind); if(!op){ http_500(r); return; }
+    op->id = atoi(idbuf);
+    submit(c, r, op);
+}
+
+static void handle_purge(conn *c, resp *r){
+    wop *op = wop_new(r, OP_PURGE); if(!op){ http_500(r); return; }
+    submit(c, r, op);
+}
+
+// /export: the whole table as one JSON array in an unlinked temp file in $TMPDIR,
+// shared by every loop. The export thread builds it on its own reader connection, so
+// no event loop scans the table or writes the file. A request is answered at once from
+// the current file if that was built at or after the data_gen the request read;
+// otherwise its slot stays pending, like a queued write, until the export thread has
+// published a newer file and handed the request back to its loop. Each response sends
+// the file with sendfile from its own dup of the descriptor, so a rebuild never
+// disturbs a transfer in progress.
+static struct {
+    pthread_mutex_t    mu;
+    pthread_cond_t     cv;        // signalled when waiting gains an entry
+    int                fd;        // -1 until built
+    off_t              size;
+    unsigned long long gen;       // data_gen read before the file was built
+    wop               *waiting;   // requests that need a newer file
+} EXPORT = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, -1, 0, 0, NULL };
+static rt_stmt_cache EXPORT_SC;   // READ_SQL on a reader of POOL; only used by the export thread
+
+static int write_all(int fd, const char *p, size_t n){
+    while(n){
+        COUNT(SC_FILE);
+        ssize_t k = write(fd,p,n);
+        if(k<0){ if(errno==EINTR) continue; return -1; }
+        p += k; n -= (size_t)k;
+    }
+    return 0;
+}
 
-    char *qs = strchr(path,'?'); if(qs){ *qs++ = '\0'; }
+// A private file with no name, in $TMPDIR (default /tmp): O_TMPFILE where the file
+// system supports it, else mkostemp and unlink.
+static int export_tmpfile(void){
+    const char *dir = getenv("TMPDIR");
+    if(!dir || !*dir) dir = "/tmp";
+    COUNT(SC_FILE); int fd = open(dir, O_TMPFILE|O_RDWR|O_CLOEXEC, 0600);
+    if(fd>=0 || (errno!=EOPNOTSUPP && errno!=EISDIR && errno!=EINVAL)) return fd;
+    char path[4096];
+    if(snprintf(path,sizeof(path),"%s/todos-export-XXXXXX",dir) >= (int)sizeof(path)) return -1;
+    COUNT(SC_FILE); fd = mkostemp(path,O_CLOEXEC);
+    if(fd>=0){ COUNT(SC_FILE); unlink(path); }
+    return fd;
+}
 
-    if(strcmp(method,"GET")!=0 && strcmp(method,"POST")!=0){
-        http_400(cfd); close(cfd); return;
+// Writes the export file, staging rows in b; returns its descriptor (size in *size) or -1.
+static int export_build(rt_stmt_cache *sc, rt_jbuf *b, off_t *size){
+    int fd = export_tmpfile();
+    if(fd<0) return -1;
+    b->len = 0;
+    RT_JBUF_LIT(b,"[");
+    sqlite3_stmt *st = rt_stmt_get(sc,RD_LIST);
+    sqlite3_bind_int64(st,1,INT64_MIN);
+    int rc, ok = 1; long long rows = 0; off_t total = 0;
+    while(ok && (rc = sqlite3_step(st))==SQLITE_ROW){
+        if(rows++) RT_JBUF_LIT(b,",");
+        row_json(b,st);
+        if(b->len >= CHUNK){
+            ok = !b->oom && write_all(fd,b->p,b->len)==0;
+            total += (off_t)b->len; b->len = 0;
+        }
     }
+    rt_stmt_done(st);
+    RT_JBUF_LIT(b,"]");
+    ok = ok && rc==SQLITE_DONE && !b->oom && write_all(fd,b->p,b->len)==0;
+    total += (off_t)b->len;
+    if(b->oom) rt_jbuf_free(b);
+    if(!ok){ COUNT(SC_CLOSE); close(fd); return -1; }
+    *size = total;
+    return fd;
+}
 
-    if(strcmp(path,"/list")==0){ handle_list(cfd); }
-    else if(strcmp(path,"/add")==0){ handle_add(cfd, qs); }
-    else if(strcmp(path,"/done")==0){ handle_done(cfd, qs); }
-    else if(strcmp(path,"/rm")==0){ handle_rm(cfd, qs); }
-    else if(strcmp(path,"/get")==0){ handle_get(cfd, qs); }
-    else if(strcmp(path,"/purge")==0){ handle_purge(cfd); }
-    else { http_404(cfd); }
+// Headers for the file fd (owned by the slot from here on) and its body by sendfile.
+static void export_resp(resp *r, int fd, off_t size){
+    json_head(r,(size_t)size);
+    conn_hdr(r);
+    r->f.on = 1; r->f.fd = fd; r->f.off = 0; r->f.len = size;
+}
 
-    close(cfd);
+static void handle_export(conn *c, resp *r){
+    unsigned long long gen = atomic_load(&data_gen);   // before the file is chosen, as for pages
+    wop *op = wop_new(r, OP_EXPORT); if(!op){ http_500(r); return; }
+    pthread_mutex_lock(&EXPORT.mu);
+    if(EXPORT.fd>=0 && EXPORT.gen>=gen){
+        COUNT(SC_FILE);
+        int fd = dup(EXPORT.fd);
+        off_t size = EXPORT.size;
+        pthread_mutex_unlock(&EXPORT.mu);
+        if(fd<0){ http_500(r); return; }
+        export_resp(r, fd, size);
+        return;
+    }
+    op->c = c; op->r = r; op->gen = gen;
+    r->pending = 1; c->writes++;
+    op->wait = EXPORT.waiting; EXPORT.waiting = op;
+    pthread_cond_signal(&EXPORT.cv);
+    pthread_mutex_unlock(&EXPORT.mu);
 }
 
-int main(void){
-    int sfd = socket(AF_INET, SOCK_STREAM, 0); if(sfd<0) die("socket");
-    int opt=1; setsockopt(sfd,SOL_SOCKET,SO_REUSEADDR,&opt,sizeof(opt));
+// Builds a new file whenever requests wait for one, publishes it, and hands back every
+// waiting request it satisfies (all of them if the build failed). Requests that arrive
+// during a build with a newer data_gen wait for the next one.
+static void *export_loop(void *arg){
+    (void)arg;
+    M = &EXPORT_M;
+    rt_jbuf b = {0};
+    pthread_mutex_lock(&EXPORT.mu);
+    for(;;){
+        while(!EXPORT.waiting) pthread_cond_wait(&EXPORT.cv,&EXPORT.mu);
+        pthread_mutex_unlock(&EXPORT.mu);
+        unsigned long long gen = atomic_load(&data_gen);   // before building, as for pages
+        off_t size = 0;
+        int fd = export_build(&EXPORT_SC,&b,&size);
+        pthread_mutex_lock(&EXPORT.mu);
+        if(fd>=0){
+            if(EXPORT.fd>=0){ COUNT(SC_CLOSE); close(EXPORT.fd); }
+            EXPORT.fd = fd; EXPORT.size = size; EXPORT.gen = gen;
+        }
+        for(wop **p = &EXPORT.waiting; *p; ){
+            wop *op = *p;
+            if(fd>=0 && op->gen>gen){ p = &op->wait; continue; }
+            *p = op->wait;
+            op->ok = 0;
+            if(fd>=0){ COUNT(SC_FILE); op->fd = dup(fd); op->size = size; op->ok = op->fd>=0; }
+            hand_back(op);
+        }
+    }
+    return NULL;
+}
+
+static int step_done(sqlite3_stmt *st){
+    int rc = sqlite3_step(st);
+    rt_stmt_done(st);
+    return rc==SQLITE_DONE;
+}
+
+// Applies one write inside the open batch transaction.
+static void apply(sqlite3 *db, wop *op){
+    sqlite3_stmt *st;
+    switch(op->kind){
+    case OP_ADD:
+        st = rt_stmt_get(&WRITE_SC,WR_ADD);
+        sqlite3_bind_text(st,1,op->title,-1,SQLITE_STATIC);
+        sqlite3_bind_int(st,2,op->pr);
+        op->ok = step_done(st);
+        op->rowid = sqlite3_last_insert_rowid(db);
+        break;
+    case OP_DONE: case OP_RM:
+        st = rt_stmt_get(&WRITE_SC, op->kind==OP_DONE ? WR_DONE : WR_RM);
+        sqlite3_bind_int(st,1,op->id);
+        op->ok = step_done(st);
+        break;
+    case OP_PURGE:
+        // Rows and the AUTOINCREMENT sequence, without a schema change that would make
+        // every loop re-prepare its statements.
+        op->ok = step_done(rt_stmt_get(&WRITE_SC,WR_PURGE)) &&
+                 step_done(rt_stmt_get(&WRITE_SC,WR_PURGE_SEQ));
+        break;
+    }
+}
+
+static long long mono_us(void){
+    struct timespec ts; clock_gettime(CLOCK_MONOTONIC,&ts);
+    return (long long)ts.tv_sec*1000000 + ts.tv_nsec/1000;
+}
+
+// Next queued write, waiting up to timeout_us (< 0: forever). NULL on timeout.
+static wop *wq_next(long long timeout_us){
+    long long until = timeout_us<0 ? 0 : mono_us() + timeout_us;
+    for(;;){
+        mpsc_node *n = mpsc_pop(&WQ);
+        if(n) return (wop*)n;
+        atomic_store(&wq_sleeping,1);
+        if((n = mpsc_pop(&WQ))){ atomic_store(&wq_sleeping,0); return (wop*)n; }
+        long long left = timeout_us<0 ? -1 : until - mono_us();
+        if(timeout_us>=0 && left<=0){ atomic_store(&wq_sleeping,0); return NULL; }
+        struct pollfd pfd = { .fd = wq_efd, .events = POLLIN };
+        struct timespec ts = { .tv_sec = left/1000000, .tv_nsec = (left%1000000)*1000 };
+        COUNT(SC_POLL);
+        if(ppoll(&pfd,1,left<0 ? NULL : &ts,NULL)>0) efd_drain(wq_efd);
+        atomic_store(&wq_sleeping,0);
+    }
+}
+
+static void *writer_loop(void *arg){
+    (void)arg;
+    M = &WRITER_M;
+    wop **batch = malloc((size_t)commit_max * sizeof(wop*)); if(!batch) die("malloc");
+    for(;;){
+        int n = 0;
+        batch[n++] = wq_next(-1);
+        long long until = mono_us() + commit_us;
+        sqlite3 *db = rt_db_pool_writer_lock(&POOL)->db;
+        int ok = sqlite3_exec(db,"BEGIN IMMEDIATE;",NULL,NULL,NULL)==SQLITE_OK;
+        if(ok) apply(db, batch[0]);
+        while(ok && n < commit_max){
+            long long left = until - mono_us();
+            wop *op = wq_next(left>0 ? left : 0);
+            if(!op) break;
+            apply(db, op); batch[n++] = op;
+        }
+        if(ok && sqlite3_exec(db,"COMMIT;",NULL,NULL,NULL)!=SQLITE_OK){
+            fprintf(stderr,"sqlite commit: %s\n", sqlite3_errmsg(db));
+            sqlite3_exec(db,"ROLLBACK;",NULL,NULL,NULL); ok = 0;
+        }
+        rt_db_pool_writer_unlock(&POOL);
+        if(ok) atomic_fetch_add(&data_gen,1);   // before any client hears of the commit
+        for(int i=0;i<n;i++){
+            if(!ok) batch[i]->ok = 0;
+            hand_back(batch[i]);
+        }
+    }
+    return NULL;
+}
+
+static long long mono_ms(void){
+    struct timespec ts; clock_gettime(CLOCK_MONOTONIC,&ts);
+    return (long long)ts.tv_sec*1000 + ts.tv_nsec/1000000;
+}
+
+// Form content type of a POST body (parameters may be sent there instead of the query).
+static int is_form(const rt_http_req *q){
+    const rt_slice *ct = rt_http_header_get(q,"content-type");
+    static const char form[] = "application/x-www-form-urlencoded";
+    return ct && ct->n >= sizeof(form)-1 && strncasecmp(ct->p,form,sizeof(form)-1)==0;
+}
+
+// Dispatches one complete request and writes its response into r.
+static void serve(conn *c, const rt_http_req *q, rt_slice body, resp *r){
+    int post = rt_slice_eq(q->method,"POST");
+    if(!post && !rt_slice_eq(q->method,"GET")){ http_400(r); return; }
+    rt_slice qs = post && is_form(q) ? body : q->query;
+    rt_slice p = q->path;
+
+    if(rt_slice_eq(p,"/list") && (qhas(qs,"after") || qhas(qs,"limit"))){ handle_page(c->w, r, qs); }
+    else if(rt_slice_eq(p,"/list")){ handle_list(&c->w->rsc, r); }
+    else if(rt_slice_eq(p,"/add")){ handle_add(c, r, qs); }
+    else if(rt_slice_eq(p,"/done")){ handle_by_id(c, OP_DONE, r, qs); }
+    else if(rt_slice_eq(p,"/rm")){ handle_by_id(c, OP_RM, r, qs); }
+    else if(rt_slice_eq(p,"/get")){ handle_get(c->w, r, qs); }
+    else if(rt_slice_eq(p,"/purge")){ handle_purge(c, r); }
+    else if(rt_slice_eq(p,"/export")){ handle_export(c, r); }
+    else if(rt_slice_eq(p,"/metrics")){ handle_metrics(r); }
+    else { http_404(r); }
+}
+
+static void idle_unlink(conn *c){
+    worker *w = c->w;
+    if(c->prev) c->prev->next = c->next; else w->idle_head = c->next;
+    if(c->next) c->next->prev = c->prev; else w->idle_tail = c->prev;
+    c->prev = c->next = NULL;
+}
+
+static void idle_touch(conn *c){
+    worker *w = c->w;
+    if(w->idle_tail != c){
+        idle_unlink(c);
+        c->prev = w->idle_tail;
+        if(w->idle_tail) w->idle_tail->next = c; else w->idle_head = c;
+        w->idle_tail = c;
+    }
+    c->last_ms = w->now_ms;
+}
+
+static void ready_push(conn *c){
+    worker *w = c->w;
+    if(c->ready) return;
+    c->ready = 1; c->rnext = NULL; c->rprev = w->ready_tail;
+    if(w->ready_tail) w->ready_tail->rnext = c; else w->ready_head = c;
+    w->ready_tail = c;
+}
+
+static void ready_unlink(conn *c){
+    worker *w = c->w;
+    if(!c->ready) return;
+    if(c->rprev) c->rprev->rnext = c->rnext; else w->ready_head = c->rnext;
+    if(c->rnext) c->rnext->rprev = c->rprev; else w->ready_tail = c->rprev;
+    c->rprev = c->rnext = NULL; c->ready = 0;
+}
+
+// Empties a slot for the next response (its buffer and arena chunks are kept).
+static void resp_reset(resp *r){
+    if(r->f.on){ COUNT(SC_CLOSE); close(r->f.fd); r->f.on = 0; }
+    rt_arena_rewind(&r->a, (rt_arena_pos){ NULL, NULL });
+    r->b.len = 0; r->b.oom = 0; r->pending = 0; r->ls.on = 0;
+}
+
+static void conn_free(conn *c){
+    for(int i=0;i<PIPE_MAX;i++){ resp_reset(&c->q[i]); rt_jbuf_free(&c->q[i].b); rt_arena_free(&c->q[i].a); }
+    free(c);
+}
+
+static void conn_close(conn *c){
+    COUNT(SC_CLOSE);
+    close(c->fd);              // also drops it from the epoll set
+    idle_unlink(c);
+    ready_unlink(c);
+    if(c->writes){ c->dead = 1; return; }   // the writer or export thread still points at its slots
+    conn_free(c);
+}
+
+static int queue_full(const conn *c){ return c->q_tail - c->q_head == PIPE_MAX; }
+
+// Frames and serves every complete request at the front of c->in, in order. Stops
+// behind a queued write (or a waiting /export) so later requests on the connection
+// observe it.
+static void parse_requests(conn *c){
+    size_t off = 0;
+    while(!c->closing && !queue_full(c) && !c->writes){
+        rt_http_req q;
+        size_t avail = c->in_len - off;
+        int rc = rt_http_parse(&c->ps, c->in + off, avail, &q);
+        if(rc==RT_HTTP_INCOMPLETE) break;
+        resp *r = &c->q[c->q_tail % PIPE_MAX];
+        resp_reset(r);
+        r->http11 = 1; r->keep = 0;
+        bump(&M->requests);
+        if(rc==RT_HTTP_EUNSUP){ http_501(r); }
+        else if(rc==RT_HTTP_EHEADERS){ http_431(r); }
+        else if(rc<0){ http_400(r); }
+        else {
+            size_t head = (size_t)rc;
+            r->http11 = q.minor >= 1;
+            r->keep = q.keep_alive;
+            size_t body = q.content_length > 0 ? (size_t)q.content_length : 0;
+            if(body > REQ_MAX - head){ http_413(r); }
+            else if(head + body > avail){ break; }
+            else {
+                serve(c, &q, (rt_slice){ c->in + off + head, body }, r);
+                off += head + body;
+                rt_http_parser_reset(&c->ps);
+            }
+        }
+        if(r->b.oom){ r->b.len = 0; r->keep = 0; }
+        if(!r->keep) c->closing = 1;
+        c->q_tail++;
+    }
+    if(off){ memmove(c->in, c->in + off, c->in_len - off); c->in_len -= off; }
+}
+
+// Writes queued responses, up to the first pending one, with one sendmsg per round. A
+// streaming /list slot is refilled each time its chunk is out; a file-backed slot sends
+// its headers with the batch and its body with sendfile. Returns 0 when nothing
+// writable is left, 1 when the socket is full, -1 on error.
+static int flush(conn *c){
+    for(;;){
+        if(c->q_head == c->q_tail) return 0;
+        resp *h = &c->q[c->q_head % PIPE_MAX];
+        if(h->pending) return 0;
+        if(h->ls.on && c->q_off == h->b.len){
+            h->b.len = 0; c->q_off = 0;
+            if(list_fill(&c->w->rsc, h)){
+                // Mid-body: no status left to report. Send what is there, then close.
+                h->ls.on = 0; h->keep = 0; c->closing = 1; c->q_tail = c->q_head + 1;
+            }
+        }
+        if(h->f.on && c->q_off == h->b.len){
+            if(h->f.off < h->f.len){
+                COUNT(SC_SENDFILE);
+                ssize_t n = sendfile(c->fd, h->f.fd, &h->f.off, (size_t)(h->f.len - h->f.off));
+                if(n<0){
+                    if(errno==EINTR) continue;
+                    return (errno==EAGAIN || errno==EWOULDBLOCK) ? 1 : -1;
+                }
+                if(n==0) return -1;              // file shorter than the Content-Length sent
+                continue;
+            }
+            resp_reset(h); c->q_off = 0; c->q_head++;
+            continue;
+        }
+        struct iovec iov[PIPE_MAX]; int n = 0;
+        for(unsigned i=c->q_head; i!=c->q_tail && !c->q[i % PIPE_MAX].pending; i++){
+            resp *r = &c->q[i % PIPE_MAX];
+            size_t skip = i==c->q_head ? c->q_off : 0;
+            iov[n].iov_base = r->b.p + skip; iov[n].iov_len = r->b.len - skip; n++;
+            if(r->ls.on || r->f.on) break;   // later responses wait for the whole body
+        }
+        struct msghdr msg = { .msg_iov = iov, .msg_iovlen = (size_t)n };
+        COUNT(SC_SEND);
+        ssize_t wr = sendmsg(c->fd, &msg, MSG_NOSIGNAL);
+        if(wr<0){
+            if(errno==EINTR) continue;
+            return (errno==EAGAIN || errno==EWOULDBLOCK) ? 1 : -1;
+        }
+        size_t left = (size_t)wr;
+        while(c->q_head != c->q_tail && !c->q[c->q_head % PIPE_MAX].pending){
+            resp *r = &c->q[c->q_head % PIPE_MAX];
+            size_t rest = r->b.len - c->q_off;
+            if(left < rest){ c->q_off += left; break; }
+            left -= rest;
+            if(r->ls.on || r->f.on){ c->q_off = r->b.len; break; }
+            c->q_off = 0; r->b.len = 0; c->q_head++;
+        }
+    }
+}
+
+// Drives one connection as far as the socket allows. Edge-triggered: reads and writes
+// continue until EAGAIN, otherwise no further event would arrive. A client that keeps
+// both directions moving (a fast reader of /list streams, a deep pipeline) could hold
+// the loop forever, so after STEP_ROUNDS rounds the connection goes on the ready list
+// and is resumed after the other connections' events.
+static void conn_step(conn *c){
+    idle_touch(c);
+    for(int round=0;;round++){
+        if(round==STEP_ROUNDS){ ready_push(c); return; }
+        parse_requests(c);
+        int rc = flush(c);
+        if(rc<0 || (rc==0 && c->closing && c->q_head==c->q_tail)){ conn_close(c); return; }
+        if(c->closing || queue_full(c)) return;          // resume on EPOLLOUT
+        if(c->writes) return;                            // resume when the batch commits
+        if(c->in_len == REQ_MAX){                        // no room and no complete head
+            resp *r = &c->q[c->q_tail % PIPE_MAX]; resp_reset(r);
+            bump(&M->requests);
+            http_431(r); c->closing = 1; c->q_tail++; continue;
+        }
+        COUNT(SC_READ);
+        ssize_t n = read(c->fd, c->in + c->in_len, REQ_MAX - c->in_len);
+        if(n>0){ c->in_len += (size_t)n; continue; }
+        if(n==0){ c->closing = 1; continue; }            // peer done: answer what it sent
+        if(errno==EINTR) continue;
+        if(errno==EAGAIN || errno==EWOULDBLOCK) return;
+        conn_close(c); return;
+    }
+}
+
+// Fills the responses of committed writes and built exports and resumes their
+// connections.
+static void complete_writes(worker *w){
+    atomic_store(&w->notified,0);    // before draining: a later push signals again
+    efd_drain(w->efd);
+    mpsc_node *n;
+    while((n = mpsc_pop(&w->done))){
+        wop *op = (wop*)n;
+        conn *c = op->c;
+        resp *r = op->r;
+        c->writes--;
+        if(c->dead){                                            // op is in a slot arena
+            if(op->kind==OP_EXPORT && op->ok){ COUNT(SC_CLOSE); close(op->fd); }
+            if(!c->writes) conn_free(c);
+            continue;
+        }
+        r->pending = 0;
+        if(!op->ok) http_500(r);
+        else if(op->kind==OP_EXPORT) export_resp(r, op->fd, op->size);
+        else if(op->kind==OP_ADD){
+            rt_jbuf *body = &w->scratch; body->len = 0;
+            RT_JBUF_LIT(body,"{\"status\":\"ok\",\"id\":"); rt_json_int(body,op->rowid); RT_JBUF_LIT(body,"}");
+            json_head(r,body->len); conn_hdr(r); rt_jbuf_put(&r->b,body->p,body->len);
+            if(body->oom){ rt_jbuf_free(body); r->b.oom = 1; }
+        }
+        else http_static(r, op->kind==OP_PURGE ? ST_OK_PURGE : ST_OK);
+        if(r->b.oom){ r->b.len = 0; r->keep = 0; c->closing = 1; }
+        conn_step(c);
+    }
+}
+
+static void close_idle(worker *w){
+    while(w->idle_head && w->now_ms - w->idle_head->last_ms >= IDLE_MS) conn_close(w->idle_head);
+}
+
+static void accept_all(worker *w){
+    for(;;){
+        COUNT(SC_ACCEPT);
+        int cfd = accept4(w->lfd, NULL, NULL, SOCK_NONBLOCK|SOCK_CLOEXEC);
+        if(cfd<0){
+            if(errno==EINTR || errno==ECONNABORTED) continue;
+            if(errno!=EAGAIN && errno!=EWOULDBLOCK) perror("accept4");   // e.g. EMFILE: retry on next event
+            return;
+        }
+        int one=1; COUNT(SC_SETSOCKOPT); setsockopt(cfd,IPPROTO_TCP,TCP_NODELAY,&one,sizeof(one));
+        conn *c = calloc(1,sizeof(conn));
+        if(!c){ COUNT(SC_CLOSE); close(cfd); continue; }
+        c->fd=cfd; c->w=w;
+        struct epoll_event ev = { .events = EPOLLIN|EPOLLOUT|EPOLLRDHUP|EPOLLET, .data.ptr = c };
+        COUNT(SC_EPOLL_CTL);
+        if(epoll_ctl(w->ep, EPOLL_CTL_ADD, cfd, &ev)<0){ conn_close(c); continue; }
+        conn_step(c);   // data often arrives with the handshake
+    }
+}
+
+static char WAKE_TAG;   // epoll data.ptr of a loop's eventfd (the listener's is NULL)
+
+static void *worker_loop(void *arg){
+    worker *w = arg;
+    struct epoll_event evs[MAX_EVENTS];
+    M = &w->m;
+    for(;;){
+        COUNT(SC_EPOLL_WAIT);
+        int n = epoll_wait(w->ep, evs, MAX_EVENTS, w->ready_head ? 0 : 1000);
+        if(n<0){ if(errno==EINTR) continue; die("epoll_wait"); }
+        w->now_ms = mono_ms();
+        int woken = 0;
+        for(int i=0;i<n;i++){
+            conn *c = evs[i].data.ptr;
+            if(!c){ accept_all(w); continue; }
+            if(evs[i].data.ptr==&WAKE_TAG){ woken = 1; continue; }
+            if(evs[i].events & EPOLLERR){ conn_close(c); continue; }
+            conn_step(c);
+        }
+        // After the batch: completing a write may free a connection that still has an
+        // entry in evs.
+        if(woken) complete_writes(w);
+        // One more turn for each connection that yielded; those that yield again are
+        // queued for the next pass.
+        conn *rc = w->ready_head;
+        w->ready_head = w->ready_tail = NULL;
+        while(rc){
+            conn *next = rc->rnext;
+            rc->ready = 0; rc->rprev = rc->rnext = NULL;
+            conn_step(rc);
+            rc = next;
+        }
+        close_idle(w);
+    }
+    return NULL;
+}
+
+static int open_listener(void){
+    int sfd = socket(AF_INET, SOCK_STREAM|SOCK_NONBLOCK|SOCK_CLOEXEC, 0); if(sfd<0) die("socket");
+    int opt=1;
+    setsockopt(sfd,SOL_SOCKET,SO_REUSEADDR,&opt,sizeof(opt));
+    if(setsockopt(sfd,SOL_SOCKET,SO_REUSEPORT,&opt,sizeof(opt))<0) die("SO_REUSEPORT");
     struct sockaddr_in addr; memset(&addr,0,sizeof(addr));
-    addr.sin_family=AF_INET; addr.sin_addr.s_addr=htonl(INADDR_ANY); addr.sin_port=htons(8080);
+    addr.sin_family=AF_INET; addr.sin_addr.s_addr=htonl(INADDR_ANY); addr.sin_port=htons(PORT);
     if(bind(sfd,(struct sockaddr*)&addr,sizeof(addr))<0) die("bind");
-    if(listen(sfd,64)<0) die("listen");
-    printf("HTTP server listening on http://127.0.0.1:8080\n");
-    for(;;){
-        int cfd = accept(sfd,NULL,NULL);
-        if(cfd<0){ if(errno==EINTR) continue; die("accept"); }
-        serve(cfd);
+    if(listen(sfd,SOMAXCONN)<0) die("listen");
+    return sfd;
+}
+
+int main(void){
+    signal(SIGPIPE, SIG_IGN);   // sends use MSG_NOSIGNAL; sendfile has no such flag
+    build_static();
+
+    long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+    const char *env = getenv("HTTP_WORKERS");
+    int nw = env && atoi(env)>0 ? atoi(env) : (ncpu>0 ? (int)ncpu : 1);
+    if((env = getenv("COMMIT_MAX")) && atoi(env)>0) commit_max = atoi(env);
+    if((env = getenv("COMMIT_US")) && atoll(env)>=0) commit_us = atoll(env);
+    worker *ws = calloc((size_t)nw, sizeof(worker)); if(!ws) die("calloc");
+    WS = ws; NW = nw;
+    if(open_db(nw+1)!=0){ fprintf(stderr,"cannot open %s\n", DB_PATH); return 1; }
+    for(int i=0;i<nw;i++){
+        ws[i].id=i;
+        ws[i].rdb=rt_db_pool_acquire(&POOL);
+        if(rt_stmt_cache_init(&ws[i].rsc,ws[i].rdb,READ_SQL,RD_COUNT)!=0){ fprintf(stderr,"cannot prepare reads\n"); return 1; }
+        ws[i].lfd=open_listener();
+        ws[i].ep=epoll_create1(EPOLL_CLOEXEC); if(ws[i].ep<0) die("epoll_create1");
+        struct epoll_event ev = { .events = EPOLLIN|EPOLLET, .data.ptr = NULL };
+        if(epoll_ctl(ws[i].ep, EPOLL_CTL_ADD, ws[i].lfd, &ev)<0) die("epoll_ctl");
+        mpsc_init(&ws[i].done);
+        ws[i].efd=eventfd(0,EFD_NONBLOCK|EFD_CLOEXEC); if(ws[i].efd<0) die("eventfd");
+        struct epoll_event wev = { .events = EPOLLIN, .data.ptr = &WAKE_TAG };
+        if(epoll_ctl(ws[i].ep, EPOLL_CTL_ADD, ws[i].efd, &wev)<0) die("epoll_ctl");
     }
+    mpsc_init(&WQ);
+    wq_efd=eventfd(0,EFD_NONBLOCK|EFD_CLOEXEC); if(wq_efd<0) die("eventfd");
+    if(rt_stmt_cache_init(&EXPORT_SC,rt_db_pool_acquire(&POOL),READ_SQL,RD_COUNT)!=0){ fprintf(stderr,"cannot prepare reads\n"); return 1; }
+    pthread_t wtid, etid;
+    if(pthread_create(&wtid,NULL,writer_loop,NULL)!=0) die("pthread_create");
+    if(pthread_create(&etid,NULL,export_loop,NULL)!=0) die("pthread_create");
+    printf("HTTP server listening on http://127.0.0.1:%d (%d event loops, group commit %d writes / %lld us)\n",
+           PORT, nw, commit_max, commit_us);
+    fflush(stdout);
+    for(int i=1;i<nw;i++){
+        if(pthread_create(&ws[i].tid,NULL,worker_loop,&ws[i])!=0) die("pthread_create");
+    }
+    worker_loop(&ws[0]);
     return 0;
-}
\ No newline at end of file
+}
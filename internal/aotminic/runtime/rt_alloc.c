@@ -0,0 +1,305 @@
+// rt_alloc.c
+// Size classes, thread heaps and their slab chains, remote frees, the slab pool and
+// large blocks.
+
+#define _GNU_SOURCE
+#include "rt_alloc.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#define NCLS        40
+#define HDR         128            // slab / large block header; blocks start after it
+#define REGION      (8u << 20)     // the slab pool grows by this much at a time
+#define LARGE_CACHE 4              // freed large blocks kept per heap
+#define CACHE_BYTES (64u << 20)    // ... holding at most this much
+
+enum { K_SMALL = 0x5a1b, K_LARGE = 0x1a23 };
+
+typedef struct node { struct node *next; } node;
+
+struct heap;
+
+typedef struct slab {
+    // Owner thread only.
+    unsigned     kind, cls;
+    struct heap *owner;
+    struct slab *prev, *next;      // owner's chain for cls; the head is allocated from
+    node        *free;
+    char        *bump, *end;       // never-allocated tail
+    unsigned     used;             // blocks out (remote frees count until taken over)
+    unsigned     size;             // class size
+    // Pushed to by other threads; on its own cache line.
+    _Alignas(64) _Atomic(node *) remote;
+} slab;
+
+typedef struct {
+    unsigned kind;
+    size_t   mapped;               // mapping length, header included
+} large;
+
+_Static_assert(sizeof(slab) <= HDR && sizeof(large) <= HDR, "header too large");
+
+typedef struct heap {
+    slab        *chain[NCLS];
+    struct { char *base; size_t mapped; } cache[LARGE_CACHE];
+    size_t       cached;           // bytes held in cache
+    unsigned     evict;            // next cache slot to replace
+    struct heap *parked_next;
+} heap;
+
+static _Thread_local heap *H;      // the calling thread's heap (NULL until it allocates)
+static pthread_key_t       heap_key;
+static pthread_once_t      heap_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t     pool_mu = PTHREAD_MUTEX_INITIALIZER;
+static slab               *pool;   // empty slabs, linked through next
+static heap               *parked; // heaps of exited threads
+
+// ---- size classes ----
+
+static inline unsigned size_class(size_t n) {
+    if (n <= 128) return n ? (unsigned)((n + 15) >> 4) - 1 : 0;
+    size_t m = n - 1;
+    unsigned k = 63u - (unsigned)__builtin_clzll(m);
+    return 8 + (k - 7) * 4 + (unsigned)((m >> (k - 2)) & 3);
+}
+
+static unsigned class_size(unsigned c) {
+    if (c < 8) return (c + 1) * 16;
+    unsigned k = 7 + (c - 8) / 4, sub = (c - 8) % 4;
+    return (5 + sub) << (k - 2);
+}
+
+// ---- pages ----
+
+// size bytes aligned to align (a power of two, at least a page).
+static char *map_aligned(size_t size, size_t align) {
+    size_t span = size + align;
+    char *p = mmap(NULL, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) return NULL;
+    char *a = (char *)(((uintptr_t)p + align - 1) & ~(uintptr_t)(align - 1));
+    if (a > p) munmap(p, (size_t)(a - p));
+    if (a + size < p + span) munmap(a + size, (size_t)(p + span - (a + size)));
+    return a;
+}
+
+static slab *pool_take(void) {
+    pthread_mutex_lock(&pool_mu);
+    if (!pool) {
+        char *r = map_aligned(REGION, RT_ALLOC_HUGE);
+        for (size_t off = REGION; r && off; off -= RT_ALLOC_SLAB) {
+            slab *s = (slab *)(r + off - RT_ALLOC_SLAB);
+            s->next = pool; pool = s;
+        }
+    }
+    slab *s = pool;
+    if (s) pool = s->next;
+    pthread_mutex_unlock(&pool_mu);
+    return s;
+}
+
+static void pool_put(slab *s) {
+    pthread_mutex_lock(&pool_mu);
+    s->next = pool; pool = s;
+    pthread_mutex_unlock(&pool_mu);
+}
+
+// ---- heaps ----
+
+static void heap_park(void *arg) {
+    heap *h = arg;
+    H = NULL;                      // frees from later destructors go the remote way
+    pthread_mutex_lock(&pool_mu);
+    h->parked_next = parked; parked = h;
+    pthread_mutex_unlock(&pool_mu);
+}
+
+static void make_key(void) { pthread_key_create(&heap_key, heap_park); }
+
+static heap *heap_get(void) {
+    pthread_once(&heap_once, make_key);
+    pthread_mutex_lock(&pool_mu);
+    heap *h = parked;
+    if (h) parked = h->parked_next;
+    pthread_mutex_unlock(&pool_mu);
+    if (!h) {
+        void *p = mmap(NULL, sizeof(heap), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) return NULL;
+        h = p;
+    }
+    pthread_setspecific(heap_key, h);
+    return H = h;
+}
+
+// ---- small blocks ----
+
+static inline void *pop(slab *s) {
+    node *b = s->free;
+    s->free = b->next; s->used++;
+    return b;
+}
+
+// Takes over the blocks other threads freed into s. Returns 0 if there were none.
+static int collect(slab *s) {
+    if (!atomic_load_explicit(&s->remote, memory_order_relaxed)) return 0;
+    node *r = atomic_exchange_explicit(&s->remote, NULL, memory_order_acquire), *t = r;
+    unsigned n = 1;
+    while (t->next) { t = t->next; n++; }
+    t->next = s->free; s->free = r; s->used -= n;
+    return 1;
+}
+
+static void chain_unlink(heap *h, slab *s) {
+    if (s->prev) s->prev->next = s->next; else h->chain[s->cls] = s->next;
+    if (s->next) s->next->prev = s->prev;
+}
+
+static void chain_push(heap *h, slab *s) {
+    s->prev = NULL; s->next = h->chain[s->cls];
+    if (s->next) s->next->prev = s;
+    h->chain[s->cls] = s;
+}
+
+static void *small_slow(heap *h, unsigned c) {
+    slab *s = h->chain[c];
+    if (s) {
+        if (s->bump < s->end) { void *p = s->bump; s->bump += s->size; s->used++; return p; }
+        if (collect(s)) return pop(s);
+        // Slabs behind the head have no untouched tail left; look for freed blocks.
+        for (slab *t = s->next; t; t = t->next) {
+            if (t->free || collect(t)) { chain_unlink(h, t); chain_push(h, t); return pop(t); }
+        }
+    }
+    if (!(s = pool_take())) return NULL;
+    s->kind = K_SMALL; s->cls = c; s->owner = h; s->size = class_size(c);
+    s->free = NULL; s->used = 1;
+    s->bump = (char *)s + HDR;
+    s->end = s->bump + (RT_ALLOC_SLAB - HDR) / s->size * s->size;
+    atomic_store_explicit(&s->remote, NULL, memory_order_relaxed);
+    chain_push(h, s);
+    void *p = s->bump; s->bump += s->size;
+    return p;
+}
+
+// ---- large blocks ----
+
+static void *large_alloc(heap *h, size_t n, int zero) {
+    size_t need = HDR + n;
+    if (need < n) return NULL;
+    int huge = need >= RT_ALLOC_HUGE;
+    size_t gran = huge ? RT_ALLOC_HUGE : 4096, mapped = (need + gran - 1) & ~(gran - 1);
+    for (unsigned i = 0; i < LARGE_CACHE; i++) {
+        char *b = h->cache[i].base;
+        if (b && h->cache[i].mapped >= mapped && h->cache[i].mapped / 2 <= mapped) {
+            h->cached -= h->cache[i].mapped;
+            h->cache[i].base = NULL;
+            if (zero) memset(b + HDR, 0, n);
+            return b + HDR;
+        }
+    }
+    char *b = map_aligned(mapped, huge ? RT_ALLOC_HUGE : RT_ALLOC_SLAB);
+    if (!b) return NULL;
+    if (huge) madvise(b, mapped, MADV_HUGEPAGE);
+    large *l = (large *)b;
+    l->kind = K_LARGE; l->mapped = mapped;
+    return b + HDR;
+}
+
+static void large_free(large *l) {
+    heap *h = H;
+    size_t mapped = l->mapped;
+    if (h && mapped <= CACHE_BYTES) {
+        unsigned i = h->evict++ % LARGE_CACHE;
+        char *old = h->cache[i].base;
+        if (old) { munmap(old, h->cache[i].mapped); h->cached -= h->cache[i].mapped; }
+        h->cache[i].base = (char *)l; h->cache[i].mapped = mapped; h->cached += mapped;
+        // Over budget: drop the others, oldest first.
+        for (unsigned k = 1; k < LARGE_CACHE && h->cached > CACHE_BYTES; k++) {
+            unsigned j = (i + k) % LARGE_CACHE;
+            if (!h->cache[j].base) continue;
+            munmap(h->cache[j].base, h->cache[j].mapped);
+            h->cached -= h->cache[j].mapped; h->cache[j].base = NULL;
+        }
+        return;
+    }
+    munmap(l, mapped);
+}
+
+// ---- API ----
+
+static inline slab *slab_of(const void *p) {
+    return (slab *)((uintptr_t)p & ~(uintptr_t)(RT_ALLOC_SLAB - 1));
+}
+
+void *rt_alloc(size_t n) {
+    heap *h = H;
+    if (!h && !(h = heap_get())) return NULL;
+    if (n > RT_ALLOC_SMALL_MAX) return large_alloc(h, n, 0);
+    unsigned c = size_class(n);
+    slab *s = h->chain[c];
+    if (s && s->free) return pop(s);
+    return small_slow(h, c);
+}
+
+void *rt_alloc_aligned(size_t n, size_t align) {
+    if (align <= 16) return rt_alloc(n);
+    if (align > 64 || (align & (align - 1))) return NULL;
+    heap *h = H;
+    if (!h && !(h = heap_get())) return NULL;
+    // Large blocks start HDR bytes into a page. Blocks of a class start at HDR + k * size
+    // in an aligned slab: use the first class whose size is a multiple of align.
+    if (n > RT_ALLOC_SMALL_MAX) return large_alloc(h, n, 0);
+    unsigned c = size_class(n < align ? align : n);
+    while (c < NCLS && class_size(c) % align) c++;
+    if (c >= NCLS) return large_alloc(h, n, 0);
+    slab *s = h->chain[c];
+    if (s && s->free) return pop(s);
+    return small_slow(h, c);
+}
+
+void rt_free(void *p) {
+    if (!p) return;
+    slab *s = slab_of(p);
+    if (s->kind == K_LARGE) { large_free((large *)s); return; }
+    node *b = p;
+    heap *h = H;
+    if (s->owner == h) {
+        b->next = s->free; s->free = b;
+        if (--s->used == 0 && h->chain[s->cls] != s) { chain_unlink(h, s); pool_put(s); }
+        return;
+    }
+    node *old = atomic_load_explicit(&s->remote, memory_order_relaxed);
+    do b->next = old;
+    while (!atomic_compare_exchange_weak_explicit(&s->remote, &old, b, memory_order_release, memory_order_relaxed));
+}
+
+size_t rt_alloc_usable(const void *p) {
+    slab *s = slab_of(p);
+    return s->kind == K_LARGE ? ((large *)s)->mapped - HDR : s->size;
+}
+
+void *rt_calloc(size_t count, size_t size) {
+    size_t n;
+    if (__builtin_mul_overflow(count, size, &n)) return NULL;
+    if (n > RT_ALLOC_SMALL_MAX) {
+        heap *h = H;
+        if (!h && !(h = heap_get())) return NULL;
+        return large_alloc(h, n, 1);   // fresh mappings are already zero
+    }
+    void *p = rt_alloc(n);
+    if (p) memset(p, 0, n);
+    return p;
+}
+
+void *rt_realloc(void *p, size_t n) {
+    if (!p) return rt_alloc(n);
+    size_t have = rt_alloc_usable(p);
+    if (n <= have && (n >= have / 2 || have <= 16)) return p;
+    void *q = rt_alloc(n);
+    if (!q) return NULL;
+    memcpy(q, p, n < have ? n : have);
+    rt_free(p);
+    return q;
+}
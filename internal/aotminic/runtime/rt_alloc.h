@@ -0,0 +1,42 @@
+// rt_alloc.h
+// General-purpose allocator for Tenge AOT-generated C: per-thread slab caches for small
+// sizes, remote free lists for cross-thread frees, huge-page-backed large blocks.
+//
+// Small requests (up to RT_ALLOC_SMALL_MAX) are rounded to one of 40 size classes
+// (16-byte steps to 128, then four classes per power of two). Every thread owns a heap
+// with a chain of slabs per class; a slab is an RT_ALLOC_SLAB-aligned block whose
+// header records its class and owning heap, so rt_free finds it by masking the pointer.
+// Allocation pops the slab's free list or bumps into its untouched tail, without locks
+// or atomics. A free from the owning thread pushes onto that list; a free from any other
+// thread pushes onto the slab's remote list (one CAS), which the owner takes over in a
+// single exchange when it runs short. Empty slabs go back to a process-wide pool, carved
+// from huge-page-aligned regions. A thread's heap outlives it: at thread exit it is
+// parked and adopted, slabs and all, by the next thread that allocates.
+// Large requests are mmap'd (2 MiB-aligned and MADV_HUGEPAGE from RT_ALLOC_HUGE up) and
+// a few recently freed ones are kept per thread for reuse.
+// Small blocks are 16-byte aligned, large blocks 64-byte aligned; rt_alloc_aligned gives
+// 32- or 64-byte alignment at any size.
+
+#pragma once
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RT_ALLOC_SMALL_MAX (32u << 10)
+#define RT_ALLOC_SLAB      (256u << 10)
+#define RT_ALLOC_HUGE      (2u << 20)
+
+void *rt_alloc(size_t n);
+// align: a power of two up to 64 (NULL otherwise).
+void *rt_alloc_aligned(size_t n, size_t align);
+void *rt_calloc(size_t count, size_t size);
+void *rt_realloc(void *p, size_t n);
+void  rt_free(void *p);
+// Bytes usable at p (at least the size requested).
+size_t rt_alloc_usable(const void *p);
+
+#ifdef __cplusplus
+}
+#endif
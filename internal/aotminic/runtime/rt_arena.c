@@ -0,0 +1,95 @@
+// rt_arena.c
+// Chunked bump arena: chunk chain growth, mmap-backed large chunks, reset and free.
+
+#define _DEFAULT_SOURCE
+#include "rt_arena.h"
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static size_t page_size(void) {
+    static size_t ps;
+    if (!ps) { long v = sysconf(_SC_PAGESIZE); ps = v > 0 ? (size_t)v : 4096; }
+    return ps;
+}
+
+static inline char *chunk_data(rt_arena_chunk *c) { return (char *)(c + 1); }
+
+// New chunk with at least `need` usable bytes, appended after tail (NULL: first chunk).
+static rt_arena_chunk *chunk_new(rt_arena *a, rt_arena_chunk *tail, size_t need) {
+    size_t size = tail ? tail->size * 2 : a->first;
+    if (tail && size > RT_ARENA_MAX_GROW) size = tail->size > RT_ARENA_MAX_GROW ? tail->size : RT_ARENA_MAX_GROW;
+    if (size < need) size = need;
+    size_t total = sizeof(rt_arena_chunk) + size;
+    if (total < size) return NULL;
+
+    rt_arena_chunk *c;
+    size_t mapped = 0;
+    if (total >= RT_ARENA_MMAP_MIN) {
+        size_t ps = page_size();
+        mapped = (total + ps - 1) & ~(ps - 1);
+        if (mapped < total) return NULL;
+        void *p = mmap(NULL, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (p == MAP_FAILED) return NULL;
+        c = p;
+        size = mapped - sizeof(rt_arena_chunk);
+    } else {
+        c = malloc(total);
+        if (!c) return NULL;
+    }
+    c->next = NULL; c->size = size; c->mapped = mapped;
+    if (tail) tail->next = c; else a->head = c;
+    a->reserved += mapped ? mapped : total;
+    return c;
+}
+
+void rt_arena_init(rt_arena *a, size_t first) {
+    memset(a, 0, sizeof(*a));
+    a->first = first ? first : RT_ARENA_MIN_CHUNK;
+}
+
+void *rt_arena_alloc_slow(rt_arena *a, size_t n, size_t align) {
+    size_t need = n + align - 1;
+    if (need < n) return NULL;
+    if (!a->first) a->first = RT_ARENA_MIN_CHUNK;   // zero-initialised arena
+    // Chunks after the current one are free (left by a rewind); ones too small for this
+    // request are skipped and come back on the next rewind past them.
+    rt_arena_chunk *c = a->cur ? a->cur->next : a->head, *tail = a->cur;
+    while (c && c->size < need) { tail = c; c = c->next; }
+    if (!c) {
+        while (tail && tail->next) tail = tail->next;
+        if (!(c = chunk_new(a, tail, need))) return NULL;
+    }
+    a->cur = c; a->ptr = chunk_data(c); a->end = a->ptr + c->size;
+    uintptr_t p = ((uintptr_t)a->ptr + (align - 1)) & ~(uintptr_t)(align - 1);
+    a->ptr = (char *)p + n;
+    return (void *)p;
+}
+
+void rt_arena_reset(rt_arena *a) {
+    rt_arena_rewind(a, (rt_arena_pos){ NULL, NULL });
+    size_t ps = page_size();
+    for (rt_arena_chunk *c = a->head; c; c = c->next) {
+        // The first page holds the header; only whole pages after it are dropped.
+        if (c->mapped > ps) madvise((char *)c + ps, c->mapped - ps, MADV_DONTNEED);
+    }
+}
+
+void rt_arena_free(rt_arena *a) {
+    rt_arena_chunk *c = a->head;
+    while (c) {
+        rt_arena_chunk *next = c->next;
+        if (c->mapped) munmap(c, c->mapped); else free(c);
+        c = next;
+    }
+    rt_arena_init(a, a->first);
+}
+
+char *rt_arena_strndup(rt_arena *a, const char *s, size_t n) {
+    char *d = rt_arena_alloc(a, n + 1, 1);
+    if (!d) return NULL;
+    memcpy(d, s, n);
+    d[n] = '\0';
+    return d;
+}
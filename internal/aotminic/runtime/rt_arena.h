@@ -0,0 +1,80 @@
+// rt_arena.h
+// Growable chunked bump arena for Tenge AOT-generated C (and std/mem/arena.tng).
+//
+// Allocations bump a pointer through the current chunk. When it is full the arena moves
+// on to the next chunk of its chain, allocating one twice the size of the last (or large
+// enough for the request) only when the chain has no room left, so an arena never fails
+// for lack of an up-front size. Chunks of RT_ARENA_MMAP_MIN bytes or more are mmap'd.
+//
+// rt_arena_mark / rt_arena_rewind scope allocations: everything allocated after a mark
+// is released at once by rewinding to it, and the chunks stay chained for reuse, so a
+// request-shaped workload settles at zero malloc calls. rt_arena_reset rewinds to the
+// start and also hands the pages of mmap'd chunks back to the kernel (MADV_DONTNEED)
+// while keeping their address space.
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RT_ARENA_MIN_CHUNK 1024          // smallest chunk (bytes usable)
+#define RT_ARENA_MAX_GROW  (64u << 20)   // chunks stop doubling at this size
+#define RT_ARENA_MMAP_MIN  (256u << 10)  // chunks at least this large are mmap'd
+
+typedef struct rt_arena_chunk {
+    struct rt_arena_chunk *next;
+    size_t                 size;     // usable bytes after the header
+    size_t                 mapped;   // mapping length if mmap'd, else 0
+} rt_arena_chunk;
+
+typedef struct {
+    rt_arena_chunk *head;       // first chunk (NULL until the first allocation)
+    rt_arena_chunk *cur;        // chunk being bumped
+    char           *ptr, *end;  // free bytes of cur
+    size_t          first;      // size of the first chunk
+    size_t          reserved;   // bytes held in chunks (headers included)
+} rt_arena;
+
+// Position to rewind to; {NULL, NULL} is the start of the arena.
+typedef struct { rt_arena_chunk *chunk; char *ptr; } rt_arena_pos;
+
+// first: size of the first chunk, allocated lazily (0 picks RT_ARENA_MIN_CHUNK).
+void  rt_arena_init(rt_arena *a, size_t first);
+// Releases every chunk; the arena can be reused afterwards.
+void  rt_arena_free(rt_arena *a);
+// Rewinds to the start; mmap'd chunks give their pages back to the kernel.
+void  rt_arena_reset(rt_arena *a);
+
+void *rt_arena_alloc_slow(rt_arena *a, size_t n, size_t align);
+
+// n bytes aligned to align (a power of two, at most 4096). NULL only if the system is
+// out of memory.
+static inline void *rt_arena_alloc(rt_arena *a, size_t n, size_t align) {
+    uintptr_t p = ((uintptr_t)a->ptr + (align - 1)) & ~(uintptr_t)(align - 1);
+    if (a->ptr && p <= (uintptr_t)a->end && n <= (uintptr_t)a->end - p) {
+        a->ptr = (char *)p + n;
+        return (void *)p;
+    }
+    return rt_arena_alloc_slow(a, n, align);
+}
+
+static inline rt_arena_pos rt_arena_mark(const rt_arena *a) {
+    return (rt_arena_pos){ a->cur, a->ptr };
+}
+
+// Frees everything allocated since p was taken. Chunks are kept for reuse.
+static inline void rt_arena_rewind(rt_arena *a, rt_arena_pos p) {
+    if (!p.chunk) p = (rt_arena_pos){ a->head, a->head ? (char *)(a->head + 1) : NULL };
+    a->cur = p.chunk; a->ptr = p.ptr;
+    a->end = p.chunk ? (char *)(p.chunk + 1) + p.chunk->size : NULL;
+}
+
+// Copy of s[0 .. n-1] plus a NUL, or NULL on OOM.
+char *rt_arena_strndup(rt_arena *a, const char *s, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
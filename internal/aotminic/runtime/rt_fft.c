@@ -0,0 +1,233 @@
+// rt_fft.c
+// Iterative in-place radix-2/4 FFT with cached twiddle tables.
+//
+// Twiddle layout: tw[m + j] = exp(-i*pi*j/m) for m = 1, 2, 4, ..., n/2 and j < m,
+// i.e. stage m reads a contiguous run of m factors. The table for size n is a
+// prefix of the table for any larger size, so one cached table serves every
+// smaller transform.
+
+#include "rt_fft.h"
+#include "rt_alloc.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#endif
+
+typedef struct {
+    double *re;
+    double *im;
+} rt_fft_table;
+
+static rt_fft_table    g_tables[RT_FFT_MAX_LOG2 + 1];
+static pthread_mutex_t g_tables_mu = PTHREAD_MUTEX_INITIALIZER;
+
+static int log2_exact(size_t n) {
+    if (n == 0 || (n & (n - 1)) != 0) return -1;
+    int l = 0;
+    while (((size_t)1 << l) < n) l++;
+    return l <= RT_FFT_MAX_LOG2 ? l : -1;
+}
+
+// Returns a table valid for 2^lg points, building it on first use.
+static const rt_fft_table *table_for(int lg) {
+    for (int l = lg; l <= RT_FFT_MAX_LOG2; l++) {
+        if (__atomic_load_n(&g_tables[l].im, __ATOMIC_ACQUIRE)) return &g_tables[l];
+    }
+    pthread_mutex_lock(&g_tables_mu);
+    rt_fft_table *t = &g_tables[lg];
+    if (!t->im) {
+        size_t n = (size_t)1 << lg, half = n >> 1;
+        double *re = rt_alloc_aligned(n * sizeof(double), 64);
+        double *im = rt_alloc_aligned(n * sizeof(double), 64);
+        if (!re || !im) {
+            rt_free(re); rt_free(im);
+            pthread_mutex_unlock(&g_tables_mu);
+            return NULL;
+        }
+        re[0] = 1.0; im[0] = 0.0;
+        // Top stage directly from libm, lower stages by decimation: w_{2m}^j == w_n^{j*(n/2m)}.
+        for (size_t j = 0; j < half; j++) {
+            double a = -M_PI * (double)j / (double)half;
+            re[half + j] = cos(a);
+            im[half + j] = sin(a);
+        }
+        for (size_t m = half >> 1; m >= 1; m >>= 1) {
+            size_t stride = half / m;
+            for (size_t j = 0; j < m; j++) {
+                re[m + j] = re[half + j * stride];
+                im[m + j] = im[half + j * stride];
+            }
+        }
+        t->re = re;
+        __atomic_store_n(&t->im, im, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&g_tables_mu);
+    return t;
+}
+
+static void bit_reverse(double *re, double *im, size_t n) {
+    for (size_t i = 0, j = 0; i < n; i++) {
+        if (i < j) {
+            double tr = re[i]; re[i] = re[j]; re[j] = tr;
+            double ti = im[i]; im[i] = im[j]; im[j] = ti;
+        }
+        size_t bit = n >> 1;
+        while (j & bit) { j ^= bit; bit >>= 1; }
+        j |= bit;
+    }
+}
+
+static void pass_radix2(double *restrict re, double *restrict im, size_t n) {
+    for (size_t k = 0; k < n; k += 2) {
+        double ar = re[k], ai = im[k], br = re[k + 1], bi = im[k + 1];
+        re[k] = ar + br;     im[k] = ai + bi;
+        re[k + 1] = ar - br; im[k + 1] = ai - bi;
+    }
+}
+
+// Scalar radix-4 butterfly: stages m and 2m fused over x[j], x[j+m], x[j+2m], x[j+3m].
+static inline void bfly4(double *restrict re, double *restrict im, size_t j, size_t m,
+                         double w1r, double w1i, double w2r, double w2i) {
+    double a0r = re[j],         a0i = im[j];
+    double a1r = re[j + m],     a1i = im[j + m];
+    double a2r = re[j + 2 * m], a2i = im[j + 2 * m];
+    double a3r = re[j + 3 * m], a3i = im[j + 3 * m];
+
+    double tr = w1r * a1r - w1i * a1i, ti = w1r * a1i + w1i * a1r;
+    double b0r = a0r + tr, b0i = a0i + ti, b1r = a0r - tr, b1i = a0i - ti;
+    tr = w1r * a3r - w1i * a3i; ti = w1r * a3i + w1i * a3r;
+    double b2r = a2r + tr, b2i = a2i + ti, b3r = a2r - tr, b3i = a2i - ti;
+
+    tr = w2r * b2r - w2i * b2i; ti = w2r * b2i + w2i * b2r;
+    re[j] = b0r + tr;         im[j] = b0i + ti;
+    re[j + 2 * m] = b0r - tr; im[j + 2 * m] = b0i - ti;
+    // w_{4m}^{j+m} == -i * w_{4m}^j
+    double ur = w2r * b3r - w2i * b3i, ui = w2r * b3i + w2i * b3r;
+    re[j + m] = b1r + ui;     im[j + m] = b1i - ur;
+    re[j + 3 * m] = b1r - ui; im[j + 3 * m] = b1i + ur;
+}
+
+#if defined(__AVX2__) && defined(__FMA__)
+static inline void cmul4(__m256d ar, __m256d ai, __m256d br, __m256d bi,
+                         __m256d *cr, __m256d *ci) {
+    *cr = _mm256_fmsub_pd(ar, br, _mm256_mul_pd(ai, bi));
+    *ci = _mm256_fmadd_pd(ar, bi, _mm256_mul_pd(ai, br));
+}
+
+// Four radix-4 butterflies (j .. j+3) per iteration; requires m % 4 == 0.
+static void pass_radix4_simd(double *restrict re, double *restrict im, size_t n, size_t m,
+                             const double *restrict twr, const double *restrict twi) {
+    for (size_t k = 0; k < n; k += 4 * m) {
+        double *r0 = re + k, *i0 = im + k;
+        for (size_t j = 0; j < m; j += 4) {
+            __m256d w1r = _mm256_load_pd(twr + m + j),     w1i = _mm256_load_pd(twi + m + j);
+            __m256d w2r = _mm256_load_pd(twr + 2 * m + j), w2i = _mm256_load_pd(twi + 2 * m + j);
+            __m256d a0r = _mm256_loadu_pd(r0 + j),         a0i = _mm256_loadu_pd(i0 + j);
+            __m256d a1r = _mm256_loadu_pd(r0 + j + m),     a1i = _mm256_loadu_pd(i0 + j + m);
+            __m256d a2r = _mm256_loadu_pd(r0 + j + 2 * m), a2i = _mm256_loadu_pd(i0 + j + 2 * m);
+            __m256d a3r = _mm256_loadu_pd(r0 + j + 3 * m), a3i = _mm256_loadu_pd(i0 + j + 3 * m);
+            __m256d tr, ti;
+
+            cmul4(w1r, w1i, a1r, a1i, &tr, &ti);
+            __m256d b0r = _mm256_add_pd(a0r, tr), b0i = _mm256_add_pd(a0i, ti);
+            __m256d b1r = _mm256_sub_pd(a0r, tr), b1i = _mm256_sub_pd(a0i, ti);
+            cmul4(w1r, w1i, a3r, a3i, &tr, &ti);
+            __m256d b2r = _mm256_add_pd(a2r, tr), b2i = _mm256_add_pd(a2i, ti);
+            __m256d b3r = _mm256_sub_pd(a2r, tr), b3i = _mm256_sub_pd(a2i, ti);
+
+            cmul4(w2r, w2i, b2r, b2i, &tr, &ti);
+            _mm256_storeu_pd(r0 + j,         _mm256_add_pd(b0r, tr));
+            _mm256_storeu_pd(i0 + j,         _mm256_add_pd(b0i, ti));
+            _mm256_storeu_pd(r0 + j + 2 * m, _mm256_sub_pd(b0r, tr));
+            _mm256_storeu_pd(i0 + j + 2 * m, _mm256_sub_pd(b0i, ti));
+            cmul4(w2r, w2i, b3r, b3i, &tr, &ti);
+            _mm256_storeu_pd(r0 + j + m,     _mm256_add_pd(b1r, ti));
+            _mm256_storeu_pd(i0 + j + m,     _mm256_sub_pd(b1i, tr));
+            _mm256_storeu_pd(r0 + j + 3 * m, _mm256_sub_pd(b1r, ti));
+            _mm256_storeu_pd(i0 + j + 3 * m, _mm256_add_pd(b1i, tr));
+        }
+    }
+}
+#endif
+
+static void pass_radix4(double *restrict re, double *restrict im, size_t n, size_t m,
+                        const double *restrict twr, const double *restrict twi) {
+#if defined(__AVX2__) && defined(__FMA__)
+    if (m >= 4) { pass_radix4_simd(re, im, n, m, twr, twi); return; }
+#endif
+    for (size_t k = 0; k < n; k += 4 * m) {
+        for (size_t j = 0; j < m; j++) {
+            bfly4(re + k, im + k, j, m, twr[m + j], twi[m + j], twr[2 * m + j], twi[2 * m + j]);
+        }
+    }
+}
+
+int rt_fft_forward(double *re, double *im, size_t n) {
+    int lg = log2_exact(n);
+    if (!re || !im || lg < 0) return 1;
+    if (n == 1) return 0;
+    const rt_fft_table *t = table_for(lg);
+    if (!t) return 2;
+
+    bit_reverse(re, im, n);
+    size_t m = 1;
+    if (lg & 1) { pass_radix2(re, im, n); m = 2; }
+    for (; m < n; m <<= 2) pass_radix4(re, im, n, m, t->re, t->im);
+    return 0;
+}
+
+int rt_fft_inverse(double *re, double *im, size_t n) {
+    // Swapping re/im maps z to i*conj(z); forward on the swapped view is the unscaled inverse.
+    int rc = rt_fft_forward(im, re, n);
+    if (rc) return rc;
+    double s = 1.0 / (double)n;
+    for (size_t k = 0; k < n; k++) { re[k] *= s; im[k] *= s; }
+    return 0;
+}
+
+int rt_fft_real(const double *x, double *re, double *im, size_t n) {
+    int lg = log2_exact(n);
+    if (!x || !re || !im || lg < 1) return 1;
+    const rt_fft_table *t = table_for(lg);
+    if (!t) return 2;
+
+    size_t h = n >> 1;
+    for (size_t k = 0; k < h; k++) { re[k] = x[2 * k]; im[k] = x[2 * k + 1]; }
+    int rc = rt_fft_forward(re, im, h);
+    if (rc) return rc;
+
+    // Split Z = FFT(even + i*odd) into X[k] = Fe[k] + w_n^k * Fo[k], pairing k with h-k.
+    double z0r = re[0], z0i = im[0];
+    re[0] = z0r + z0i; im[0] = 0.0;
+    re[h] = z0r - z0i; im[h] = 0.0;
+    for (size_t k = 1; k <= h / 2; k++) {
+        double ar = re[k], ai = im[k], br = re[h - k], bi = im[h - k];
+        double fer = 0.5 * (ar + br), fei = 0.5 * (ai - bi);
+        double for_ = 0.5 * (ai + bi), foi = -0.5 * (ar - br);
+        double wr = t->re[h + k], wi = t->im[h + k];
+        double tr = wr * for_ - wi * foi, ti = wr * foi + wi * for_;
+        re[k] = fer + tr;     im[k] = fei + ti;
+        re[h - k] = fer - tr; im[h - k] = ti - fei;
+    }
+    return 0;
+}
+
+int rt_fft_prepare(size_t n) {
+    int lg = log2_exact(n);
+    if (lg < 0) return 1;
+    return table_for(lg) ? 0 : 2;
+}
+
+void rt_fft_release(void) {
+    pthread_mutex_lock(&g_tables_mu);
+    for (int l = 0; l <= RT_FFT_MAX_LOG2; l++) {
+        rt_free(g_tables[l].re);
+        rt_free(g_tables[l].im);
+        g_tables[l].re = NULL;
+        g_tables[l].im = NULL;
+    }
+    pthread_mutex_unlock(&g_tables_mu);
+}
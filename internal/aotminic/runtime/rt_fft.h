@@ -0,0 +1,39 @@
+// rt_fft.h
+// In-place iterative FFT for Tenge AOT-generated C.
+//
+// Layout: split complex (separate re[] / im[] arrays), which keeps every
+// butterfly operand contiguous and lets the inner loop run in SIMD lanes.
+// Sizes: powers of two from 1 to 2^RT_FFT_MAX_LOG2.
+// Complexity: O(n log n); radix-4 passes (radix-2 first pass when log2(n) is odd).
+// Twiddles are computed once per size class and cached for the process lifetime
+// (rt_alloc_aligned blocks: link with rt_alloc.c).
+
+#pragma once
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RT_FFT_MAX_LOG2 24
+
+// Forward transform, X[k] = sum x[j] * exp(-2*pi*i*j*k/n). Returns 0 on success.
+int  rt_fft_forward(double *re, double *im, size_t n);
+
+// Inverse transform, scaled by 1/n so that inverse(forward(x)) == x.
+int  rt_fft_inverse(double *re, double *im, size_t n);
+
+// Real-input forward transform of x[0..n) using one n/2-point complex FFT.
+// Writes the n/2+1 non-redundant bins to re[0..n/2] and im[0..n/2];
+// re/im must not alias x and must hold n/2+1 doubles each (n >= 2).
+int  rt_fft_real(const double *x, double *re, double *im, size_t n);
+
+// Builds the twiddle table for size n ahead of the first transform.
+int  rt_fft_prepare(size_t n);
+
+// Drops all cached twiddle tables. Not safe while transforms are running.
+void rt_fft_release(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,309 @@
+// rt_garch.c
+// Batched GARCH(1,1) MLE: lockstep L-BFGS over blocks of LANES instruments.
+//
+// Each block is copied once into a contiguous, standardized buffer x[t * LANES + j] =
+// r_t^2 / var_j, so the fit is scale-free (h_0 = 1) and every likelihood evaluation
+// streams LANES-wide rows. The variance recursion and its parameter derivatives are
+// carried per lane; the inner lane loops are plain fixed-width loops that the
+// compiler turns into SIMD. log(h_t) is accumulated as log of products of
+// LOG_CHUNK consecutive h_t, so libm is called once per LOG_CHUNK steps.
+//
+// Parametrization: omega = exp(t0), alpha = e1 / D, beta = e2 / D with e_k = exp(t_k),
+// D = 1 + e1 + e2, which keeps omega > 0, alpha, beta > 0, alpha + beta < 1.
+// All lanes of a block share one line-search schedule (Armijo backtracking); a lane
+// that has accepted its step or converged just rides along.
+
+#include "rt_garch.h"
+#include "rt_alloc.h"
+#include "rt_sched.h"
+#include <math.h>
+#include <stdlib.h>
+
+#define LANES         8
+#define HIST          6      // L-BFGS memory pairs
+#define LOG_CHUNK     8
+#define MAX_BACKTRACK 40
+#define ARMIJO_C      1e-4
+#define FTOL_REL      1e-13  // relative decrease below which a lane counts as converged
+
+typedef struct {
+    const double *r;
+    size_t        n_series;
+    size_t        n_obs;
+    int           max_iter;
+    double        gtol;
+    rt_garch_fit *out;
+    size_t        blocks;
+    size_t        done;      // blocks finished (atomic)
+} garch_job;
+
+typedef struct {
+    double s[HIST][3];
+    double y[HIST][3];
+    double rho[HIST];
+    int    count;
+    int    head;             // slot of the next pair
+} lbfgs_mem;
+
+static void unpack(const double th[3], double *omega, double *alpha, double *beta) {
+    double e1 = exp(th[1]), e2 = exp(th[2]), d = 1.0 + e1 + e2;
+    *omega = exp(th[0]);
+    *alpha = e1 / d;
+    *beta = e2 / d;
+}
+
+// Mean NLL (without constants) and its gradient w.r.t. the unconstrained parameters,
+// for all LANES lanes at once.
+static void eval_block(const double *restrict x, size_t n_obs, const double (*th)[3],
+                       double *f, double (*g)[3]) {
+    double om[LANES], al[LANES], be[LANES];
+    for (int j = 0; j < LANES; j++) unpack(th[j], &om[j], &al[j], &be[j]);
+
+    double h[LANES], dw[LANES], da[LANES], db[LANES];
+    double gw[LANES], ga[LANES], gb[LANES], q[LANES], prod[LANES], lsum[LANES];
+    for (int j = 0; j < LANES; j++) {
+        h[j] = 1.0;                  // h_0 = sample variance of the standardized series
+        dw[j] = da[j] = db[j] = 0.0;
+        gw[j] = ga[j] = gb[j] = 0.0;
+        q[j] = x[j];
+        prod[j] = 1.0;
+        lsum[j] = 0.0;
+    }
+    for (size_t t = 1; t < n_obs; t++) {
+        const double *restrict xp = x + (t - 1) * LANES;
+        const double *restrict xt = x + t * LANES;
+        for (int j = 0; j < LANES; j++) {
+            // dh_t/dp = d(omega + alpha x_{t-1} + beta h_{t-1})/dp, using h_{t-1}.
+            dw[j] = 1.0 + be[j] * dw[j];
+            da[j] = xp[j] + be[j] * da[j];
+            db[j] = h[j] + be[j] * db[j];
+            h[j] = om[j] + al[j] * xp[j] + be[j] * h[j];
+            double inv = 1.0 / h[j];
+            double qi = xt[j] * inv;
+            double c = inv - qi * inv;   // d(log h + x/h)/dh
+            gw[j] += c * dw[j];
+            ga[j] += c * da[j];
+            gb[j] += c * db[j];
+            q[j] += qi;
+            prod[j] *= h[j];
+        }
+        if (t % LOG_CHUNK == 0) {
+            for (int j = 0; j < LANES; j++) { lsum[j] += log(prod[j]); prod[j] = 1.0; }
+        }
+    }
+
+    double s = 0.5 / (double)n_obs;
+    for (int j = 0; j < LANES; j++) {
+        lsum[j] += log(prod[j]);
+        f[j] = s * (lsum[j] + q[j]);
+        double a = al[j], b = be[j];
+        double pw = s * gw[j], pa = s * ga[j], pb = s * gb[j];
+        g[j][0] = pw * om[j];
+        g[j][1] = pa * a * (1.0 - a) - pb * a * b;
+        g[j][2] = pb * b * (1.0 - b) - pa * a * b;
+    }
+}
+
+static double dot3(const double *a, const double *b) {
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+static double norm_inf3(const double *a) {
+    double m = fabs(a[0]);
+    if (fabs(a[1]) > m) m = fabs(a[1]);
+    if (fabs(a[2]) > m) m = fabs(a[2]);
+    return m;
+}
+
+// d = -H g by the two-loop recursion; H_0 = (s'y / y'y) I from the newest pair.
+static void lbfgs_direction(const lbfgs_mem *m, const double g[3], double d[3]) {
+    double a[HIST];
+    for (int k = 0; k < 3; k++) d[k] = -g[k];
+    for (int i = 0; i < m->count; i++) {
+        int p = (m->head - 1 - i + HIST) % HIST;
+        a[p] = m->rho[p] * dot3(m->s[p], d);
+        for (int k = 0; k < 3; k++) d[k] -= a[p] * m->y[p][k];
+    }
+    if (m->count > 0) {
+        int p = (m->head - 1 + HIST) % HIST;
+        double gamma = dot3(m->s[p], m->y[p]) / dot3(m->y[p], m->y[p]);
+        for (int k = 0; k < 3; k++) d[k] *= gamma;
+    } else {
+        double gn = norm_inf3(g);
+        if (gn > 1.0) for (int k = 0; k < 3; k++) d[k] /= gn;
+    }
+    for (int i = m->count - 1; i >= 0; i--) {
+        int p = (m->head - 1 - i + HIST) % HIST;
+        double b = m->rho[p] * dot3(m->y[p], d);
+        for (int k = 0; k < 3; k++) d[k] += (a[p] - b) * m->s[p][k];
+    }
+}
+
+static void lbfgs_push(lbfgs_mem *m, const double s[3], const double y[3]) {
+    double sy = dot3(s, y);
+    if (!(sy > 1e-16 * dot3(y, y))) return;  // curvature condition failed: keep old pairs
+    for (int k = 0; k < 3; k++) { m->s[m->head][k] = s[k]; m->y[m->head][k] = y[k]; }
+    m->rho[m->head] = 1.0 / sy;
+    m->head = (m->head + 1) % HIST;
+    if (m->count < HIST) m->count++;
+}
+
+typedef struct {
+    double    th[LANES][3], g[LANES][3], f[LANES];
+    double    tt[LANES][3], gt[LANES][3], ft[LANES];
+    double    d[LANES][3], step[LANES], gd[LANES];
+    int       active[LANES], pending[LANES], iters[LANES], status[LANES];
+    lbfgs_mem mem[LANES];
+} block_state;
+
+static void fit_block(const garch_job *job, size_t blk, double *restrict x, block_state *st) {
+    size_t n = job->n_series, T = job->n_obs, s0 = blk * LANES;
+    int lanes = n - s0 < LANES ? (int)(n - s0) : LANES;
+    double var[LANES];
+
+    // Gather the block and standardize each lane to unit second moment.
+    for (int j = 0; j < LANES; j++) var[j] = 0.0;
+    for (size_t t = 0; t < T; t++) {
+        const double *row = job->r + t * n + s0;
+        double *xt = x + t * LANES;
+        for (int j = 0; j < lanes; j++) { xt[j] = row[j] * row[j]; var[j] += xt[j]; }
+        for (int j = lanes; j < LANES; j++) xt[j] = 1.0;
+    }
+    for (int j = 0; j < LANES; j++) {
+        var[j] = j < lanes ? var[j] / (double)T : 1.0;
+        int ok = j < lanes && var[j] > 0.0 && isfinite(var[j]);
+        st->active[j] = ok;
+        st->status[j] = ok ? RT_GARCH_CONVERGED : RT_GARCH_DEGENERATE;
+        st->iters[j] = 0;
+        st->mem[j].count = st->mem[j].head = 0;
+        if (!ok) var[j] = 1.0;
+        // Start at alpha = 0.05, beta = 0.90, omega = 0.05 (unconditional variance 1).
+        st->th[j][0] = log(0.05);
+        st->th[j][1] = 0.0;
+        st->th[j][2] = log(18.0);
+    }
+    for (size_t t = 0; t < T; t++) {
+        double *xt = x + t * LANES;
+        for (int j = 0; j < LANES; j++) xt[j] = st->active[j] ? xt[j] / var[j] : 1.0;
+    }
+
+    eval_block(x, T, st->th, st->f, st->g);
+    for (int j = 0; j < LANES; j++) {
+        if (st->active[j] && norm_inf3(st->g[j]) < job->gtol) st->active[j] = 0;
+    }
+
+    for (int it = 0; it < job->max_iter; it++) {
+        int any = 0;
+        for (int j = 0; j < LANES; j++) {
+            st->pending[j] = st->active[j];
+            if (!st->active[j]) continue;
+            any = 1;
+            lbfgs_direction(&st->mem[j], st->g[j], st->d[j]);
+            st->gd[j] = dot3(st->g[j], st->d[j]);
+            if (!(st->gd[j] < 0.0)) {
+                // Not a descent direction: drop the history and fall back to steepest descent.
+                st->mem[j].count = 0;
+                lbfgs_direction(&st->mem[j], st->g[j], st->d[j]);
+                st->gd[j] = dot3(st->g[j], st->d[j]);
+            }
+            st->step[j] = 1.0;
+        }
+        if (!any) break;
+
+        for (int bt = 0; bt < MAX_BACKTRACK; bt++) {
+            for (int j = 0; j < LANES; j++) {
+                double a = st->pending[j] ? st->step[j] : 0.0;
+                for (int k = 0; k < 3; k++) st->tt[j][k] = st->th[j][k] + a * st->d[j][k];
+            }
+            eval_block(x, T, st->tt, st->ft, st->gt);
+            any = 0;
+            for (int j = 0; j < LANES; j++) {
+                if (!st->pending[j]) continue;
+                if (isfinite(st->ft[j]) &&
+                    st->ft[j] <= st->f[j] + ARMIJO_C * st->step[j] * st->gd[j]) {
+                    double s[3], y[3];
+                    for (int k = 0; k < 3; k++) {
+                        s[k] = st->tt[j][k] - st->th[j][k];
+                        y[k] = st->gt[j][k] - st->g[j][k];
+                        st->th[j][k] = st->tt[j][k];
+                        st->g[j][k] = st->gt[j][k];
+                    }
+                    lbfgs_push(&st->mem[j], s, y);
+                    double df = st->f[j] - st->ft[j];
+                    st->f[j] = st->ft[j];
+                    st->iters[j]++;
+                    st->pending[j] = 0;
+                    if (norm_inf3(st->g[j]) < job->gtol || df <= FTOL_REL * (1.0 + fabs(st->f[j]))) {
+                        st->active[j] = 0;
+                    }
+                } else {
+                    st->step[j] *= 0.5;
+                    any = 1;
+                }
+            }
+            if (!any) break;
+        }
+        for (int j = 0; j < LANES; j++) {
+            if (st->pending[j]) { st->active[j] = 0; st->status[j] = RT_GARCH_LINESEARCH; }
+        }
+    }
+
+    double c = 0.5 * log(2.0 * M_PI);
+    for (int j = 0; j < lanes; j++) {
+        rt_garch_fit *o = &job->out[s0 + j];
+        if (st->status[j] == RT_GARCH_DEGENERATE) {
+            o->omega = o->alpha = o->beta = o->nll = NAN;
+            o->iters = 0;
+            o->status = RT_GARCH_DEGENERATE;
+            continue;
+        }
+        if (st->active[j]) st->status[j] = RT_GARCH_MAXITER;
+        unpack(st->th[j], &o->omega, &o->alpha, &o->beta);
+        o->omega *= var[j];
+        // f is the standardized mean NLL; undo the scaling of h_t by var.
+        o->nll = (double)T * (st->f[j] + c + 0.5 * log(var[j]));
+        o->iters = st->iters[j];
+        o->status = st->status[j];
+    }
+}
+
+// Fits blocks [lo, hi). A chunk that cannot get its buffers marks its series
+// RT_GARCH_OOM and leaves them unfitted; rt_garch_fit_batch then returns 2.
+static void garch_chunk(long lo, long hi, void *arg) {
+    garch_job *job = arg;
+    double *x = rt_alloc_aligned(job->n_obs * LANES * sizeof(double), 64);
+    block_state *st = malloc(sizeof(block_state));
+    if (x && st) {
+        for (long b = lo; b < hi; b++) fit_block(job, (size_t)b, x, st);
+        __atomic_fetch_add(&job->done, (size_t)(hi - lo), __ATOMIC_RELAXED);
+    } else {
+        size_t end = (size_t)hi * LANES < job->n_series ? (size_t)hi * LANES : job->n_series;
+        for (size_t s = (size_t)lo * LANES; s < end; s++) {
+            rt_garch_fit *o = &job->out[s];
+            o->omega = o->alpha = o->beta = o->nll = NAN;
+            o->iters = 0;
+            o->status = RT_GARCH_OOM;
+        }
+    }
+    rt_free(x);
+    free(st);
+}
+
+int rt_garch_fit_batch(const double *r, size_t n_series, size_t n_obs,
+                       const rt_garch_opts *opts, rt_garch_fit *out) {
+    if (!r || !out || n_obs < 2) return 1;
+    if (n_series == 0) return 0;
+
+    int threads = opts ? opts->threads : 0;
+    garch_job job = { r, n_series, n_obs,
+                      opts && opts->max_iter > 0 ? opts->max_iter : 200,
+                      opts && opts->gtol > 0.0 ? opts->gtol : 1e-6,
+                      out, (n_series + LANES - 1) / LANES, 0 };
+    if (threads == 1 || job.blocks == 1) {
+        garch_chunk(0, (long)job.blocks, &job);
+    } else {
+        rt_sched_init(threads);
+        rt_parallel_for(0, (long)job.blocks, 0, garch_chunk, &job);
+    }
+    return job.done == job.blocks ? 0 : 2;
+}
@@ -0,0 +1,50 @@
+// rt_garch.h
+// Batched GARCH(1,1) maximum-likelihood calibration for Tenge AOT-generated C.
+//
+// Model: r_t = sqrt(h_t) * z_t, z_t ~ N(0, 1), h_t = omega + alpha * r_{t-1}^2 + beta * h_{t-1},
+// h_0 = sample variance. Each series is fitted independently by L-BFGS on the Gaussian
+// negative log-likelihood with analytic gradients, in an unconstrained parametrization
+// that keeps omega > 0, alpha, beta >= 0 and alpha + beta < 1.
+// Layout: returns are time-major (structure of arrays), r[t * n_series + s], so one time
+// step of a block of instruments is contiguous and the recursion runs across SIMD lanes.
+// Blocks of instruments are run by the rt_sched pool (link with rt_sched.c and rt_alloc.c).
+
+#pragma once
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    int    max_iter;  // L-BFGS iterations per series (<= 0: 200)
+    double gtol;      // stop when max |gradient| of the per-observation NLL < gtol (<= 0: 1e-6)
+    int    threads;   // 1: run on the caller; else rt_sched pool size if not started (<= 0: default)
+} rt_garch_opts;
+
+// Per-series fit status.
+#define RT_GARCH_CONVERGED  0
+#define RT_GARCH_MAXITER    1  // iteration cap reached; parameters are the best found
+#define RT_GARCH_LINESEARCH 2  // no descent step found; parameters are the best found
+#define RT_GARCH_DEGENERATE 3  // zero or non-finite sample variance; series not fitted
+#define RT_GARCH_OOM        4  // no memory for the series' block buffers; series not fitted
+
+typedef struct {
+    double omega;
+    double alpha;
+    double beta;
+    double nll;     // negative log-likelihood at the fit, including the 0.5*log(2*pi) terms
+    int    iters;
+    int    status;  // RT_GARCH_*
+} rt_garch_fit;
+
+// Fits every series of r (n_obs x n_series, time-major) into out[0 .. n_series-1].
+// opts may be NULL. Returns 0 on success, 1 on bad arguments, 2 if some series could not
+// be fitted for lack of memory (their status is RT_GARCH_OOM; all other entries of out
+// are valid). Per-series problems are reported in out[s].status.
+int rt_garch_fit_batch(const double *r, size_t n_series, size_t n_obs,
+                       const rt_garch_opts *opts, rt_garch_fit *out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,198 @@
+// rt_http.c
+// Zero-copy incremental HTTP/1.x request parser: end-of-head scan, request line and
+// header split, Content-Length / Connection handling, form value decoding.
+
+#include "rt_http.h"
+#include <string.h>
+
+// RFC 9110 token characters (method and header names).
+static const unsigned char k_tchar[256] = {
+    ['!'] = 1, ['#'] = 1, ['$'] = 1, ['%'] = 1, ['&'] = 1, ['\''] = 1, ['*'] = 1,
+    ['+'] = 1, ['-'] = 1, ['.'] = 1, ['^'] = 1, ['_'] = 1, ['`'] = 1, ['|'] = 1, ['~'] = 1,
+    ['0'] = 1, ['1'] = 1, ['2'] = 1, ['3'] = 1, ['4'] = 1, ['5'] = 1, ['6'] = 1, ['7'] = 1,
+    ['8'] = 1, ['9'] = 1,
+    ['A'] = 1, ['B'] = 1, ['C'] = 1, ['D'] = 1, ['E'] = 1, ['F'] = 1, ['G'] = 1, ['H'] = 1,
+    ['I'] = 1, ['J'] = 1, ['K'] = 1, ['L'] = 1, ['M'] = 1, ['N'] = 1, ['O'] = 1, ['P'] = 1,
+    ['Q'] = 1, ['R'] = 1, ['S'] = 1, ['T'] = 1, ['U'] = 1, ['V'] = 1, ['W'] = 1, ['X'] = 1,
+    ['Y'] = 1, ['Z'] = 1,
+    ['a'] = 1, ['b'] = 1, ['c'] = 1, ['d'] = 1, ['e'] = 1, ['f'] = 1, ['g'] = 1, ['h'] = 1,
+    ['i'] = 1, ['j'] = 1, ['k'] = 1, ['l'] = 1, ['m'] = 1, ['n'] = 1, ['o'] = 1, ['p'] = 1,
+    ['q'] = 1, ['r'] = 1, ['s'] = 1, ['t'] = 1, ['u'] = 1, ['v'] = 1, ['w'] = 1, ['x'] = 1,
+    ['y'] = 1, ['z'] = 1,
+};
+
+// Blank lines before a request line are ignored (RFC 9112 2.2), e.g. a stray CRLF
+// after a POST body.
+static size_t skip_blank(const char *buf, size_t len) {
+    size_t i = 0;
+    while (i < len && (buf[i] == '\r' || buf[i] == '\n')) i++;
+    return i;
+}
+
+// First '\n' in [p, end), or end.
+static inline const char *find_lf(const char *p, const char *end) {
+    const char *q = memchr(p, '\n', (size_t)(end - p));
+    return q ? q : end;
+}
+
+// Offset just past the blank line ending the head, or 0 if it has not arrived. Only
+// bytes from ps->scanned on are searched; every '\n' found is checked for an empty line
+// before it (LF LF or LF CR LF).
+static size_t find_end(rt_http_parser *ps, const char *buf, size_t len, size_t start) {
+    const char *p = buf + (ps->scanned > start ? ps->scanned : start), *end = buf + len;
+    const char *first = buf + start;
+    while ((p = find_lf(p, end)) < end) {
+        if (p >= first + 1 && p[-1] == '\n') return (size_t)(p - buf) + 1;
+        if (p >= first + 2 && p[-1] == '\r' && p[-2] == '\n') return (size_t)(p - buf) + 1;
+        p++;
+    }
+    ps->scanned = len;
+    return 0;
+}
+
+// ASCII case folding; header names and the tokens looked for are ASCII.
+static inline int lower(int c) { return c >= 'A' && c <= 'Z' ? c + 32 : c; }
+
+// s (any case) equals lit, which is lower case and n bytes long.
+static int ieq(rt_slice s, const char *lit, size_t n) {
+    if (s.n != n) return 0;
+    for (size_t i = 0; i < n; i++) {
+        if (lower((unsigned char)s.p[i]) != lit[i]) return 0;
+    }
+    return 1;
+}
+
+static int has_token(rt_slice v, const char *tok, size_t tl) {
+    for (size_t i = 0; i + tl <= v.n; i++) {
+        if (ieq((rt_slice){ v.p + i, tl }, tok, tl)) return 1;
+    }
+    return 0;
+}
+
+// Line ending at p (LF, optionally preceded by CR): returns the position after it, or
+// NULL if p is not at a line end.
+static const char *eol(const char *p, const char *end) {
+    if (p < end && *p == '\r') p++;
+    return p < end && *p == '\n' ? p + 1 : NULL;
+}
+
+int rt_http_parse(rt_http_parser *ps, const char *buf, size_t len, rt_http_req *req) {
+    size_t start = skip_blank(buf, len);
+    size_t head = find_end(ps, buf, len, start);
+    if (!head) return RT_HTTP_INCOMPLETE;
+
+    const char *p = buf + start, *end = buf + head;
+    req->content_length = -1;
+    req->n_headers = 0;
+    req->head_len = head;
+
+    // method SP target SP HTTP/1.d
+    const char *m = p;
+    while (p < end && k_tchar[(unsigned char)*p]) p++;
+    if (p == m || p >= end || *p != ' ') return RT_HTTP_EBAD;
+    req->method = (rt_slice){ m, (size_t)(p - m) };
+    const char *t = ++p, *q = NULL;
+    while (p < end && (unsigned char)*p > ' ' && *p != 0x7f) {
+        if (*p == '?' && !q) q = p;
+        p++;
+    }
+    if (p == t || p >= end || *p != ' ') return RT_HTTP_EBAD;
+    req->target = (rt_slice){ t, (size_t)(p - t) };
+    req->path   = (rt_slice){ t, (size_t)((q ? q : p) - t) };
+    req->query  = q ? (rt_slice){ q + 1, (size_t)(p - q - 1) } : (rt_slice){ p, 0 };
+    p++;
+    if (end - p < 8 || memcmp(p, "HTTP/1.", 7) != 0 || p[7] < '0' || p[7] > '9') return RT_HTTP_EBAD;
+    req->minor = p[7] - '0';
+    if (!(p = eol(p + 8, end))) return RT_HTTP_EBAD;
+
+    int conn_close = 0, conn_keep = 0;
+    for (;;) {
+        const char *next = eol(p, end);
+        if (next) break;                               // blank line: end of head
+        if (*p == ' ' || *p == '\t') return RT_HTTP_EBAD;   // obsolete line folding
+        const char *n = p;
+        while (p < end && k_tchar[(unsigned char)*p]) p++;
+        if (p == n || p >= end || *p != ':') return RT_HTTP_EBAD;
+        rt_slice name = { n, (size_t)(p - n) };
+        p++;
+        while (p < end && (*p == ' ' || *p == '\t')) p++;
+        const char *v = p, *lf = find_lf(p, end);
+        if (lf == end) return RT_HTTP_EBAD;
+        const char *ve = lf;
+        while (ve > v && (ve[-1] == '\r' || ve[-1] == ' ' || ve[-1] == '\t')) ve--;
+        rt_slice value = { v, (size_t)(ve - v) };
+        p = lf + 1;
+
+        if (req->n_headers == RT_HTTP_MAX_HEADERS) return RT_HTTP_EHEADERS;
+        req->headers[req->n_headers++] = (rt_http_header){ name, value };
+
+        if (ieq(name, "content-length", 14)) {
+            long long cl = 0;
+            if (value.n == 0 || value.n > 15) return RT_HTTP_EBAD;
+            for (size_t i = 0; i < value.n; i++) {
+                if (value.p[i] < '0' || value.p[i] > '9') return RT_HTTP_EBAD;
+                cl = cl * 10 + (value.p[i] - '0');
+            }
+            if (req->content_length >= 0 && req->content_length != cl) return RT_HTTP_EBAD;
+            req->content_length = cl;
+        } else if (ieq(name, "connection", 10)) {
+            conn_close |= has_token(value, "close", 5);
+            conn_keep  |= has_token(value, "keep-alive", 10);
+        } else if (ieq(name, "transfer-encoding", 17)) {
+            return RT_HTTP_EUNSUP;
+        }
+    }
+    // HTTP/1.1 persists unless "close"; HTTP/1.0 only with "keep-alive".
+    req->keep_alive = conn_close ? 0 : conn_keep ? 1 : req->minor >= 1;
+    return (int)head;
+}
+
+const rt_slice *rt_http_header_get(const rt_http_req *req, const char *name) {
+    size_t n = strlen(name);
+    for (size_t i = 0; i < req->n_headers; i++) {
+        const rt_slice *h = &req->headers[i].name;
+        size_t k = 0;
+        if (h->n != n) continue;
+        while (k < n && lower((unsigned char)h->p[k]) == lower((unsigned char)name[k])) k++;
+        if (k == n) return &req->headers[i].value;
+    }
+    return NULL;
+}
+
+int rt_slice_eq(rt_slice s, const char *lit) {
+    size_t n = strlen(lit);
+    return s.n == n && memcmp(s.p, lit, n) == 0;
+}
+
+static int hexval(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+long rt_http_form_get(rt_slice form, const char *key, char *out, size_t cap) {
+    size_t kl = strlen(key);
+    const char *p = form.p, *end = form.p + form.n;
+    while (p < end) {
+        const char *amp = memchr(p, '&', (size_t)(end - p));
+        if (!amp) amp = end;
+        const char *eq = memchr(p, '=', (size_t)(amp - p));
+        const char *ke = eq ? eq : amp;
+        if ((size_t)(ke - p) == kl && memcmp(p, key, kl) == 0) {
+            size_t o = 0;
+            for (const char *v = eq ? eq + 1 : amp; v < amp && o + 1 < cap; v++) {
+                int hi, lo;
+                if (*v == '%' && amp - v > 2 && (hi = hexval(v[1])) >= 0 && (lo = hexval(v[2])) >= 0) {
+                    out[o++] = (char)(hi << 4 | lo); v += 2;
+                } else {
+                    out[o++] = *v == '+' ? ' ' : *v;
+                }
+            }
+            if (cap) out[o] = '\0';
+            return (long)o;
+        }
+        p = amp + 1;
+    }
+    return -1;
+}
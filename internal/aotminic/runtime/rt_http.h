@@ -0,0 +1,68 @@
+// rt_http.h
+// Zero-copy, incremental HTTP/1.x request parser for Tenge AOT-generated C.
+//
+// The caller owns the receive buffer and calls rt_http_parse after every read with the
+// bytes received so far. Until the blank line that ends the head arrives, the parser only
+// extends its scan over the new bytes (the rt_http_parser state remembers how far it got),
+// so a head delivered in many small reads costs one pass. Once complete, the request line
+// and headers are split in a single pass into slices that point into the buffer: nothing
+// is copied or allocated. Slices stay valid while the buffer is unchanged.
+// Request bodies are framed by Content-Length; chunked request bodies are rejected.
+
+#pragma once
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct { const char *p; size_t n; } rt_slice;
+
+typedef struct { rt_slice name, value; } rt_http_header;
+
+#define RT_HTTP_MAX_HEADERS 32
+
+typedef struct {
+    rt_slice       method;
+    rt_slice       target;          // as sent: path plus optional "?query"
+    rt_slice       path;            // target up to '?'
+    rt_slice       query;           // after '?' (empty if none)
+    int            minor;           // HTTP/1.<minor>
+    int            keep_alive;      // from version and Connection header
+    long long      content_length;  // -1 when absent
+    size_t         head_len;        // request line + headers + blank line
+    size_t         n_headers;
+    rt_http_header headers[RT_HTTP_MAX_HEADERS];
+} rt_http_req;
+
+// Scan state carried across partial reads of one request. Zero it (or call
+// rt_http_parser_reset) before the first byte of every request.
+typedef struct { size_t scanned; } rt_http_parser;
+
+// Results of rt_http_parse (> 0 is the head length).
+#define RT_HTTP_INCOMPLETE  0   // need more bytes
+#define RT_HTTP_EBAD       -1   // malformed request line or header
+#define RT_HTTP_EHEADERS   -2   // more than RT_HTTP_MAX_HEADERS headers
+#define RT_HTTP_EUNSUP     -3   // unsupported framing (Transfer-Encoding on a request)
+
+static inline void rt_http_parser_reset(rt_http_parser *ps) { ps->scanned = 0; }
+
+// Parses the request head at the start of buf[0 .. len-1]. Returns the head length
+// (> 0) and fills *req, RT_HTTP_INCOMPLETE, or a negative RT_HTTP_E* code. The body, if
+// any, is buf[head_len .. head_len + content_length - 1] once that many bytes arrived.
+int rt_http_parse(rt_http_parser *ps, const char *buf, size_t len, rt_http_req *req);
+
+// Case-insensitive header lookup; NULL if absent.
+const rt_slice *rt_http_header_get(const rt_http_req *req, const char *name);
+
+// Nonzero when s equals the NUL-terminated string lit (case-sensitive).
+int rt_slice_eq(rt_slice s, const char *lit);
+
+// Finds key in an application/x-www-form-urlencoded string (a query or a form body)
+// and percent-decodes its value into out (NUL-terminated, truncated to cap - 1 bytes).
+// Returns the decoded length, or -1 if the key is absent.
+long rt_http_form_get(rt_slice form, const char *key, char *out, size_t cap);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,96 @@
+// rt_json.c
+// Streaming JSON writer: buffer management, single-pass string escaping, integers.
+
+#include "rt_json.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SCAN 16   // bytes classified per block (two 64-bit words)
+
+#define ONES  0x0101010101010101ULL
+#define HIGHS 0x8080808080808080ULL
+
+// Nonzero iff some byte of x needs escaping: < 0x20, '"' or '\\'. The "has a byte below
+// n / equal to zero" word tricks are exact as a whole-word test (a borrow can move a hit
+// to another byte but never create one), which is all the block scan needs.
+static inline uint64_t needs_escape(uint64_t x) {
+    uint64_t lt  = (x - ONES * 0x20) & ~x;
+    uint64_t quo = x ^ (ONES * '"'), bsl = x ^ (ONES * '\\');
+    uint64_t eq  = ((quo - ONES) & ~quo) | ((bsl - ONES) & ~bsl);
+    return (lt | eq) & HIGHS;
+}
+
+int rt_jbuf_reserve(rt_jbuf *b, size_t extra) {
+    if (b->oom) return -1;
+    if (b->len + extra <= b->cap) return 0;
+    size_t cap = b->cap ? b->cap : 1024;
+    while (cap < b->len + extra) cap *= 2;
+    char *p = realloc(b->p, cap);
+    if (!p) { b->oom = 1; return -1; }
+    b->p = p; b->cap = cap;
+    return 0;
+}
+
+void rt_jbuf_put(rt_jbuf *b, const void *s, size_t n) {
+    if (rt_jbuf_reserve(b, n)) return;
+    memcpy(b->p + b->len, s, n);
+    b->len += n;
+}
+
+void rt_jbuf_free(rt_jbuf *b) {
+    free(b->p);
+    b->p = NULL; b->len = b->cap = 0; b->oom = 0;
+}
+
+static const char k_hex[] = "0123456789abcdef";
+
+static char *esc1(char *o, unsigned char c) {
+    if (c >= 0x20 && c != '"' && c != '\\') { *o++ = (char)c; return o; }
+    *o++ = '\\';
+    switch (c) {
+    case '"':  *o++ = '"';  break;
+    case '\\': *o++ = '\\'; break;
+    case '\b': *o++ = 'b';  break;
+    case '\f': *o++ = 'f';  break;
+    case '\n': *o++ = 'n';  break;
+    case '\r': *o++ = 'r';  break;
+    case '\t': *o++ = 't';  break;
+    default:
+        *o++ = 'u'; *o++ = '0'; *o++ = '0';
+        *o++ = k_hex[c >> 4]; *o++ = k_hex[c & 15];
+    }
+    return o;
+}
+
+size_t rt_json_escape(char *dst, const char *s, size_t n) {
+    const unsigned char *u = (const unsigned char *)s;
+    char *o = dst;
+    size_t i = 0;
+    for (; i + SCAN <= n; i += SCAN) {
+        uint64_t w0, w1;
+        memcpy(&w0, u + i, 8);
+        memcpy(&w1, u + i + 8, 8);
+        if (!(needs_escape(w0) | needs_escape(w1))) { memcpy(o, s + i, SCAN); o += SCAN; continue; }
+        for (size_t k = 0; k < SCAN; k++) o = esc1(o, u[i + k]);
+    }
+    for (; i < n; i++) o = esc1(o, u[i]);
+    return (size_t)(o - dst);
+}
+
+void rt_json_str(rt_jbuf *b, const char *s, size_t n) {
+    if (rt_jbuf_reserve(b, 6 * n + 2)) return;
+    char *o = b->p + b->len;
+    *o++ = '"';
+    o += rt_json_escape(o, s, n);
+    *o++ = '"';
+    b->len = (size_t)(o - b->p);
+}
+
+void rt_json_int(rt_jbuf *b, long long v) {
+    char tmp[24], *e = tmp + sizeof(tmp), *p = e;
+    unsigned long long x = v < 0 ? 0ULL - (unsigned long long)v : (unsigned long long)v;
+    do { *--p = (char)('0' + x % 10); x /= 10; } while (x);
+    if (v < 0) *--p = '-';
+    rt_jbuf_put(b, p, (size_t)(e - p));
+}
@@ -0,0 +1,41 @@
+// rt_json.h
+// Streaming JSON writer for Tenge AOT-generated C.
+//
+// Values are appended straight into a growable byte buffer (rt_jbuf) that the caller
+// drains and reuses, e.g. one chunk of an HTTP chunked response at a time, so memory is
+// bounded by the chunk size rather than the document size. Strings are escaped in one
+// pass: the scanner classifies 16 bytes at a time with a fixed-width loop that compiles
+// to SIMD compares and copies clean blocks whole. Bytes >= 0x80 are passed through
+// unchanged (input is assumed to be UTF-8).
+
+#pragma once
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    char  *p;
+    size_t len, cap;
+    int    oom;   // sticky: set when a grow fails; later appends are dropped
+} rt_jbuf;
+
+// Ensures room for `extra` more bytes. Returns 0, or -1 (and sets oom) on OOM.
+int  rt_jbuf_reserve(rt_jbuf *b, size_t extra);
+void rt_jbuf_put(rt_jbuf *b, const void *s, size_t n);
+void rt_jbuf_free(rt_jbuf *b);
+#define RT_JBUF_LIT(b, s) rt_jbuf_put((b), (s), sizeof(s) - 1)
+
+// Escapes s[0 .. n-1] for use inside a JSON string (no quotes) into dst, which must
+// have room for 6 * n bytes. Returns the number of bytes written.
+size_t rt_json_escape(char *dst, const char *s, size_t n);
+
+// "s", escaped.
+void rt_json_str(rt_jbuf *b, const char *s, size_t n);
+// Decimal integer.
+void rt_json_int(rt_jbuf *b, long long v);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,309 @@
+// rt_matrix.c
+// Packed GEMM: per macro-tile of C, loop over KC slices of K, pack the B panel
+// (KC x NC, NR-wide column strips) and the A block (MC x KC, MR-tall row strips),
+// then sweep the MR x NR micro-kernel over the tile. Packed panels are zero-padded
+// so the micro-kernel never branches on edges; partial tiles go through a scratch tile.
+
+#include "rt_matrix.h"
+#include "rt_alloc.h"
+#include "rt_sched.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#endif
+
+#define MR 6
+#define NR 8
+#define KC 256
+#define MC 96   // multiple of MR
+#define NC 512  // multiple of NR
+
+// Below this many multiply-adds running on the caller beats handing tiles to the pool.
+#define PAR_MIN_FMAS (64.0 * 64.0 * 64.0)
+
+// Cholesky panel width; the trailing update is a GEMM with inner dimension CHOL_NB.
+#define CHOL_NB 64
+// Column strip width of the trailing update; strips skip the upper triangle.
+#define CHOL_STRIP 256
+
+int rt_mat_alloc(rt_mat *m, size_t rows, size_t cols) {
+    if (!m) return 1;
+    size_t stride = (cols + 7) & ~(size_t)7;
+    m->data = rt_alloc_aligned(rows * stride * sizeof(double), 64);
+    if (!m->data) { m->rows = m->cols = m->stride = 0; return 1; }
+    memset(m->data, 0, rows * stride * sizeof(double));
+    m->rows = rows;
+    m->cols = cols;
+    m->stride = stride;
+    return 0;
+}
+
+void rt_mat_free(rt_mat *m) {
+    if (!m) return;
+    rt_free(m->data);
+    m->data = NULL;
+    m->rows = m->cols = m->stride = 0;
+}
+
+// ---------- packing ----------
+
+// A[i0 .. i0+mc) x [p0 .. p0+kc) -> strips of MR rows, k-major inside a strip.
+static void pack_a(const rt_mat *a, size_t i0, size_t mc, size_t p0, size_t kc, double *restrict pa) {
+    for (size_t ir = 0; ir < mc; ir += MR) {
+        size_t mr = mc - ir < MR ? mc - ir : MR;
+        const double *src = a->data + (i0 + ir) * a->stride + p0;
+        for (size_t p = 0; p < kc; p++) {
+            size_t r = 0;
+            for (; r < mr; r++) pa[r] = src[r * a->stride + p];
+            for (; r < MR; r++) pa[r] = 0.0;
+            pa += MR;
+        }
+    }
+}
+
+// B[p0 .. p0+kc) x [j0 .. j0+nc) -> strips of NR columns, k-major inside a strip.
+static void pack_b(const rt_mat *b, size_t p0, size_t kc, size_t j0, size_t nc, double *restrict pb) {
+    for (size_t jr = 0; jr < nc; jr += NR) {
+        size_t nr = nc - jr < NR ? nc - jr : NR;
+        const double *src = b->data + p0 * b->stride + j0 + jr;
+        for (size_t p = 0; p < kc; p++) {
+            const double *row = src + p * b->stride;
+            if (nr == NR) {
+                memcpy(pb, row, NR * sizeof(double));
+            } else {
+                size_t c = 0;
+                for (; c < nr; c++) pb[c] = row[c];
+                for (; c < NR; c++) pb[c] = 0.0;
+            }
+            pb += NR;
+        }
+    }
+}
+
+// ---------- micro-kernel: C[MR x NR] += alpha * pa * pb ----------
+
+#if defined(__AVX2__) && defined(__FMA__)
+static void kernel_6x8(size_t kc, const double *restrict pa, const double *restrict pb,
+                       double *restrict c, size_t ldc, double alpha) {
+    __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+    __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+    __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+    __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+    __m256d c40 = _mm256_setzero_pd(), c41 = _mm256_setzero_pd();
+    __m256d c50 = _mm256_setzero_pd(), c51 = _mm256_setzero_pd();
+    for (size_t p = 0; p < kc; p++) {
+        __m256d b0 = _mm256_load_pd(pb), b1 = _mm256_load_pd(pb + 4);
+        __m256d a;
+        a = _mm256_broadcast_sd(pa + 0); c00 = _mm256_fmadd_pd(a, b0, c00); c01 = _mm256_fmadd_pd(a, b1, c01);
+        a = _mm256_broadcast_sd(pa + 1); c10 = _mm256_fmadd_pd(a, b0, c10); c11 = _mm256_fmadd_pd(a, b1, c11);
+        a = _mm256_broadcast_sd(pa + 2); c20 = _mm256_fmadd_pd(a, b0, c20); c21 = _mm256_fmadd_pd(a, b1, c21);
+        a = _mm256_broadcast_sd(pa + 3); c30 = _mm256_fmadd_pd(a, b0, c30); c31 = _mm256_fmadd_pd(a, b1, c31);
+        a = _mm256_broadcast_sd(pa + 4); c40 = _mm256_fmadd_pd(a, b0, c40); c41 = _mm256_fmadd_pd(a, b1, c41);
+        a = _mm256_broadcast_sd(pa + 5); c50 = _mm256_fmadd_pd(a, b0, c50); c51 = _mm256_fmadd_pd(a, b1, c51);
+        pa += MR;
+        pb += NR;
+    }
+    __m256d al = _mm256_set1_pd(alpha);
+#define RT_GEMM_STORE_ROW(r, lo, hi)                                                        \
+    do {                                                                                    \
+        double *cr = c + (r) * ldc;                                                         \
+        _mm256_storeu_pd(cr,     _mm256_fmadd_pd(al, lo, _mm256_loadu_pd(cr)));             \
+        _mm256_storeu_pd(cr + 4, _mm256_fmadd_pd(al, hi, _mm256_loadu_pd(cr + 4)));         \
+    } while (0)
+    RT_GEMM_STORE_ROW(0, c00, c01);
+    RT_GEMM_STORE_ROW(1, c10, c11);
+    RT_GEMM_STORE_ROW(2, c20, c21);
+    RT_GEMM_STORE_ROW(3, c30, c31);
+    RT_GEMM_STORE_ROW(4, c40, c41);
+    RT_GEMM_STORE_ROW(5, c50, c51);
+#undef RT_GEMM_STORE_ROW
+}
+#else
+static void kernel_6x8(size_t kc, const double *restrict pa, const double *restrict pb,
+                       double *restrict c, size_t ldc, double alpha) {
+    double acc[MR][NR] = {{0}};
+    for (size_t p = 0; p < kc; p++) {
+        for (int r = 0; r < MR; r++) {
+            double av = pa[r];
+            for (int j = 0; j < NR; j++) acc[r][j] += av * pb[j];
+        }
+        pa += MR;
+        pb += NR;
+    }
+    for (int r = 0; r < MR; r++) {
+        for (int j = 0; j < NR; j++) c[r * ldc + j] += alpha * acc[r][j];
+    }
+}
+#endif
+
+// ---------- macro-tile driver ----------
+
+typedef struct {
+    const rt_mat *a, *b;
+    rt_mat       *c;
+    double        alpha, beta;
+    size_t        tiles_m, tiles_n;
+    size_t        done;  // tiles finished (atomic)
+} gemm_job;
+
+static void scale_tile(rt_mat *c, size_t i0, size_t mc, size_t j0, size_t nc, double beta) {
+    if (beta == 1.0) return;
+    for (size_t i = 0; i < mc; i++) {
+        double *row = c->data + (i0 + i) * c->stride + j0;
+        if (beta == 0.0) memset(row, 0, nc * sizeof(double));
+        else for (size_t j = 0; j < nc; j++) row[j] *= beta;
+    }
+}
+
+static void run_tile(gemm_job *job, size_t t, double *pa, double *pb) {
+    const rt_mat *a = job->a, *b = job->b;
+    rt_mat *c = job->c;
+    size_t i0 = (t / job->tiles_n) * MC, j0 = (t % job->tiles_n) * NC;
+    size_t mc = c->rows - i0 < MC ? c->rows - i0 : MC;
+    size_t nc = c->cols - j0 < NC ? c->cols - j0 : NC;
+    size_t K = a->cols;
+    double edge[MR * NR];
+
+    scale_tile(c, i0, mc, j0, nc, job->beta);
+    for (size_t p0 = 0; p0 < K; p0 += KC) {
+        size_t kc = K - p0 < KC ? K - p0 : KC;
+        pack_b(b, p0, kc, j0, nc, pb);
+        pack_a(a, i0, mc, p0, kc, pa);
+        for (size_t jr = 0; jr < nc; jr += NR) {
+            size_t nr = nc - jr < NR ? nc - jr : NR;
+            for (size_t ir = 0; ir < mc; ir += MR) {
+                size_t mr = mc - ir < MR ? mc - ir : MR;
+                double *cc = c->data + (i0 + ir) * c->stride + j0 + jr;
+                const double *a_strip = pa + ir * kc, *b_strip = pb + jr * kc;
+                if (mr == MR && nr == NR) {
+                    kernel_6x8(kc, a_strip, b_strip, cc, c->stride, job->alpha);
+                } else {
+                    memset(edge, 0, sizeof(edge));
+                    kernel_6x8(kc, a_strip, b_strip, edge, NR, job->alpha);
+                    for (size_t r = 0; r < mr; r++)
+                        for (size_t j = 0; j < nr; j++) cc[r * c->stride + j] += edge[r * NR + j];
+                }
+            }
+        }
+    }
+}
+
+// Runs tiles [lo, hi). A chunk that cannot get its packing buffers leaves its tiles
+// undone; rt_gemm reports that.
+static void gemm_chunk(long lo, long hi, void *arg) {
+    gemm_job *job = arg;
+    double *pa = rt_alloc_aligned(MC * KC * sizeof(double), 64);
+    double *pb = rt_alloc_aligned(KC * NC * sizeof(double), 64);
+    if (pa && pb) {
+        for (long t = lo; t < hi; t++) run_tile(job, (size_t)t, pa, pb);
+        __atomic_fetch_add(&job->done, (size_t)(hi - lo), __ATOMIC_RELAXED);
+    }
+    rt_free(pa);
+    rt_free(pb);
+}
+
+int rt_gemm(const rt_mat *a, const rt_mat *b, rt_mat *c,
+            double alpha, double beta, int threads) {
+    if (!a || !b || !c || a->cols != b->rows || a->rows != c->rows || b->cols != c->cols) return 1;
+    if (c->rows == 0 || c->cols == 0) return 0;
+
+    gemm_job job = { a, b, c, alpha, beta,
+                     (c->rows + MC - 1) / MC, (c->cols + NC - 1) / NC, 0 };
+    long tiles = (long)(job.tiles_m * job.tiles_n);
+    if (threads == 1 || tiles == 1 ||
+        (double)a->rows * (double)a->cols * (double)b->cols < PAR_MIN_FMAS) {
+        gemm_chunk(0, tiles, &job);
+    } else {
+        rt_sched_init(threads);
+        rt_parallel_for(0, tiles, 0, gemm_chunk, &job);
+    }
+    return job.done == (size_t)tiles ? 0 : 2;
+}
+
+// ---------- views and Cholesky ----------
+
+rt_mat rt_mat_view(const rt_mat *m, size_t i0, size_t j0, size_t rows, size_t cols) {
+    rt_mat v = { m->data + i0 * m->stride + j0, rows, cols, m->stride };
+    return v;
+}
+
+// Unblocked Cholesky of the kb x kb diagonal block at (k, k).
+static int chol_diag(rt_mat *a, size_t k, size_t kb) {
+    for (size_t j = 0; j < kb; j++) {
+        double *rj = a->data + (k + j) * a->stride + k;
+        double d = rj[j];
+        for (size_t p = 0; p < j; p++) d -= rj[p] * rj[p];
+        if (!(d > 0.0)) return 3;
+        rj[j] = sqrt(d);
+        double inv = 1.0 / rj[j];
+        for (size_t i = j + 1; i < kb; i++) {
+            double *ri = a->data + (k + i) * a->stride + k;
+            double s = ri[j];
+            for (size_t p = 0; p < j; p++) s -= ri[p] * rj[p];
+            ri[j] = s * inv;
+        }
+    }
+    return 0;
+}
+
+// Panel rows below the diagonal block: L21 = A21 * L11^-T, one row at a time.
+static void chol_panel(rt_mat *a, size_t k, size_t kb) {
+    for (size_t i = k + kb; i < a->rows; i++) {
+        double *ri = a->data + i * a->stride + k;
+        for (size_t j = 0; j < kb; j++) {
+            const double *rj = a->data + (k + j) * a->stride + k;
+            double s = ri[j];
+            for (size_t p = 0; p < j; p++) s -= ri[p] * rj[p];
+            ri[j] = s / rj[j];
+        }
+    }
+}
+
+int rt_chol_factor(rt_mat *a, int threads) {
+    if (!a || a->rows != a->cols) return 1;
+    size_t n = a->rows;
+    rt_mat lt = { NULL, 0, 0, 0 };
+    if (n > CHOL_NB && rt_mat_alloc(&lt, CHOL_NB, n - CHOL_NB)) return 2;
+
+    int rc = 0;
+    for (size_t k = 0; k < n && rc == 0; k += CHOL_NB) {
+        size_t kb = n - k < CHOL_NB ? n - k : CHOL_NB;
+        if ((rc = chol_diag(a, k, kb)) != 0) break;
+        size_t m = n - k - kb;
+        if (m == 0) break;
+        chol_panel(a, k, kb);
+
+        // A22 -= L21 * L21^T, lower triangle only: column strip j gets rows j.. m.
+        rt_mat l21 = rt_mat_view(a, k + kb, k, m, kb);
+        rt_mat l21t = rt_mat_view(&lt, 0, 0, kb, m);
+        for (size_t i = 0; i < m; i++)
+            for (size_t j = 0; j < kb; j++) RT_MAT_AT(&l21t, j, i) = RT_MAT_AT(&l21, i, j);
+        for (size_t j = 0; j < m && rc == 0; j += CHOL_STRIP) {
+            size_t w = m - j < CHOL_STRIP ? m - j : CHOL_STRIP;
+            rt_mat lhs = rt_mat_view(&l21, j, 0, m - j, kb);
+            rt_mat rhs = rt_mat_view(&l21t, 0, j, kb, w);
+            rt_mat dst = rt_mat_view(a, k + kb + j, k + kb + j, m - j, w);
+            if (rt_gemm(&lhs, &rhs, &dst, -1.0, 1.0, threads)) rc = 2;
+        }
+    }
+    rt_mat_free(&lt);
+    return rc;
+}
+
+void rt_chol_solve(const rt_mat *l, double *x) {
+    size_t n = l->rows;
+    for (size_t i = 0; i < n; i++) {
+        const double *ri = l->data + i * l->stride;
+        double s = x[i];
+        for (size_t p = 0; p < i; p++) s -= ri[p] * x[p];
+        x[i] = s / ri[i];
+    }
+    for (size_t i = n; i-- > 0;) {
+        const double *ri = l->data + i * l->stride;
+        x[i] /= ri[i];
+        double xi = x[i];
+        for (size_t p = 0; p < i; p++) x[p] -= ri[p] * xi;
+    }
+}
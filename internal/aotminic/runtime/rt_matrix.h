@@ -0,0 +1,51 @@
+// rt_matrix.h
+// Dense row-major matrices and a packed, cache-blocked GEMM for Tenge AOT-generated C.
+//
+// Storage: one contiguous 64-byte-aligned block per matrix from rt_alloc_aligned (link
+// with rt_alloc.c); rows are padded to a multiple of 8 doubles (stride) so every row
+// starts on a cache-line boundary.
+// GEMM: Goto-style blocking (KC x NC panels of B, MC x KC blocks of A) around a
+// 6x8 register-blocked micro-kernel (AVX2/FMA when available, portable C otherwise).
+// C is split into MC x NC macro-tiles, run by the rt_sched pool (link with rt_sched.c).
+
+#pragma once
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    double *data;
+    size_t  rows;
+    size_t  cols;
+    size_t  stride;  // doubles between consecutive rows (>= cols)
+} rt_mat;
+
+#define RT_MAT_AT(m, i, j) ((m)->data[(size_t)(i) * (m)->stride + (size_t)(j)])
+
+// Allocates a zero-filled rows x cols matrix. Returns 0 on success.
+int  rt_mat_alloc(rt_mat *m, size_t rows, size_t cols);
+void rt_mat_free(rt_mat *m);
+
+// C = alpha * A * B + beta * C. threads == 1 runs on the caller; otherwise the tiles go
+// to the rt_sched pool, started with `threads` participants if it is not running yet
+// (<= 0: RT_THREADS, else every online CPU). Returns 0 on success, 1 on shape mismatch,
+// 2 if a tile was skipped for want of packing buffers.
+int  rt_gemm(const rt_mat *a, const rt_mat *b, rt_mat *c,
+             double alpha, double beta, int threads);
+
+// Sub-matrix view sharing storage with m (no copy, do not free).
+rt_mat rt_mat_view(const rt_mat *m, size_t i0, size_t j0, size_t rows, size_t cols);
+
+// In-place blocked Cholesky A = L * L^T of a symmetric positive definite matrix.
+// Only the lower triangle of the result is meaningful. Trailing updates go through
+// rt_gemm. Returns 0 on success, 1 on bad shape, 2 on OOM, 3 if A is not positive definite.
+int  rt_chol_factor(rt_mat *a, int threads);
+
+// Solves L * L^T * x = b in place (x holds b on entry) using a factor from rt_chol_factor.
+void rt_chol_solve(const rt_mat *l, double *x);
+
+#ifdef __cplusplus
+}
+#endif
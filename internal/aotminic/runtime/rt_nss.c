@@ -0,0 +1,494 @@
+// rt_nss.c
+// Batched NSS fitting: lockstep variable-projection Levenberg-Marquardt over blocks of
+// LANES curves.
+//
+// For fixed taus the model is linear in b, so every trial point solves the 4x4 weighted
+// least-squares problem for b exactly and LM only steps in the two tau coordinates. The
+// step uses Kaufman's reduced Jacobian, whose normal matrix is the Schur complement of
+// the full 6x6 J'J; without the projection LM crawls along the long b/tau valleys of
+// NSS for hundreds of iterations.
+// The tau coordinates are u = log tau1 and v = log(tau2 / tau1), boxed so that
+// tau2 >= 1.25 tau1: as tau1 -> tau2 the two humps become collinear, b2 and b3 diverge
+// with opposite signs and the SSE keeps creeping down without a finite minimizer.
+// A block's quotes are copied into contiguous LANES-wide rows (missing quotes get
+// weight 0). Every evaluation computes e^-x once per (maturity, tau) and derives L, C
+// and the derivatives from it:
+//   d y / d log tau1 = b1 * C(x1) + b2 * (C(x1) - x1 e^-x1),  d y / d log tau2 = b3 * (C(x2) - x2 e^-x2),
+//   d y / d u = d y / d log tau1 + d y / d log tau2,          d y / d v = d y / d log tau2.
+// vexp() is a branch-free exp (Cody-Waite reduction + degree-12 polynomial) so the
+// lane loops vectorize; libm's exp would keep them scalar.
+// Start values: the best point of a (tau1, tau2) grid; the basis at a grid pair is the
+// same for every curve, so the grid table is built once per batch.
+
+#include "rt_nss.h"
+#include "rt_sched.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LANES      8
+#define NP         6                 // b0..b3, u = log tau1, v = log(tau2 / tau1)
+#define NA         (NP * (NP + 1) / 2)  // packed lower triangle of J'J
+#define LAMBDA0    1e-3
+#define LAMBDA_MAX 1e10
+
+// Boxes for (u, v): tau1 in [0.05, 30] years, tau2 / tau1 in [1.25, 600].
+static const double k_lo[2] = { -3.0, 0.223 };
+static const double k_hi[2] = { 3.4, 6.4 };
+
+static const double k_tau1[] = { 0.25, 0.5, 1.0, 1.5, 2.0, 3.0, 5.0 };
+static const double k_tau2[] = { 1.0, 2.0, 3.0, 5.0, 7.5, 10.0, 15.0, 25.0 };
+#define N_TAU1 (sizeof(k_tau1) / sizeof(k_tau1[0]))
+#define N_TAU2 (sizeof(k_tau2) / sizeof(k_tau2[0]))
+
+typedef struct {
+    const double *mat;
+    size_t        n_mat;
+    const double *y;
+    size_t        n_curves;
+    int           max_iter;
+    double        tol;
+    rt_nss_fit   *out;
+    const double *grid;      // [pair][k][3]: L(t/tau1), C(t/tau1), C(t/tau2)
+    const double *grid_tau;  // [pair][2]
+    size_t        n_pairs;
+    size_t        blocks;
+    size_t        done;      // blocks finished (atomic)
+} nss_job;
+
+typedef struct {
+    double p[LANES][NP], pt[LANES][NP];
+    double cost[LANES], ct[LANES], lambda[LANES];
+    double a[NA][LANES], g[NP][LANES];
+    int    nobs[LANES], active[LANES], iters[LANES], status[LANES];
+} nss_block;
+
+static inline double vexp(double x) {
+    const double shift = 0x1.8p52, log2e = 1.4426950408889634;
+    const double ln2_hi = 6.93147180369123816490e-01, ln2_lo = 1.90821492927058770002e-10;
+    x = x < -700.0 ? -700.0 : x;
+    x = x > 700.0 ? 700.0 : x;
+    double kd = x * log2e + shift;   // round(x / ln2) in the low mantissa bits
+    uint64_t ki;
+    memcpy(&ki, &kd, sizeof ki);
+    kd -= shift;
+    double r = x - kd * ln2_hi - kd * ln2_lo;
+    double q = 1.0 / 479001600.0;
+    q = q * r + 1.0 / 39916800.0;
+    q = q * r + 1.0 / 3628800.0;
+    q = q * r + 1.0 / 362880.0;
+    q = q * r + 1.0 / 40320.0;
+    q = q * r + 1.0 / 5040.0;
+    q = q * r + 1.0 / 720.0;
+    q = q * r + 1.0 / 120.0;
+    q = q * r + 1.0 / 24.0;
+    q = q * r + 1.0 / 6.0;
+    q = q * r + 0.5;
+    q = q * r + 1.0;
+    q = q * r + 1.0;
+    uint64_t sb = (ki + 1023) << 52;  // 2^n; the offset bits of ki shift out
+    double scale;
+    memcpy(&scale, &sb, sizeof scale);
+    return q * scale;
+}
+
+static inline double clamp_box(double v, int a) {
+    return v < k_lo[a] ? k_lo[a] : (v > k_hi[a] ? k_hi[a] : v);
+}
+
+static void basis(double t, double tau, double *l, double *c) {
+    double x = t / tau, e = exp(-x);
+    *l = (1.0 - e) / x;
+    *c = *l - e;
+}
+
+// J'J (packed lower) and J'r of every lane at st->p.
+static void build_normal(const nss_job *job, const double *restrict yb, const double *restrict wb,
+                         nss_block *st) {
+    double b0[LANES], b1[LANES], b2[LANES], b3[LANES], i1[LANES], i2[LANES];
+    double jr[NP][LANES], r[LANES];
+    for (int j = 0; j < LANES; j++) {
+        b0[j] = st->p[j][0]; b1[j] = st->p[j][1]; b2[j] = st->p[j][2]; b3[j] = st->p[j][3];
+        i1[j] = exp(-st->p[j][4]); i2[j] = exp(-st->p[j][4] - st->p[j][5]);
+    }
+    memset(st->a, 0, sizeof st->a);
+    memset(st->g, 0, sizeof st->g);
+    for (size_t k = 0; k < job->n_mat; k++) {
+        double t = job->mat[k];
+        const double *yk = yb + k * LANES, *wk = wb + k * LANES;
+        for (int j = 0; j < LANES; j++) {
+            double x1 = t * i1[j], x2 = t * i2[j];
+            double e1 = vexp(-x1), e2 = vexp(-x2);
+            double l1 = (1.0 - e1) / x1, l2 = (1.0 - e2) / x2;
+            double c1 = l1 - e1, c2 = l2 - e2;
+            double w = wk[j];
+            jr[0][j] = w;
+            jr[1][j] = w * l1;
+            jr[2][j] = w * c1;
+            jr[3][j] = w * c2;
+            jr[5][j] = w * (b3[j] * (c2 - x2 * e2));
+            jr[4][j] = w * (b1[j] * c1 + b2[j] * (c1 - x1 * e1)) + jr[5][j];
+            r[j] = w * (yk[j] - (b0[j] + b1[j] * l1 + b2[j] * c1 + b3[j] * c2));
+        }
+        for (int u = 0, idx = 0; u < NP; u++) {
+            for (int v = 0; v <= u; v++, idx++) {
+                for (int j = 0; j < LANES; j++) st->a[idx][j] += jr[u][j] * jr[v][j];
+            }
+            for (int j = 0; j < LANES; j++) st->g[u][j] += jr[u][j] * r[j];
+        }
+    }
+}
+
+// In-place Cholesky of the n x n SPD matrix m (row-major, lower triangle). Returns 0 on success.
+static int chol_factor_small(double *m, int n) {
+    for (int c = 0; c < n; c++) {
+        double d = m[c * n + c];
+        for (int k = 0; k < c; k++) d -= m[c * n + k] * m[c * n + k];
+        if (!(d > 0.0)) return 1;
+        d = sqrt(d);
+        m[c * n + c] = d;
+        for (int i = c + 1; i < n; i++) {
+            double s = m[i * n + c];
+            for (int k = 0; k < c; k++) s -= m[i * n + k] * m[c * n + k];
+            m[i * n + c] = s / d;
+        }
+    }
+    return 0;
+}
+
+static void chol_subst_small(const double *m, double *b, int n) {
+    for (int i = 0; i < n; i++) {
+        double s = b[i];
+        for (int k = 0; k < i; k++) s -= m[i * n + k] * b[k];
+        b[i] = s / m[i * n + i];
+    }
+    for (int i = n - 1; i >= 0; i--) {
+        double s = b[i];
+        for (int k = i + 1; k < n; k++) s -= m[k * n + i] * b[k];
+        b[i] = s / m[i * n + i];
+    }
+}
+
+static inline int pidx(int u, int v) {
+    return u >= v ? u * (u + 1) / 2 + v : v * (v + 1) / 2 + u;
+}
+
+// b = argmin |W (y - B b)|^2 for lane j from the packed normal matrix n and B'W^2 y in v.
+static int solve_betas(const double (*n)[LANES], const double (*v)[LANES], int j, double b[4]) {
+    double m[16];
+    for (int u = 0; u < 4; u++) {
+        for (int c = 0; c < 4; c++) m[u * 4 + c] = n[pidx(u, c)][j];
+        b[u] = v[u][j];
+    }
+    double ridge = 1e-12 * (m[0] + m[5] + m[10] + m[15]);
+    for (int u = 0; u < 4; u++) m[u * 5] += ridge;
+    if (chol_factor_small(m, 4)) return 1;
+    chol_subst_small(m, b, 4);
+    return 0;
+}
+
+// Profiled fit of every lane at the taus in p[j][4..5]: writes the optimal betas to
+// p[j][0..3] and the weighted SSE to cost (INFINITY if the betas are not determined).
+// bb caches the basis [k][L1, C1, C2][lane] between the two passes.
+static void profile(const nss_job *job, const double *restrict yb, const double *restrict wb,
+                    double *restrict bb, double (*p)[NP], double *cost) {
+    double i1[LANES], i2[LANES], n[10][LANES], v[4][LANES], s[LANES];
+    double b0[LANES], b1[LANES], b2[LANES], b3[LANES];
+    for (int j = 0; j < LANES; j++) { i1[j] = exp(-p[j][4]); i2[j] = exp(-p[j][4] - p[j][5]); }
+    memset(n, 0, sizeof n);
+    memset(v, 0, sizeof v);
+    for (size_t k = 0; k < job->n_mat; k++) {
+        double t = job->mat[k];
+        const double *yk = yb + k * LANES, *wk = wb + k * LANES;
+        double *l1k = bb + 3 * k * LANES, *c1k = l1k + LANES, *c2k = c1k + LANES;
+        for (int j = 0; j < LANES; j++) {
+            double x1 = t * i1[j], x2 = t * i2[j];
+            double e1 = vexp(-x1), e2 = vexp(-x2);
+            double l1 = (1.0 - e1) / x1, c1 = l1 - e1, c2 = (1.0 - e2) / x2 - e2;
+            double w2 = wk[j] * wk[j], wy = w2 * yk[j];
+            l1k[j] = l1; c1k[j] = c1; c2k[j] = c2;
+            n[0][j] += w2;
+            n[1][j] += w2 * l1;  n[2][j] += w2 * l1 * l1;
+            n[3][j] += w2 * c1;  n[4][j] += w2 * c1 * l1; n[5][j] += w2 * c1 * c1;
+            n[6][j] += w2 * c2;  n[7][j] += w2 * c2 * l1; n[8][j] += w2 * c2 * c1; n[9][j] += w2 * c2 * c2;
+            v[0][j] += wy; v[1][j] += wy * l1; v[2][j] += wy * c1; v[3][j] += wy * c2;
+        }
+    }
+    for (int j = 0; j < LANES; j++) {
+        double b[4] = { 0.0, 0.0, 0.0, 0.0 };
+        cost[j] = solve_betas((const double (*)[LANES])n, (const double (*)[LANES])v, j, b) ? INFINITY : 0.0;
+        for (int u = 0; u < 4; u++) p[j][u] = b[u];
+        b0[j] = b[0]; b1[j] = b[1]; b2[j] = b[2]; b3[j] = b[3];
+        s[j] = 0.0;
+    }
+    for (size_t k = 0; k < job->n_mat; k++) {
+        const double *yk = yb + k * LANES, *wk = wb + k * LANES;
+        const double *l1k = bb + 3 * k * LANES, *c1k = l1k + LANES, *c2k = c1k + LANES;
+        for (int j = 0; j < LANES; j++) {
+            double r = wk[j] * (yk[j] - (b0[j] + b1[j] * l1k[j] + b2[j] * c1k[j] + b3[j] * c2k[j]));
+            s[j] += r * r;
+        }
+    }
+    for (int j = 0; j < LANES; j++) cost[j] += s[j];
+}
+
+// Reduced LM step in (u, v) for lane j: (S + lambda diag S) d = r, where
+// S = A_tt - A_tb A_bb^-1 A_bt and r = g_t - A_tb A_bb^-1 g_b. Returns 0 on success.
+static int tau_step(const nss_block *st, int j, double d[2]) {
+    double m[16], x[3][4];
+    for (int u = 0; u < 4; u++) {
+        for (int c = 0; c < 4; c++) m[u * 4 + c] = st->a[pidx(u, c)][j];
+        x[0][u] = st->a[pidx(4, u)][j];
+        x[1][u] = st->a[pidx(5, u)][j];
+        x[2][u] = st->g[u][j];
+    }
+    double ridge = 1e-12 * (m[0] + m[5] + m[10] + m[15]);
+    for (int u = 0; u < 4; u++) m[u * 5] += ridge;
+    if (chol_factor_small(m, 4)) return 1;
+    for (int c = 0; c < 3; c++) chol_subst_small(m, x[c], 4);
+
+    double s[4], r[2];
+    for (int a = 0; a < 2; a++) {
+        for (int b = 0; b < 2; b++) {
+            double v = st->a[pidx(4 + a, 4 + b)][j];
+            for (int u = 0; u < 4; u++) v -= st->a[pidx(4 + a, u)][j] * x[b][u];
+            s[a * 2 + b] = v;
+        }
+        r[a] = st->g[4 + a][j];
+        for (int u = 0; u < 4; u++) r[a] -= st->a[pidx(4 + a, u)][j] * x[2][u];
+    }
+    s[1] = s[2] = 0.5 * (s[1] + s[2]);
+    for (int a = 0; a < 2; a++) s[a * 3] += st->lambda[j] * s[a * 3] + 1e-14;
+    // A coordinate held at its bound by a gradient pointing outward stays fixed this step.
+    for (int a = 0; a < 2; a++) {
+        double lt = st->p[j][4 + a];
+        if ((lt <= k_lo[a] && r[a] < 0.0) || (lt >= k_hi[a] && r[a] > 0.0)) {
+            s[a * 2 + (1 - a)] = s[(1 - a) * 2 + a] = 0.0;
+            s[a * 3] = 1.0;
+            r[a] = 0.0;
+        }
+    }
+    if (chol_factor_small(s, 2)) return 1;
+    chol_subst_small(s, r, 2);
+    d[0] = r[0];
+    d[1] = r[1];
+    return 0;
+}
+
+// Best grid point per lane: betas by weighted linear least squares on the shared basis.
+static void grid_start(const nss_job *job, const double *restrict yb, const double *restrict wb,
+                       nss_block *st) {
+    double best[LANES], yy[LANES];
+    for (int j = 0; j < LANES; j++) { best[j] = INFINITY; yy[j] = 0.0; }
+    for (size_t k = 0; k < job->n_mat; k++) {
+        for (int j = 0; j < LANES; j++) {
+            double v = wb[k * LANES + j] * yb[k * LANES + j];
+            yy[j] += v * v;
+        }
+    }
+    for (size_t q = 0; q < job->n_pairs; q++) {
+        const double *gq = job->grid + q * job->n_mat * 3;
+        double n[10][LANES], v[4][LANES];
+        memset(n, 0, sizeof n);
+        memset(v, 0, sizeof v);
+        for (size_t k = 0; k < job->n_mat; k++) {
+            const double *row = gq + k * 3;
+            double f[4] = { 1.0, row[0], row[1], row[2] };
+            for (int j = 0; j < LANES; j++) {
+                double w2 = wb[k * LANES + j] * wb[k * LANES + j], wy = w2 * yb[k * LANES + j];
+                for (int u = 0, idx = 0; u < 4; u++) {
+                    for (int c = 0; c <= u; c++, idx++) n[idx][j] += w2 * f[u] * f[c];
+                    v[u][j] += wy * f[u];
+                }
+            }
+        }
+        for (int j = 0; j < LANES; j++) {
+            if (!st->active[j]) continue;
+            double b[4];
+            if (solve_betas((const double (*)[LANES])n, (const double (*)[LANES])v, j, b)) continue;
+            double sse = yy[j] - (b[0] * v[0][j] + b[1] * v[1][j] + b[2] * v[2][j] + b[3] * v[3][j]);
+            if (sse < best[j]) {
+                best[j] = sse;
+                for (int u = 0; u < 4; u++) st->p[j][u] = b[u];
+                st->p[j][4] = log(job->grid_tau[2 * q]);
+                st->p[j][5] = log(job->grid_tau[2 * q + 1] / job->grid_tau[2 * q]);
+            }
+        }
+    }
+}
+
+static void fit_block(const nss_job *job, size_t blk, double *restrict yb, double *restrict wb,
+                      double *restrict bb, nss_block *st) {
+    size_t nc = job->n_curves, nm = job->n_mat, c0 = blk * LANES;
+    int lanes = nc - c0 < LANES ? (int)(nc - c0) : LANES;
+
+    for (int j = 0; j < LANES; j++) st->nobs[j] = 0;
+    for (size_t k = 0; k < nm; k++) {
+        const double *row = job->y + k * nc + c0;
+        for (int j = 0; j < LANES; j++) {
+            int ok = j < lanes && isfinite(row[j]);
+            yb[k * LANES + j] = ok ? row[j] : 0.0;
+            wb[k * LANES + j] = ok ? 1.0 : 0.0;
+            st->nobs[j] += ok;
+        }
+    }
+    for (int j = 0; j < LANES; j++) {
+        st->active[j] = st->nobs[j] >= NP;
+        st->status[j] = st->active[j] ? RT_NSS_CONVERGED : RT_NSS_DEGENERATE;
+        st->iters[j] = 0;
+        st->lambda[j] = LAMBDA0;
+        // Harmless values for idle lanes; they ride along in the vector loops.
+        st->p[j][0] = st->p[j][1] = st->p[j][2] = st->p[j][3] = 0.0;
+        st->p[j][4] = 0.0;
+        st->p[j][5] = log(10.0);  // tau1 = 1, tau2 = 10
+        if (!st->active[j]) {
+            for (size_t k = 0; k < nm; k++) wb[k * LANES + j] = 0.0;
+        }
+    }
+
+    grid_start(job, yb, wb, st);
+    profile(job, yb, wb, bb, st->p, st->cost);
+
+    int rebuild = 1;
+    for (int it = 0; it < job->max_iter; it++) {
+        int any = 0;
+        for (int j = 0; j < LANES; j++) any |= st->active[j];
+        if (!any) break;
+        if (rebuild) build_normal(job, yb, wb, st);  // rejected lanes still have the same J
+
+        for (int j = 0; j < LANES; j++) {
+            memcpy(st->pt[j], st->p[j], sizeof st->pt[j]);
+            double d[2];
+            if (st->active[j] && tau_step(st, j, d) == 0) {
+                st->pt[j][4] = clamp_box(st->p[j][4] + d[0], 0);
+                st->pt[j][5] = clamp_box(st->p[j][5] + d[1], 1);
+            }
+        }
+        profile(job, yb, wb, bb, st->pt, st->ct);
+
+        rebuild = 0;
+        for (int j = 0; j < LANES; j++) {
+            if (!st->active[j]) continue;
+            st->iters[j]++;
+            if (st->ct[j] < st->cost[j]) {
+                double rel = (st->cost[j] - st->ct[j]) / st->cost[j];
+                memcpy(st->p[j], st->pt[j], sizeof st->p[j]);
+                st->cost[j] = st->ct[j];
+                st->lambda[j] = fmax(st->lambda[j] / 3.0, 1e-12);
+                rebuild = 1;
+                if (rel < job->tol || st->cost[j] < 1e-30) st->active[j] = 0;
+            } else {
+                st->lambda[j] *= 4.0;
+                // No decrease even along a tiny gradient step: at the optimum to rounding.
+                if (st->lambda[j] > LAMBDA_MAX) st->active[j] = 0;
+            }
+        }
+    }
+
+    for (int j = 0; j < lanes; j++) {
+        rt_nss_fit *o = &job->out[c0 + j];
+        if (st->status[j] == RT_NSS_DEGENERATE) {
+            o->beta[0] = o->beta[1] = o->beta[2] = o->beta[3] = NAN;
+            o->tau[0] = o->tau[1] = o->rmse = NAN;
+            o->iters = 0;
+            o->status = RT_NSS_DEGENERATE;
+            continue;
+        }
+        for (int u = 0; u < 4; u++) o->beta[u] = st->p[j][u];
+        o->tau[0] = exp(st->p[j][4]);
+        o->tau[1] = exp(st->p[j][4] + st->p[j][5]);
+        o->rmse = sqrt(st->cost[j] / st->nobs[j]);
+        o->iters = st->iters[j];
+        o->status = st->active[j] ? RT_NSS_MAXITER : RT_NSS_CONVERGED;
+    }
+}
+
+// Marks curves [c0, c1) as not fitted for lack of memory.
+static void mark_oom(rt_nss_fit *out, size_t c0, size_t c1) {
+    for (size_t c = c0; c < c1; c++) {
+        rt_nss_fit *o = &out[c];
+        o->beta[0] = o->beta[1] = o->beta[2] = o->beta[3] = NAN;
+        o->tau[0] = o->tau[1] = o->rmse = NAN;
+        o->iters = 0;
+        o->status = RT_NSS_OOM;
+    }
+}
+
+// Fits blocks [lo, hi). A chunk that cannot get its buffers marks its curves RT_NSS_OOM
+// and leaves them unfitted; rt_nss_fit_batch then returns 2.
+static void nss_chunk(long lo, long hi, void *arg) {
+    nss_job *job = arg;
+    double *yb = malloc(job->n_mat * LANES * sizeof(double));
+    double *wb = malloc(job->n_mat * LANES * sizeof(double));
+    double *bb = malloc(job->n_mat * 3 * LANES * sizeof(double));
+    nss_block *st = malloc(sizeof(nss_block));
+    if (yb && wb && bb && st) {
+        for (long b = lo; b < hi; b++) fit_block(job, (size_t)b, yb, wb, bb, st);
+        __atomic_fetch_add(&job->done, (size_t)(hi - lo), __ATOMIC_RELAXED);
+    } else {
+        size_t end = (size_t)hi * LANES < job->n_curves ? (size_t)hi * LANES : job->n_curves;
+        mark_oom(job->out, (size_t)lo * LANES, end);
+    }
+    free(yb);
+    free(wb);
+    free(bb);
+    free(st);
+}
+
+int rt_nss_fit_batch(const double *mat, size_t n_mat, const double *y, size_t n_curves,
+                     const rt_nss_opts *opts, rt_nss_fit *out) {
+    if (!mat || !y || !out || n_mat == 0) return 1;
+    for (size_t k = 0; k < n_mat; k++) {
+        if (!(mat[k] > 0.0)) return 1;
+    }
+    if (n_curves == 0) return 0;
+
+    double *grid = malloc(N_TAU1 * N_TAU2 * n_mat * 3 * sizeof(double));
+    double *grid_tau = malloc(N_TAU1 * N_TAU2 * 2 * sizeof(double));
+    if (!grid || !grid_tau) {
+        free(grid);
+        free(grid_tau);
+        mark_oom(out, 0, n_curves);
+        return 2;
+    }
+    size_t pairs = 0;
+    for (size_t a = 0; a < N_TAU1; a++) {
+        for (size_t b = 0; b < N_TAU2; b++) {
+            if (k_tau2[b] < 1.25 * k_tau1[a]) continue;
+            double *gq = grid + pairs * n_mat * 3;
+            for (size_t k = 0; k < n_mat; k++) {
+                double l2;
+                basis(mat[k], k_tau1[a], &gq[k * 3], &gq[k * 3 + 1]);
+                basis(mat[k], k_tau2[b], &l2, &gq[k * 3 + 2]);
+            }
+            grid_tau[2 * pairs] = k_tau1[a];
+            grid_tau[2 * pairs + 1] = k_tau2[b];
+            pairs++;
+        }
+    }
+
+    int threads = opts ? opts->threads : 0;
+    nss_job job = { mat, n_mat, y, n_curves,
+                    opts && opts->max_iter > 0 ? opts->max_iter : 100,
+                    opts && opts->tol > 0.0 ? opts->tol : 1e-10,
+                    out, grid, grid_tau, pairs, (n_curves + LANES - 1) / LANES, 0 };
+    if (threads == 1 || job.blocks == 1) {
+        nss_chunk(0, (long)job.blocks, &job);
+    } else {
+        rt_sched_init(threads);
+        rt_parallel_for(0, (long)job.blocks, 0, nss_chunk, &job);
+    }
+    free(grid);
+    free(grid_tau);
+    return job.done == job.blocks ? 0 : 2;
+}
+
+void rt_nss_eval(const rt_nss_fit *p, const double *mat, size_t n, double *out) {
+    for (size_t k = 0; k < n; k++) {
+        double l1, c1, l2, c2;
+        basis(mat[k], p->tau[0], &l1, &c1);
+        basis(mat[k], p->tau[1], &l2, &c2);
+        out[k] = p->beta[0] + p->beta[1] * l1 + p->beta[2] * c1 + p->beta[3] * c2;
+    }
+}
@@ -0,0 +1,54 @@
+// rt_nss.h
+// Batched Nelson-Siegel-Svensson yield-curve fitting for Tenge AOT-generated C.
+//
+// Model: y(t) = b0 + b1 * L(t/tau1) + b2 * C(t/tau1) + b3 * C(t/tau2),
+//   L(x) = (1 - e^-x) / x,  C(x) = L(x) - e^-x.
+// Each curve is fitted on squared yield errors by variable-projection Levenberg-Marquardt:
+// for fixed taus the betas are solved by weighted linear least squares, and LM steps only
+// in u = log tau1 and v = log(tau2 / tau1), boxed so that tau2 >= 1.25 tau1. The start is
+// the best point of a (tau1, tau2) grid whose basis functions are shared by every curve.
+// Layout: curves share one maturity grid; quotes are maturity-major (structure of
+// arrays), y[k * n_curves + c], so one maturity of a block of curves is contiguous.
+// A NaN quote marks a missing tenor for that curve.
+// Blocks of curves are run by the rt_sched pool (link with rt_sched.c).
+
+#pragma once
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    int    max_iter;  // LM iterations per curve (<= 0: 100)
+    double tol;       // stop when the relative SSE decrease of an accepted step < tol (<= 0: 1e-10)
+    int    threads;   // 1: run on the caller; else rt_sched pool size if not started (<= 0: default)
+} rt_nss_opts;
+
+// Per-curve fit status.
+#define RT_NSS_CONVERGED  0
+#define RT_NSS_MAXITER    1  // iteration cap reached; parameters are the best found
+#define RT_NSS_DEGENERATE 2  // fewer than 6 quotes; curve not fitted
+#define RT_NSS_OOM        3  // no memory for the curve's block buffers; curve not fitted
+
+typedef struct {
+    double beta[4];
+    double tau[2];
+    double rmse;    // root mean squared yield error over the quoted tenors
+    int    iters;
+    int    status;  // RT_NSS_*
+} rt_nss_fit;
+
+// Fits every curve of y (n_mat x n_curves, maturity-major) observed at maturities
+// mat[0 .. n_mat-1] (years, > 0). opts may be NULL. Returns 0 on success, 1 on bad
+// arguments, 2 on OOM (curves that could not be fitted have status RT_NSS_OOM; all other
+// entries of out are valid). Per-curve problems are reported in out[c].status.
+int rt_nss_fit_batch(const double *mat, size_t n_mat, const double *y, size_t n_curves,
+                     const rt_nss_opts *opts, rt_nss_fit *out);
+
+// Evaluates a fitted curve at n maturities.
+void rt_nss_eval(const rt_nss_fit *p, const double *mat, size_t n, double *out);
+
+#ifdef __cplusplus
+}
+#endif
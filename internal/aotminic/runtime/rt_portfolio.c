@@ -0,0 +1,285 @@
+// rt_portfolio.c
+// Min-variance / max-Sharpe solvers over a dense covariance matrix.
+
+#include "rt_portfolio.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEFAULT_MAX_ITER 2000
+#define DEFAULT_TOL      1e-8
+#define POWER_ITERS      30
+#define PROJ_BISECT      64
+#define ARMIJO_C         1e-4
+
+// ---------- small vector helpers ----------
+
+static double dot(const double *restrict a, const double *restrict b, size_t n) {
+    double s = 0.0;
+    for (size_t i = 0; i < n; i++) s += a[i] * b[i];
+    return s;
+}
+
+// y = S x, S symmetric row-major. Box-constrained iterates are mostly zeros, so when
+// x is sparse the product is accumulated from the rows of its nonzeros instead
+// (row j == column j), touching nnz rows of S rather than all n.
+static void symv(const rt_mat *s, const double *restrict x, double *restrict y) {
+    size_t n = s->rows, nnz = 0;
+    for (size_t j = 0; j < n; j++) nnz += x[j] != 0.0;
+    if (nnz * 2 > n) {
+        for (size_t i = 0; i < n; i++) y[i] = dot(s->data + i * s->stride, x, n);
+        return;
+    }
+    memset(y, 0, n * sizeof(double));
+    for (size_t j = 0; j < n; j++) {
+        double xj = x[j];
+        if (xj == 0.0) continue;
+        const double *restrict row = s->data + j * s->stride;
+        for (size_t i = 0; i < n; i++) y[i] += xj * row[i];
+    }
+}
+
+static double max_abs_diff(const double *a, const double *b, size_t n) {
+    double m = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        double d = fabs(a[i] - b[i]);
+        if (d > m) m = d;
+    }
+    return m;
+}
+
+static inline double lo_of(const rt_portfolio_opts *o, size_t i) { return o->lo ? o->lo[i] : -INFINITY; }
+static inline double hi_of(const rt_portfolio_opts *o, size_t i) { return o->hi ? o->hi[i] : INFINITY; }
+
+static inline double clampd(double x, double lo, double hi) { return x < lo ? lo : (x > hi ? hi : x); }
+
+// Without a box the budget-constrained optimum is a single linear solve, so the
+// Cholesky path is exact; with one, projected gradient runs from the start.
+static int unbounded(const rt_portfolio_opts *o) { return !o->lo && !o->hi; }
+
+// ---------- projection onto { sum(w) = 1, lo <= w <= hi } ----------
+
+static double shifted_sum(const rt_portfolio_opts *o, const double *v, size_t n, double tau) {
+    double s = 0.0;
+    for (size_t i = 0; i < n; i++) s += clampd(v[i] - tau, lo_of(o, i), hi_of(o, i));
+    return s;
+}
+
+// w = clip(v - tau, lo, hi) with tau chosen so that sum(w) == 1.
+static void project(const rt_portfolio_opts *o, const double *v, size_t n, double *w) {
+    double sv = 0.0;
+    for (size_t i = 0; i < n; i++) sv += v[i];
+    double t_lo = (sv - 1.0) / (double)n, t_hi = t_lo, step = 1.0;
+    while (shifted_sum(o, v, n, t_lo) < 1.0) { t_lo -= step; step *= 2.0; }
+    step = 1.0;
+    while (shifted_sum(o, v, n, t_hi) > 1.0) { t_hi += step; step *= 2.0; }
+    for (int it = 0; it < PROJ_BISECT && t_hi - t_lo > 1e-16; it++) {
+        double mid = 0.5 * (t_lo + t_hi);
+        if (shifted_sum(o, v, n, mid) > 1.0) t_lo = mid; else t_hi = mid;
+    }
+    // Snap: with the active set fixed, tau solves the budget equation exactly.
+    double tau = 0.5 * (t_lo + t_hi), bound_sum = 0.0, free_sum = 0.0;
+    size_t n_free = 0;
+    for (size_t i = 0; i < n; i++) {
+        double x = v[i] - tau, lo = lo_of(o, i), hi = hi_of(o, i);
+        if (x <= lo) bound_sum += lo;
+        else if (x >= hi) bound_sum += hi;
+        else { free_sum += v[i]; n_free++; }
+    }
+    if (n_free) tau = (free_sum + bound_sum - 1.0) / (double)n_free;
+    for (size_t i = 0; i < n; i++) w[i] = clampd(v[i] - tau, lo_of(o, i), hi_of(o, i));
+}
+
+// ---------- shared setup ----------
+
+static int check_args(const rt_mat *cov, const rt_portfolio_opts *o, const double *w) {
+    if (!cov || !o || !w || cov->rows == 0 || cov->rows != cov->cols) return RT_PORTFOLIO_EARGS;
+    size_t n = cov->rows;
+    double slo = 0.0, shi = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        if (lo_of(o, i) > hi_of(o, i)) return RT_PORTFOLIO_EINFEASIBLE;
+        slo += lo_of(o, i);
+        shi += hi_of(o, i);
+    }
+    return (slo > 1.0 || shi < 1.0) ? RT_PORTFOLIO_EINFEASIBLE : 0;
+}
+
+// Cholesky factor of a copy of cov. Returns 0, or nonzero if cov is not positive definite.
+static int factor_copy(const rt_mat *cov, int threads, rt_mat *l) {
+    size_t n = cov->rows;
+    if (rt_mat_alloc(l, n, n)) return RT_PORTFOLIO_ENOMEM;
+    for (size_t i = 0; i < n; i++) memcpy(l->data + i * l->stride, cov->data + i * cov->stride, n * sizeof(double));
+    int rc = rt_chol_factor(l, threads);
+    if (rc) rt_mat_free(l);
+    return rc;
+}
+
+// Solves S x = rhs with the factor and rescales to sum(x) == 1; 0 if the sum is not positive.
+static int budget_solution(const rt_mat *l, const double *rhs, double *x) {
+    size_t n = l->rows;
+    memcpy(x, rhs, n * sizeof(double));
+    rt_chol_solve(l, x);
+    double s = 0.0;
+    for (size_t i = 0; i < n; i++) s += x[i];
+    if (!(s > 0.0) || !isfinite(s)) return 0;
+    for (size_t i = 0; i < n; i++) x[i] /= s;
+    return 1;
+}
+
+// Largest eigenvalue of S by power iteration, capped by the Gershgorin bound.
+static double lambda_max(const rt_mat *s, double *x, double *y) {
+    size_t n = s->rows;
+    double gersh = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        double r = 0.0;
+        for (size_t j = 0; j < n; j++) r += fabs(RT_MAT_AT(s, i, j));
+        if (r > gersh) gersh = r;
+    }
+    for (size_t i = 0; i < n; i++) x[i] = 1.0 / sqrt((double)n);
+    double lam = 0.0;
+    for (int it = 0; it < POWER_ITERS; it++) {
+        symv(s, x, y);
+        double nrm = sqrt(dot(y, y, n));
+        if (!(nrm > 0.0)) break;
+        lam = nrm;
+        for (size_t i = 0; i < n; i++) x[i] = y[i] / nrm;
+    }
+    lam *= 1.05;  // power iteration approaches from below
+    return (lam > 0.0 && lam < gersh) ? lam : gersh;
+}
+
+static void fill_result(const rt_mat *cov, const double *mu, double rf, const double *w,
+                        double *tmp, int iters, rt_portfolio_result *res) {
+    if (!res) return;
+    size_t n = cov->rows;
+    symv(cov, w, tmp);
+    res->risk = sqrt(dot(w, tmp, n));
+    res->ret = mu ? dot(mu, w, n) : 0.0;
+    res->sharpe = (mu && res->risk > 0.0) ? (res->ret - rf) / res->risk : 0.0;
+    res->iters = iters;
+}
+
+// ---------- min-variance: FISTA with gradient restart ----------
+
+static int fista_min_variance(const rt_mat *cov, const rt_portfolio_opts *o, int max_iter, double tol,
+                              double *w, double *work) {
+    size_t n = cov->rows;
+    double *y = work, *g = work + n, *wp = work + 2 * n, *v = work + 3 * n;
+    double step = 1.0 / (2.0 * lambda_max(cov, g, v));
+    double t = 1.0;
+    memcpy(y, w, n * sizeof(double));
+    memcpy(wp, w, n * sizeof(double));
+    int it = 0;
+    for (; it < max_iter; it++) {
+        symv(cov, y, g);
+        for (size_t i = 0; i < n; i++) v[i] = y[i] - step * 2.0 * g[i];
+        project(o, v, n, w);
+        if (max_abs_diff(w, wp, n) < tol) { it++; break; }
+        // Restart momentum when it points against the last step.
+        double dirn = 0.0;
+        for (size_t i = 0; i < n; i++) dirn += (y[i] - w[i]) * (w[i] - wp[i]);
+        if (dirn > 0.0) {
+            t = 1.0;
+            memcpy(y, w, n * sizeof(double));
+        } else {
+            double tn = 0.5 * (1.0 + sqrt(1.0 + 4.0 * t * t));
+            double beta = (t - 1.0) / tn;
+            for (size_t i = 0; i < n; i++) y[i] = w[i] + beta * (w[i] - wp[i]);
+            t = tn;
+        }
+        memcpy(wp, w, n * sizeof(double));
+    }
+    return it;
+}
+
+int rt_portfolio_min_variance(const rt_mat *cov, const double *mu, const rt_portfolio_opts *opts,
+                              double *w, rt_portfolio_result *res) {
+    int rc = check_args(cov, opts, w);
+    if (rc) return rc;
+    size_t n = cov->rows;
+    int max_iter = opts->max_iter > 0 ? opts->max_iter : DEFAULT_MAX_ITER;
+    double tol = opts->tol > 0.0 ? opts->tol : DEFAULT_TOL;
+    double *work = malloc(4 * n * sizeof(double));
+    if (!work) return RT_PORTFOLIO_ENOMEM;
+
+    rt_mat l;
+    int have_closed = 0;
+    if (unbounded(opts) && factor_copy(cov, opts->threads, &l) == 0) {
+        for (size_t i = 0; i < n; i++) work[i] = 1.0;
+        have_closed = budget_solution(&l, work, w);
+        rt_mat_free(&l);
+    }
+    int iters = 0;
+    if (!have_closed) {
+        for (size_t i = 0; i < n; i++) w[i] = 1.0 / (double)n;
+        memcpy(work, w, n * sizeof(double));
+        project(opts, work, n, w);
+        iters = fista_min_variance(cov, opts, max_iter, tol, w, work);
+    }
+    fill_result(cov, mu, 0.0, w, work, iters, res);
+    free(work);
+    return 0;
+}
+
+// ---------- max-Sharpe: projected gradient ascent with Armijo backtracking ----------
+
+int rt_portfolio_max_sharpe(const rt_mat *cov, const double *mu, double rf,
+                            const rt_portfolio_opts *opts, double *w, rt_portfolio_result *res) {
+    int rc = check_args(cov, opts, w);
+    if (rc) return rc;
+    if (!mu) return RT_PORTFOLIO_EARGS;
+    size_t n = cov->rows;
+    int max_iter = opts->max_iter > 0 ? opts->max_iter : DEFAULT_MAX_ITER;
+    double tol = opts->tol > 0.0 ? opts->tol : DEFAULT_TOL;
+    double *work = malloc(5 * n * sizeof(double));
+    if (!work) return RT_PORTFOLIO_ENOMEM;
+    double *g = work, *sw = work + n, *wn = work + 2 * n, *swn = work + 3 * n, *v = work + 4 * n;
+
+    // Closed form: w ~ S^-1 (mu - rf), valid when sum(S^-1 (mu - rf)) > 0.
+    rt_mat l;
+    int have_closed = 0;
+    if (unbounded(opts) && factor_copy(cov, opts->threads, &l) == 0) {
+        for (size_t i = 0; i < n; i++) v[i] = mu[i] - rf;
+        have_closed = budget_solution(&l, v, w);
+        rt_mat_free(&l);
+    }
+    int iters = 0;
+    if (!have_closed) {
+        for (size_t i = 0; i < n; i++) w[i] = 1.0 / (double)n;
+        memcpy(v, w, n * sizeof(double));
+        project(opts, v, n, w);
+
+        symv(cov, w, sw);
+        double var = dot(w, sw, n);
+        double sr = (dot(mu, w, n) - rf) / sqrt(var);
+        double step = sqrt(var) / lambda_max(cov, g, v);
+        for (; iters < max_iter; iters++) {
+            double s = sqrt(var), e = dot(mu, w, n) - rf;
+            for (size_t i = 0; i < n; i++) g[i] = mu[i] / s - e * sw[i] / (s * s * s);
+            double srn = sr, varn = var;
+            int accepted = 0;
+            for (int bt = 0; bt < 40; bt++) {
+                for (size_t i = 0; i < n; i++) v[i] = w[i] + step * g[i];
+                project(opts, v, n, wn);
+                symv(cov, wn, swn);
+                varn = dot(wn, swn, n);
+                srn = (dot(mu, wn, n) - rf) / sqrt(varn);
+                double lin = 0.0;
+                for (size_t i = 0; i < n; i++) lin += g[i] * (wn[i] - w[i]);
+                if (srn >= sr + ARMIJO_C * lin) { accepted = 1; break; }
+                step *= 0.5;
+            }
+            if (!accepted) break;
+            double moved = max_abs_diff(wn, w, n);
+            memcpy(w, wn, n * sizeof(double));
+            memcpy(sw, swn, n * sizeof(double));
+            var = varn;
+            sr = srn;
+            step *= 2.0;
+            if (moved < tol) { iters++; break; }
+        }
+    }
+    fill_result(cov, mu, rf, w, v, iters, res);
+    free(work);
+    return 0;
+}
@@ -0,0 +1,51 @@
+// rt_portfolio.h
+// Mean-variance portfolio optimization for Tenge AOT-generated C.
+//
+// Problems (budget sum(w) = 1, optional per-asset box lo[i] <= w[i] <= hi[i]):
+//   min-variance:  minimize w' S w
+//   max-Sharpe:    maximize (mu' w - rf) / sqrt(w' S w)
+// Solver: without a box the optimum is S^-1 1 (resp. S^-1 (mu - rf)) rescaled to
+// the budget, taken from a blocked, GEMM-backed Cholesky solve (O(n^3/3)).
+// With a box: FISTA with adaptive restart for min-variance, monotone projected
+// ascent with Armijo backtracking for max-Sharpe; O(n * nnz(w)) per iteration.
+// Projection onto the budget+box set is exact (bisection on the budget multiplier).
+// Covariance: contiguous rt_mat, symmetric; only read, never modified.
+
+#pragma once
+#include <stddef.h>
+#include "rt_matrix.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    const double *lo;  // per-asset lower bounds, NULL = unbounded below
+    const double *hi;  // per-asset upper bounds, NULL = unbounded above
+    int    max_iter;   // projected-gradient iteration cap (<= 0: 2000)
+    double tol;        // stop when max |w_k+1 - w_k| < tol (<= 0: 1e-8)
+    int    threads;    // passed to rt_gemm for the Cholesky update (<= 0: all cores)
+} rt_portfolio_opts;
+
+typedef struct {
+    double ret;     // mu' w (0 for min-variance without mu)
+    double risk;    // sqrt(w' S w)
+    double sharpe;  // (ret - rf) / risk (0 for min-variance without mu)
+    int    iters;   // projected-gradient iterations (0 = closed form)
+} rt_portfolio_result;
+
+// Error codes (0 = OK).
+#define RT_PORTFOLIO_EARGS       1
+#define RT_PORTFOLIO_ENOMEM      2
+#define RT_PORTFOLIO_EINFEASIBLE 3  // sum(lo) > 1 or sum(hi) < 1
+
+// mu may be NULL; when given, res->ret and res->sharpe (with rf = 0) are filled in.
+int rt_portfolio_min_variance(const rt_mat *cov, const double *mu, const rt_portfolio_opts *opts,
+                              double *w, rt_portfolio_result *res);
+
+int rt_portfolio_max_sharpe(const rt_mat *cov, const double *mu, double rf,
+                            const rt_portfolio_opts *opts, double *w, rt_portfolio_result *res);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,188 @@
+// rt_prof.c
+// Calling-context tree, region enter/leave and the reports written at exit.
+
+#define _GNU_SOURCE
+#include "rt_prof.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define UNIT "TSC ticks"
+#else
+#include <time.h>
+#define UNIT "ns"
+#endif
+
+#define MAX_NODES (1u << 16)
+
+// A node is one calling context: a region entered from its parent's context. Children
+// are only ever added (under grow), and are published with a release store, so lookups
+// need no lock.
+struct rt_prof_node {
+    int                     site;
+    rt_prof_node           *parent;
+    _Atomic(rt_prof_node *) child;      // newest child; siblings are linked through next
+    rt_prof_node           *next;
+    _Atomic uint64_t        count;      // entries
+    _Atomic uint64_t        ticks;      // inclusive
+};
+
+static rt_prof_node        nodes[MAX_NODES];   // nodes[0] is the root
+static unsigned            nnodes = 1;         // under grow
+static atomic_flag         grow = ATOMIC_FLAG_INIT;
+static _Atomic uint64_t    lost;               // entries not recorded: the tree is full
+
+static const rt_prof_site *sites;
+static int                 nsites;
+static _Atomic uint64_t    site_incl[RT_PROF_MAX_SITES];   // outermost activations only
+
+static _Thread_local rt_prof_node *cur;                       // innermost open region
+static _Thread_local unsigned      active[RT_PROF_MAX_SITES]; // open regions per site
+
+static inline uint64_t ticks_begin(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_lfence();               // the code before has finished
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+static inline uint64_t ticks_end(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned aux;
+    uint64_t t = __rdtscp(&aux); // waits for the measured code
+    _mm_lfence();                // the code after waits for the read
+    return t;
+#else
+    return ticks_begin();
+#endif
+}
+
+static rt_prof_node *child(rt_prof_node *p, int site) {
+    for (rt_prof_node *c = atomic_load_explicit(&p->child, memory_order_acquire); c; c = c->next)
+        if (c->site == site) return c;
+    while (atomic_flag_test_and_set_explicit(&grow, memory_order_acquire)) {}
+    rt_prof_node *c = atomic_load_explicit(&p->child, memory_order_relaxed);
+    while (c && c->site != site) c = c->next;     // added meanwhile
+    if (!c && nnodes < MAX_NODES) {
+        c = &nodes[nnodes++];
+        c->site = site;
+        c->parent = p;
+        c->next = atomic_load_explicit(&p->child, memory_order_relaxed);
+        atomic_store_explicit(&p->child, c, memory_order_release);
+    }
+    atomic_flag_clear_explicit(&grow, memory_order_release);
+    return c;
+}
+
+rt_prof_scope rt_prof_enter(int site) {
+    rt_prof_scope s = {0};
+    if (!cur) cur = &nodes[0];
+    if (site < 0 || site >= nsites || !(s.node = child(cur, site))) {
+        atomic_fetch_add_explicit(&lost, 1, memory_order_relaxed);
+        return s;
+    }
+    atomic_fetch_add_explicit(&s.node->count, 1, memory_order_relaxed);
+    s.outer = active[site]++ == 0;
+    cur = s.node;
+    s.t0 = ticks_begin();
+    return s;
+}
+
+void rt_prof_leave(rt_prof_scope *s) {
+    uint64_t t1 = ticks_end();
+    if (!s->node) return;
+    uint64_t d = t1 - s->t0;
+    int site = s->node->site;
+    atomic_fetch_add_explicit(&s->node->ticks, d, memory_order_relaxed);
+    if (s->outer) atomic_fetch_add_explicit(&site_incl[site], d, memory_order_relaxed);
+    active[site]--;
+    cur = s->node->parent;
+}
+
+// ---- reports ----
+
+typedef struct {
+    int      site;
+    int64_t  self;
+    uint64_t count;
+} flat_row;
+
+static int by_self(const void *a, const void *b) {
+    int64_t x = ((const flat_row *)a)->self, y = ((const flat_row *)b)->self;
+    return (x < y) - (x > y);
+}
+
+static void write_stack(FILE *f, const rt_prof_node *n) {
+    if (n->parent != &nodes[0]) {
+        write_stack(f, n->parent);
+        fputc(';', f);
+    }
+    fputs(sites[n->site].name, f);
+}
+
+static void report(void) {
+    unsigned n = nnodes;
+    int64_t *self = calloc(n, sizeof *self);
+    flat_row *rows = calloc((size_t)nsites, sizeof *rows);
+    if (!self || !rows) return;
+    for (unsigned i = 1; i < n; i++) {
+        int64_t t = (int64_t)atomic_load(&nodes[i].ticks);
+        self[i] += t;
+        if (nodes[i].parent != &nodes[0]) self[nodes[i].parent - nodes] -= t;
+    }
+    int64_t total = 0;
+    for (int s = 0; s < nsites; s++) rows[s].site = s;
+    for (unsigned i = 1; i < n; i++) {
+        if (self[i] < 0) self[i] = 0;   // a region still open at exit has no ticks yet
+        rows[nodes[i].site].self += self[i];
+        rows[nodes[i].site].count += atomic_load(&nodes[i].count);
+        total += self[i];
+    }
+    qsort(rows, (size_t)nsites, sizeof *rows, by_self);
+
+    fprintf(stderr, "# flat profile (%s, total %lld)\n", UNIT, (long long)total);
+    fprintf(stderr, "#  self%% %18s %18s %14s  region\n", "self", "inclusive", "entries");
+    for (int r = 0; r < nsites && rows[r].count; r++) {
+        const flat_row *w = &rows[r];
+        fprintf(stderr, "%7.2f%% %18lld %18llu %14llu  %s (%s)\n",
+                total ? 100.0 * (double)w->self / (double)total : 0.0, (long long)w->self,
+                (unsigned long long)atomic_load(&site_incl[w->site]), (unsigned long long)w->count,
+                sites[w->site].name, sites[w->site].kind);
+    }
+    if (atomic_load(&lost))
+        fprintf(stderr, "# %llu region entries not recorded: more than %u calling contexts\n",
+                (unsigned long long)atomic_load(&lost), MAX_NODES - 1);
+
+    const char *path = getenv("RT_PROF_OUT");
+    if (!path || !*path) path = "tenge.folded";
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        fprintf(stderr, "# %s: cannot write collapsed stacks\n", path);
+    } else {
+        for (unsigned i = 1; i < n; i++) {
+            if (self[i] <= 0) continue;
+            write_stack(f, &nodes[i]);
+            fprintf(f, " %lld\n", (long long)self[i]);
+        }
+        fclose(f);
+        fprintf(stderr, "# collapsed stacks: %s\n", path);
+    }
+    free(rows);
+    free(self);
+}
+
+void rt_prof_register(const rt_prof_site *s, int n) {
+    if (n > RT_PROF_MAX_SITES) {
+        fprintf(stderr, "rt_prof: %d regions, only the first %d are profiled\n", n, RT_PROF_MAX_SITES);
+        n = RT_PROF_MAX_SITES;
+    }
+    sites = s;
+    nsites = n;
+    atexit(report);
+}
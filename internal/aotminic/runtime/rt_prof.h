@@ -0,0 +1,54 @@
+// rt_prof.h
+// Hot-path profiling for Tenge AOT-generated C (`tenge build --profile`).
+//
+// The emitter opens a region at the top of every function body and around every loop.
+// A region counts its entries and the ticks spent inside it: the time stamp counter,
+// read with rdtsc fenced by lfence (rdtscp + lfence at the end) so the reads stay in
+// place relative to the code they measure. Elsewhere ticks are CLOCK_MONOTONIC ns.
+// Regions are kept per calling context (main;solve;solve:for@L42), so recursive and
+// shared code is split by caller. Regions entered on worker threads start new stacks.
+//
+// At exit the runtime prints a flat profile to stderr (per region: self and inclusive
+// ticks, entries) and writes the collapsed stacks, weighted by self ticks, to
+// RT_PROF_OUT (default tenge.folded), the input format of flamegraph.pl, inferno and
+// speedscope. A region entry costs a few tens of cycles, so regions are not emitted in
+// static inline helpers: their time counts towards the caller.
+
+#pragma once
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RT_PROF_MAX_SITES 1024
+
+typedef struct {
+    const char *name;   // function, or function:for@Lline (line of the emitted C)
+    const char *kind;   // "func" or "loop"
+} rt_prof_site;
+
+typedef struct rt_prof_node rt_prof_node;
+
+typedef struct {
+    rt_prof_node *node;     // NULL: not recorded (the context tree is full)
+    uint64_t      t0;
+    int           outer;    // outermost open region of its site on this thread
+} rt_prof_scope;
+
+// Names the regions (index = RT_PROF_REGION argument) and schedules the reports at exit.
+void          rt_prof_register(const rt_prof_site *sites, int n);
+rt_prof_scope rt_prof_enter(int site);
+void          rt_prof_leave(rt_prof_scope *s);
+
+#define RT_PROF_CAT_(a, b) a##b
+#define RT_PROF_CAT(a, b)  RT_PROF_CAT_(a, b)
+
+// Opens region site until the end of the enclosing C scope (any return, break or goto).
+#define RT_PROF_REGION(site) \
+    rt_prof_scope RT_PROF_CAT(rt_prof_scope_, __COUNTER__) \
+        __attribute__((cleanup(rt_prof_leave), unused)) = rt_prof_enter(site)
+
+#ifdef __cplusplus
+}
+#endif
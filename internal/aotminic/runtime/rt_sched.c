@@ -0,0 +1,289 @@
+// rt_sched.c
+// Chase-Lev deques, the pinned worker pool (spin, then sleep until work is pushed),
+// spawn / sync with stealing while waiting, and parallel_for by recursive halving.
+
+#define _GNU_SOURCE
+#include "rt_sched.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define DEQ_CAP    8192    // tasks per deque (power of two); a full deque runs inline
+#define MAX_POOL   256
+#define SPIN_PAUSE 64      // idle rounds with a pause before yielding the CPU
+#define SPIN_IDLE  2048    // idle rounds before a worker sleeps
+
+// Lê, Pop, Cohen, Zappa Nardelli, "Correct and Efficient Work-Stealing for Weak Memory
+// Models" (PPoPP 2013), with a fixed ring: push refuses instead of growing.
+typedef struct {
+    _Alignas(64) atomic_long top;      // thieves take from here
+    _Alignas(64) atomic_long bottom;   // the owner pushes and takes here
+    _Atomic(rt_task *) buf[DEQ_CAP];
+} deque;
+
+static deque          *D;              // pool workers, then the external slots
+static int             n_workers;      // pool threads: participants - 1
+static int             n_threads;
+static int             want;           // rt_sched_init argument
+static int             pinning = 1;
+static pthread_once_t  once = PTHREAD_ONCE_INIT;
+static pthread_key_t   ext_key;
+static atomic_int      ext_used[RT_SCHED_MAX_EXT];
+
+static pthread_mutex_t idle_mu = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  idle_cv = PTHREAD_COND_INITIALIZER;
+static atomic_int      sleepers;
+static atomic_uint     epoch;          // bumped (under idle_mu) to wake a sleeper
+
+static _Thread_local int      self = -1;   // this thread's deque; -1: none yet
+static _Thread_local unsigned seed;
+
+// ---- deque ----
+
+static int push(deque *d, rt_task *t) {
+    long b = atomic_load_explicit(&d->bottom, memory_order_relaxed);
+    long top = atomic_load_explicit(&d->top, memory_order_acquire);
+    if (b - top >= DEQ_CAP) return 0;
+    atomic_store_explicit(&d->buf[b & (DEQ_CAP - 1)], t, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+    return 1;
+}
+
+static rt_task *take(deque *d) {
+    long b = atomic_load_explicit(&d->bottom, memory_order_relaxed) - 1;
+    atomic_store_explicit(&d->bottom, b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    long t = atomic_load_explicit(&d->top, memory_order_relaxed);
+    rt_task *x = NULL;
+    if (t <= b) {
+        x = atomic_load_explicit(&d->buf[b & (DEQ_CAP - 1)], memory_order_relaxed);
+        if (t == b) {   // last one: race the thieves for it
+            if (!atomic_compare_exchange_strong_explicit(&d->top, &t, t + 1, memory_order_seq_cst,
+                                                         memory_order_relaxed)) x = NULL;
+            atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+        }
+    } else {
+        atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+    }
+    return x;
+}
+
+static rt_task *steal(deque *d) {
+    long t = atomic_load_explicit(&d->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    long b = atomic_load_explicit(&d->bottom, memory_order_acquire);
+    if (t >= b) return NULL;
+    rt_task *x = atomic_load_explicit(&d->buf[t & (DEQ_CAP - 1)], memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&d->top, &t, t + 1, memory_order_seq_cst,
+                                                 memory_order_relaxed)) return NULL;
+    return x;
+}
+
+static int n_deques(void) { return n_workers + RT_SCHED_MAX_EXT; }
+
+// One pass over the other deques from a random start.
+static rt_task *steal_any(int me) {
+    int n = n_deques();
+    seed = seed * 1103515245u + 12345u;
+    int start = (int)((seed >> 8) % (unsigned)n);
+    for (int k = 0; k < n; k++) {
+        int v = start + k < n ? start + k : start + k - n;
+        if (v == me) continue;
+        rt_task *x = steal(&D[v]);
+        if (x) return x;
+    }
+    return NULL;
+}
+
+static int any_work(void) {
+    for (int v = 0; v < n_deques(); v++) {
+        if (atomic_load_explicit(&D[v].top, memory_order_relaxed) <
+            atomic_load_explicit(&D[v].bottom, memory_order_relaxed)) return 1;
+    }
+    return 0;
+}
+
+static inline void run(rt_task *t) {
+    t->fn(t->ctx);
+    atomic_store_explicit(&t->done, 1, memory_order_release);
+}
+
+static inline void cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+// ---- pool ----
+
+static void wake_one(void) {
+    atomic_thread_fence(memory_order_seq_cst);   // the push before the sleeper check
+    if (!atomic_load_explicit(&sleepers, memory_order_relaxed)) return;
+    pthread_mutex_lock(&idle_mu);
+    atomic_fetch_add(&epoch, 1);
+    pthread_cond_signal(&idle_cv);
+    pthread_mutex_unlock(&idle_mu);
+}
+
+// Sleeps unless work shows up after the sleeper count went up; a push either sees the
+// count or is seen by the check.
+static void idle_wait(void) {
+    unsigned key = atomic_load(&epoch);
+    atomic_fetch_add(&sleepers, 1);
+    if (!any_work()) {
+        pthread_mutex_lock(&idle_mu);
+        while (atomic_load(&epoch) == key) pthread_cond_wait(&idle_cv, &idle_mu);
+        pthread_mutex_unlock(&idle_mu);
+    }
+    atomic_fetch_sub(&sleepers, 1);
+}
+
+// Worker i runs on the (i + 1)-th CPU of the process's affinity mask.
+static void pin(int i) {
+#ifdef __linux__
+    cpu_set_t all, one;
+    if (!pinning || sched_getaffinity(0, sizeof(all), &all) != 0) return;
+    int n = CPU_COUNT(&all), want_k = (i + 1) % (n > 0 ? n : 1);
+    for (size_t c = 0, k = 0; c < CPU_SETSIZE; c++) {
+        if (!CPU_ISSET(c, &all)) continue;
+        if (k++ != (size_t)want_k) continue;
+        CPU_ZERO(&one); CPU_SET(c, &one);
+        pthread_setaffinity_np(pthread_self(), sizeof(one), &one);
+        return;
+    }
+#else
+    (void)i;
+#endif
+}
+
+static void *worker_main(void *arg) {
+    int me = (int)(intptr_t)arg;
+    self = me; seed = 0x9e3779b9u * (unsigned)(me + 1);
+    pin(me);
+    for (int idle = 0;;) {
+        rt_task *x = take(&D[me]);
+        if (!x) x = steal_any(me);
+        if (x) { run(x); idle = 0; continue; }
+        if (++idle < SPIN_PAUSE) cpu_relax();
+        else if (idle < SPIN_IDLE) sched_yield();
+        else { idle_wait(); idle = 0; }
+    }
+    return NULL;
+}
+
+static void ext_release(void *slot) {
+    atomic_store(&ext_used[(intptr_t)slot - 1 - n_workers], 0);
+}
+
+static int default_threads(void) {
+    const char *env = getenv("RT_THREADS");
+    if (env && atoi(env) > 0) return atoi(env);
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+}
+
+static void start(void) {
+    int n = want > 0 ? want : default_threads();
+    if (n > MAX_POOL) n = MAX_POOL;
+    const char *pin_env = getenv("RT_PIN");
+    pinning = !(pin_env && strcmp(pin_env, "0") == 0);
+    pthread_key_create(&ext_key, ext_release);
+
+    void *p = NULL;
+    size_t bytes = (size_t)(n - 1 + RT_SCHED_MAX_EXT) * sizeof(deque);
+    if (posix_memalign(&p, 64, bytes) != 0) { n_threads = 1; return; }   // D stays NULL: inline
+    memset(p, 0, bytes);
+    D = p;
+    n_workers = n - 1;
+    n_threads = 1;
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    for (int i = 0; i < n_workers; i++) {
+        pthread_t tid;
+        if (pthread_create(&tid, &attr, worker_main, (void *)(intptr_t)i) == 0) n_threads++;
+    }
+    pthread_attr_destroy(&attr);
+}
+
+int rt_sched_init(int threads) {
+    want = threads;
+    pthread_once(&once, start);
+    return n_threads;
+}
+
+int rt_sched_threads(void) {
+    pthread_once(&once, start);
+    return n_threads;
+}
+
+// The caller's deque: a worker's own, or a free external slot (kept until thread exit).
+// -1 if none is free.
+static int my_deque(void) {
+    if (self >= 0) return self;
+    pthread_once(&once, start);
+    if (!D) return -1;
+    for (int k = 0; k < RT_SCHED_MAX_EXT; k++) {
+        int z = 0;
+        if (!atomic_compare_exchange_strong(&ext_used[k], &z, 1)) continue;
+        self = n_workers + k;
+        seed = 0x85ebca6bu * (unsigned)(self + 1);
+        pthread_setspecific(ext_key, (void *)(intptr_t)(self + 1));
+        return self;
+    }
+    return -1;
+}
+
+// ---- API ----
+
+void rt_spawn(rt_task *t, void (*fn)(void *ctx), void *ctx) {
+    t->fn = fn; t->ctx = ctx;
+    atomic_store_explicit(&t->done, 0, memory_order_relaxed);
+    int me = my_deque();
+    if (me < 0 || !push(&D[me], t)) { run(t); return; }
+    if (n_workers) wake_one();
+}
+
+void rt_sync(rt_task *t) {
+    int me = self;
+    for (int spins = 0; !atomic_load_explicit(&t->done, memory_order_acquire);) {
+        rt_task *x = me >= 0 ? take(&D[me]) : NULL;
+        if (!x && D) x = steal_any(me);
+        if (x) { run(x); spins = 0; continue; }
+        if (++spins < SPIN_PAUSE) cpu_relax(); else sched_yield();
+    }
+}
+
+typedef struct {
+    long lo, hi, grain;
+    void (*fn)(long lo, long hi, void *ctx);
+    void *ctx;
+} pf_range;
+
+static void pf_run(void *arg) {
+    pf_range *r = arg;
+    if (r->hi - r->lo <= r->grain) { r->fn(r->lo, r->hi, r->ctx); return; }
+    long mid = r->lo + (r->hi - r->lo) / 2;
+    pf_range left = { r->lo, mid, r->grain, r->fn, r->ctx }, right = { mid, r->hi, r->grain, r->fn, r->ctx };
+    rt_task t;
+    rt_spawn(&t, pf_run, &right);
+    pf_run(&left);
+    rt_sync(&t);
+}
+
+void rt_parallel_for(long begin, long end, long grain,
+                     void (*fn)(long lo, long hi, void *ctx), void *ctx) {
+    if (end <= begin) return;
+    if (grain <= 0) {
+        grain = (end - begin) / (8L * rt_sched_threads());
+        if (grain < 1) grain = 1;
+    }
+    pf_range all = { begin, end, grain, fn, ctx };
+    pf_run(&all);
+}
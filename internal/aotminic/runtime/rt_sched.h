@@ -0,0 +1,51 @@
+// rt_sched.h
+// Work-stealing fork-join scheduler for Tenge AOT-generated C.
+//
+// A process-wide pool of RT_THREADS (default: every online CPU) participants, each with
+// a Chase-Lev deque: the pool starts threads - 1 workers pinned to distinct CPUs, and the
+// thread that calls into the scheduler takes part as well, as in the other runtime
+// kernels. rt_spawn pushes a task on the caller's deque (owner end, no locks); rt_sync
+// runs the caller's own tasks newest first and, once its child has been stolen, steals
+// from random victims until the child is done. Idle workers spin briefly, then sleep
+// until new work is pushed.
+// Tasks are caller-owned (typically on the spawning function's stack), so spawning does
+// not allocate. A full deque runs the task inline.
+// Up to RT_SCHED_MAX_EXT threads outside the pool can drive it at once; further ones
+// run their tasks inline (serially).
+
+#pragma once
+#include <stdatomic.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RT_SCHED_MAX_EXT 8
+
+typedef struct rt_task {
+    void      (*fn)(void *ctx);
+    void       *ctx;
+    atomic_int  done;
+} rt_task;
+
+// Starts the pool with `threads` participants (<= 0: RT_THREADS, else every online CPU).
+// Optional: the first rt_spawn starts it with the default. Returns the participant count;
+// later calls return the running pool's count.
+int  rt_sched_init(int threads);
+int  rt_sched_threads(void);
+
+// Makes fn(ctx) available to run in parallel with the caller. t must stay valid until
+// rt_sync(t) returns.
+void rt_spawn(rt_task *t, void (*fn)(void *ctx), void *ctx);
+// Returns once t has run, executing other tasks meanwhile.
+void rt_sync(rt_task *t);
+
+// Calls fn(lo, hi, ctx) over disjoint subranges covering [begin, end), in parallel. Ranges
+// are split in halves down to at most `grain` iterations (<= 0: about 8 pieces per
+// participant), and the halves are spawned, so idle participants steal large pieces first.
+void rt_parallel_for(long begin, long end, long grain,
+                     void (*fn)(long lo, long hi, void *ctx), void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,52 @@
+// rt_slice.h
+// Bounds checks for slices in Tenge AOT-generated C.
+//
+// A `[]T` (std/ffi Slice[T] { ptr, len }) is passed around as a pointer plus its length;
+// the emitter's range analysis leaves an index unchecked where it is provably in
+// [0, len), replaces the checks of a counted loop by one range check before the loop
+// (lifted, under a guard, past enclosing loops that cannot change or skip it), and
+// wraps every other index in RT_AT. A failed check reports the C location and
+// aborts.
+// Build with -DRT_NO_BOUNDS_CHECK to compile all checks out (for comparison only).
+
+#pragma once
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+__attribute__((noreturn, cold, noinline, unused))
+static void rt_bounds_fail(const char *file, int line, long lo, long hi, size_t len) {
+    if (hi == lo + 1) fprintf(stderr, "%s:%d: index %ld out of range [0, %zu)\n", file, line, lo, len);
+    else fprintf(stderr, "%s:%d: range [%ld, %ld) out of range [0, %zu)\n", file, line, lo, hi, len);
+    abort();
+}
+
+static inline size_t rt_index(long i, size_t len, const char *file, int line) {
+#ifndef RT_NO_BOUNDS_CHECK
+    if (__builtin_expect((size_t)i >= len, 0)) rt_bounds_fail(file, line, i, i + 1, len);
+#else
+    (void)len; (void)file; (void)line;
+#endif
+    return (size_t)i;
+}
+
+// Every index of [lo, hi) is valid (nothing to check when the range is empty).
+static inline void rt_check_range(long lo, long hi, size_t len, const char *file, int line) {
+#ifndef RT_NO_BOUNDS_CHECK
+    if (__builtin_expect(lo < hi && (lo < 0 || (size_t)hi > len), 0)) rt_bounds_fail(file, line, lo, hi, len);
+#else
+    (void)lo; (void)hi; (void)len; (void)file; (void)line;
+#endif
+}
+
+// p[i], checked against len.
+#define RT_AT(p, len, i)          ((p)[rt_index((long)(i), (size_t)(len), __FILE__, __LINE__)])
+#define RT_CHECK_RANGE(len, lo, hi) rt_check_range((long)(lo), (long)(hi), (size_t)(len), __FILE__, __LINE__)
+
+#ifdef __cplusplus
+}
+#endif
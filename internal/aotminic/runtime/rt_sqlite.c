@@ -3,6 +3,8 @@
 
 #include "rt_sqlite.h"
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 int rt_sqlite_open(const char *path, rt_db *out) {
     if (!out) return 1;
@@ -15,6 +17,41 @@ int rt_sqlite_open(const char *path, rt_db *out) {
     return 0;
 }
 
+int rt_sqlite_open_opts(const char *path, const rt_sqlite_opts *opts, rt_db *out) {
+    if (!out) return 1;
+    out->db = NULL;
+    rt_sqlite_opts o = opts ? *opts : (rt_sqlite_opts){0};
+    int flags = o.read_only ? SQLITE_OPEN_READONLY : SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE;
+    int rc = sqlite3_open_v2(path, &out->db, flags, NULL);
+    if (rc != SQLITE_OK) {
+        fprintf(stderr, "rt_sqlite_open failed: %s\n", out->db ? sqlite3_errmsg(out->db) : "(null)");
+        sqlite3_close(out->db);
+        out->db = NULL;
+        return rc ? rc : 1;
+    }
+    if (o.busy_ms > 0) sqlite3_busy_timeout(out->db, o.busy_ms);
+
+    static const char *const sync_sql[] = {
+        NULL, "PRAGMA synchronous=OFF;", "PRAGMA synchronous=NORMAL;", "PRAGMA synchronous=FULL;",
+    };
+    char sql[96];
+    rc = 0;
+    if (!rc && o.wal && !o.read_only) rc = rt_sqlite_exec(out, "PRAGMA journal_mode=WAL;");
+    if (!rc && o.synchronous > 0 && o.synchronous <= RT_SQLITE_SYNC_FULL)
+        rc = rt_sqlite_exec(out, sync_sql[o.synchronous]);
+    if (!rc && o.mmap_bytes > 0) {
+        snprintf(sql, sizeof(sql), "PRAGMA mmap_size=%lld;", o.mmap_bytes);
+        rc = rt_sqlite_exec(out, sql);
+    }
+    if (!rc && o.cache_kib > 0) {
+        snprintf(sql, sizeof(sql), "PRAGMA cache_size=-%d;", o.cache_kib);
+        rc = rt_sqlite_exec(out, sql);
+    }
+    if (!rc && o.read_only) rc = rt_sqlite_exec(out, "PRAGMA query_only=1;");
+    if (rc) rt_sqlite_close(out);
+    return rc;
+}
+
 int rt_sqlite_exec(rt_db *db, const char *sql) {
     if (!db || !db->db || !sql) return 1;
     char *errmsg = NULL;
@@ -32,4 +69,101 @@ int rt_sqlite_close(rt_db *db) {
     int rc = sqlite3_close(db->db);
     db->db = NULL;
     return rc == SQLITE_OK ? 0 : rc;
-}
\ No newline at end of file
+}
+
+int rt_stmt_cache_init(rt_stmt_cache *c, rt_db *db, const char *const *sql, int n) {
+    if (!c) return 1;
+    c->db = db; c->stmts = NULL; c->n = 0;
+    if (!db || !db->db || !sql || n <= 0) return 1;
+    sqlite3_stmt **st = calloc((size_t)n, sizeof(*st));
+    if (!st) return SQLITE_NOMEM;
+    for (int i = 0; i < n; i++) {
+        int rc = sqlite3_prepare_v3(db->db, sql[i], -1, SQLITE_PREPARE_PERSISTENT, &st[i], NULL);
+        if (rc != SQLITE_OK) {
+            fprintf(stderr, "rt_stmt_cache_init: %s\n  in: %s\n", sqlite3_errmsg(db->db), sql[i]);
+            for (int j = 0; j < i; j++) sqlite3_finalize(st[j]);
+            free(st);
+            return rc;
+        }
+    }
+    c->stmts = st; c->n = n;
+    return 0;
+}
+
+sqlite3_stmt *rt_stmt_get(rt_stmt_cache *c, int id) {
+    if (!c || id < 0 || id >= c->n) return NULL;
+    return c->stmts[id];
+}
+
+void rt_stmt_done(sqlite3_stmt *st) {
+    if (!st) return;
+    sqlite3_reset(st);
+    sqlite3_clear_bindings(st);
+}
+
+void rt_stmt_cache_free(rt_stmt_cache *c) {
+    if (!c) return;
+    for (int i = 0; i < c->n; i++) sqlite3_finalize(c->stmts[i]);
+    free(c->stmts);
+    c->stmts = NULL; c->n = 0;
+}
+
+int rt_db_pool_open(const char *path, const rt_sqlite_opts *opts, int n_readers, rt_db_pool *p) {
+    if (!p || !path || n_readers <= 0) return 1;
+    memset(p, 0, sizeof(*p));
+    pthread_mutex_init(&p->mu, NULL);
+    pthread_cond_init(&p->cv, NULL);
+    pthread_mutex_init(&p->write_mu, NULL);
+    rt_sqlite_opts o = opts ? *opts : (rt_sqlite_opts){0};
+    o.wal = 1; o.read_only = 0;
+    int rc = rt_sqlite_open_opts(path, &o, &p->writer);
+    if (rc) { rt_db_pool_close(p); return rc; }
+
+    p->readers = calloc((size_t)n_readers, sizeof(rt_db));
+    p->free_ids = calloc((size_t)n_readers, sizeof(int));
+    if (!p->readers || !p->free_ids) { rt_db_pool_close(p); return SQLITE_NOMEM; }
+    o.read_only = 1;
+    for (int i = 0; i < n_readers; i++) {
+        rc = rt_sqlite_open_opts(path, &o, &p->readers[i]);
+        if (rc) { rt_db_pool_close(p); return rc; }
+        p->n_readers = i + 1;
+        p->free_ids[p->n_free++] = i;
+    }
+    return 0;
+}
+
+rt_db *rt_db_pool_acquire(rt_db_pool *p) {
+    pthread_mutex_lock(&p->mu);
+    while (p->n_free == 0) pthread_cond_wait(&p->cv, &p->mu);
+    rt_db *db = &p->readers[p->free_ids[--p->n_free]];
+    pthread_mutex_unlock(&p->mu);
+    return db;
+}
+
+void rt_db_pool_release(rt_db_pool *p, rt_db *reader) {
+    if (!reader) return;
+    pthread_mutex_lock(&p->mu);
+    p->free_ids[p->n_free++] = (int)(reader - p->readers);
+    pthread_cond_signal(&p->cv);
+    pthread_mutex_unlock(&p->mu);
+}
+
+rt_db *rt_db_pool_writer_lock(rt_db_pool *p) {
+    pthread_mutex_lock(&p->write_mu);
+    return &p->writer;
+}
+
+void rt_db_pool_writer_unlock(rt_db_pool *p) {
+    pthread_mutex_unlock(&p->write_mu);
+}
+
+void rt_db_pool_close(rt_db_pool *p) {
+    if (!p) return;
+    for (int i = 0; i < p->n_readers; i++) rt_sqlite_close(&p->readers[i]);
+    rt_sqlite_close(&p->writer);
+    free(p->readers); free(p->free_ids);
+    pthread_mutex_destroy(&p->mu);
+    pthread_cond_destroy(&p->cv);
+    pthread_mutex_destroy(&p->write_mu);
+    memset(p, 0, sizeof(*p));
+}
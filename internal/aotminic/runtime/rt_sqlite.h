@@ -2,6 +2,7 @@
 // Minimal bridge API for SQLite to be used by Tenge AOT-generated C.
 
 #pragma once
+#include <pthread.h>
 #include <sqlite3.h>
 
 #ifdef __cplusplus
@@ -12,10 +13,77 @@ typedef struct {
     sqlite3 *db;
 } rt_db;
 
+// PRAGMA synchronous levels for rt_sqlite_opts.synchronous.
+#define RT_SQLITE_SYNC_DEFAULT 0  // leave SQLite's default (FULL)
+#define RT_SQLITE_SYNC_OFF     1
+#define RT_SQLITE_SYNC_NORMAL  2  // with WAL: durable except for the last commits on power loss
+#define RT_SQLITE_SYNC_FULL    3
+
+// Connection tuning applied by rt_sqlite_open_opts. A zeroed struct keeps every SQLite
+// default, so rt_sqlite_open_opts(path, &(rt_sqlite_opts){0}, db) == rt_sqlite_open.
+typedef struct {
+    int       wal;          // 1: journal_mode=WAL (readers no longer block on the writer)
+    int       synchronous;  // RT_SQLITE_SYNC_*
+    long long mmap_bytes;   // > 0: PRAGMA mmap_size
+    int       cache_kib;    // > 0: PRAGMA cache_size = -cache_kib (page cache per connection)
+    int       busy_ms;      // > 0: sqlite3_busy_timeout
+    int       read_only;    // 1: SQLITE_OPEN_READONLY + PRAGMA query_only
+} rt_sqlite_opts;
+
 int  rt_sqlite_open(const char *path, rt_db *out);
+// Opens path with the given tuning (opts may be NULL). Returns 0 or an SQLite error
+// code; on failure out->db is closed and NULL.
+int  rt_sqlite_open_opts(const char *path, const rt_sqlite_opts *opts, rt_db *out);
 int  rt_sqlite_exec(rt_db *db, const char *sql);
 int  rt_sqlite_close(rt_db *db);
 
+// Prepared-statement cache: a fixed table of SQL texts prepared once on one connection
+// and handed out by index. Each statement is reused through sqlite3_reset and
+// sqlite3_clear_bindings instead of being re-parsed per call. Like the connection it
+// belongs to, a cache must only be used by one thread at a time.
+typedef struct {
+    rt_db         *db;
+    sqlite3_stmt **stmts;
+    int            n;
+} rt_stmt_cache;
+
+// Prepares sql[0 .. n-1] on db. Returns 0, or the SQLite error code of the first
+// statement that fails to prepare (the cache is then left empty).
+int  rt_stmt_cache_init(rt_stmt_cache *c, rt_db *db, const char *const *sql, int n);
+// Statement `id`, ready to bind and step; NULL if id is out of range.
+sqlite3_stmt *rt_stmt_get(rt_stmt_cache *c, int id);
+// Returns a statement taken with rt_stmt_get: resets it (ending its read transaction)
+// and clears its bindings.
+void rt_stmt_done(sqlite3_stmt *st);
+void rt_stmt_cache_free(rt_stmt_cache *c);
+
+// One writer connection and n read-only connections on the same database file. With
+// WAL, readers see the last committed state and run concurrently with the writer.
+// Readers are checked out and returned; the writer is serialized by a mutex.
+typedef struct {
+    rt_db           writer;
+    rt_db          *readers;
+    int             n_readers;
+    int            *free_ids;   // stack of reader indices not checked out
+    int             n_free;
+    pthread_mutex_t mu;         // guards free_ids / n_free
+    pthread_cond_t  cv;
+    pthread_mutex_t write_mu;
+} rt_db_pool;
+
+// Opens the writer with opts (forced wal = 1, read_only = 0), then n_readers readers
+// with the same tuning and read_only = 1. Returns 0 or an SQLite error code.
+int     rt_db_pool_open(const char *path, const rt_sqlite_opts *opts, int n_readers, rt_db_pool *p);
+// A reader connection, blocking until one is free.
+rt_db  *rt_db_pool_acquire(rt_db_pool *p);
+void    rt_db_pool_release(rt_db_pool *p, rt_db *reader);
+// The writer connection, held exclusively until rt_db_pool_writer_unlock.
+rt_db  *rt_db_pool_writer_lock(rt_db_pool *p);
+void    rt_db_pool_writer_unlock(rt_db_pool *p);
+// Closes every connection; readers must have been released. Only call after
+// rt_db_pool_open returned 0 (a failed open cleans up after itself).
+void    rt_db_pool_close(rt_db_pool *p);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
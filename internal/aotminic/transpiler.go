@@ -65,6 +65,7 @@ int main(int argc, char** argv) {
 
 const SortQSortC = `
 #include "runtime.h"
+#include "rt_alloc.h"
 #include <stdlib.h>
 
 int compare(const void *a, const void *b) {
@@ -83,21 +84,22 @@ int main(int argc, char** argv) {
         "sort_qsort_tenge_aot",
         n
     );
-    free(arr);
+    rt_free(arr);
     return 0;
 }
 `
 
 const SortMergeSortC = `
 #include "runtime.h"
+#include "rt_alloc.h"
 #include <stdlib.h>
 
 void merge(int arr[], int l, int m, int r) {
     int i, j, k;
     int n1 = m - l + 1;
     int n2 = r - m;
-    int *L = malloc(n1 * sizeof(int));
-    int *R = malloc(n2 * sizeof(int));
+    int *L = rt_alloc(n1 * sizeof(int));
+    int *R = rt_alloc(n2 * sizeof(int));
     for (i = 0; i < n1; i++) L[i] = arr[l + i];
     for (j = 0; j < n2; j++) R[j] = arr[m + 1 + j];
     i = 0; j = 0; k = l;
@@ -107,8 +109,8 @@ void merge(int arr[], int l, int m, int r) {
     }
     while (i < n1) arr[k++] = L[i++];
     while (j < n2) arr[k++] = R[j++];
-    free(L);
-    free(R);
+    rt_free(L);
+    rt_free(R);
 }
 
 void mergeSort(int arr[], int l, int r) {
@@ -132,7 +134,7 @@ int main(int argc, char** argv) {
         "sort_msort_tenge_aot",
         n
     );
-    free(arr);
+    rt_free(arr);
     return 0;
 }
 `
\ No newline at end of file
@@ -4,7 +4,7 @@ package ast
 
 import (
 	"bytes"
-	//"strings"
+	"strings"
 
 	"github.com/DauletBai/tenge/internal/lang/token"
 	"github.com/shopspring/decimal"
@@ -115,6 +115,141 @@ func (es *ExpressionStatement) String() string {
 	return ""
 }
 
+// BlockStatement represents a braced list of statements.
+type BlockStatement struct {
+	Token      token.Token // The '{' token
+	Statements []Statement
+}
+
+func (bs *BlockStatement) statementNode()       {}
+func (bs *BlockStatement) TokenLiteral() string { return bs.Token.Literal }
+func (bs *BlockStatement) String() string {
+	var out bytes.Buffer
+	out.WriteString("{ ")
+	for _, s := range bs.Statements {
+		out.WriteString(s.String())
+		out.WriteString("; ")
+	}
+	out.WriteString("}")
+	return out.String()
+}
+
+// AtqarStatement represents a function declaration (`atqar`):
+//
+//	atqar name(a: san, b: san): san { body }
+type AtqarStatement struct {
+	Token      token.Token // The 'atqar' token
+	Name       *Identifier
+	Parameters []*Identifier
+	ReturnType *TypeNode // nil if not annotated
+	Body       *BlockStatement
+}
+
+func (as *AtqarStatement) statementNode()       {}
+func (as *AtqarStatement) TokenLiteral() string { return as.Token.Literal }
+func (as *AtqarStatement) String() string {
+	var params []string
+	for _, p := range as.Parameters {
+		params = append(params, p.String())
+	}
+	return "atqar " + as.Name.String() + "(" + strings.Join(params, ", ") + ") " + as.Body.String()
+}
+
+// AssignStatement represents an assignment to an existing variable (`x = value`).
+type AssignStatement struct {
+	Token token.Token // The '=' token
+	Name  *Identifier
+	Value Expression
+}
+
+func (as *AssignStatement) statementNode()       {}
+func (as *AssignStatement) TokenLiteral() string { return as.Token.Literal }
+func (as *AssignStatement) String() string       { return as.Name.String() + " = " + as.Value.String() }
+
+// EgerStatement represents a conditional (`eger cond { } aitpese { }`). An
+// `aitpese eger` chain nests: Alternative then holds a block with the inner `eger`.
+type EgerStatement struct {
+	Token       token.Token // The 'eger' token
+	Condition   Expression
+	Consequence *BlockStatement
+	Alternative *BlockStatement // nil without `aitpese`
+}
+
+func (es *EgerStatement) statementNode()       {}
+func (es *EgerStatement) TokenLiteral() string { return es.Token.Literal }
+func (es *EgerStatement) String() string {
+	out := "eger " + es.Condition.String() + " " + es.Consequence.String()
+	if es.Alternative != nil {
+		out += " aitpese " + es.Alternative.String()
+	}
+	return out
+}
+
+// AzirsheStatement represents a while loop (`azirshe cond { }`).
+type AzirsheStatement struct {
+	Token     token.Token // The 'azirshe' token
+	Condition Expression
+	Body      *BlockStatement
+}
+
+func (as *AzirsheStatement) statementNode()       {}
+func (as *AzirsheStatement) TokenLiteral() string { return as.Token.Literal }
+func (as *AzirsheStatement) String() string {
+	return "azirshe " + as.Condition.String() + " " + as.Body.String()
+}
+
+// KorsetStatement prints a value (`korset x`).
+type KorsetStatement struct {
+	Token token.Token // The 'korset' token
+	Value Expression
+}
+
+func (ks *KorsetStatement) statementNode()       {}
+func (ks *KorsetStatement) TokenLiteral() string { return ks.Token.Literal }
+func (ks *KorsetStatement) String() string       { return "korset " + ks.Value.String() }
+
+// Reduction operators of a `par` loop.
+const (
+	ReduceSum = "sum"
+	ReduceMin = "min"
+	ReduceMax = "max"
+)
+
+// ParReduction is the `: sum(acc)` clause of a `par` loop. Every iteration folds into
+// its own chunk's copy of Target; the copies are combined in iteration order afterwards.
+type ParReduction struct {
+	Op     token.Token // IDENT: sum, min or max
+	Target *Identifier
+}
+
+// ParStatement represents a parallel loop (`par`):
+//
+//	par i = from..to { body }
+//	par i = from..to : sum(total) { body }
+//
+// Iterations of [from, to) may run concurrently, so the body must not depend on other
+// iterations except through the reduction target.
+type ParStatement struct {
+	Token  token.Token // The 'par' token
+	Index  *Identifier
+	From   Expression
+	To     Expression
+	Reduce *ParReduction // nil for a plain parallel loop
+	Body   *BlockStatement
+}
+
+func (ps *ParStatement) statementNode()       {}
+func (ps *ParStatement) TokenLiteral() string { return ps.Token.Literal }
+func (ps *ParStatement) String() string {
+	var out bytes.Buffer
+	out.WriteString("par " + ps.Index.String() + " = " + ps.From.String() + ".." + ps.To.String())
+	if ps.Reduce != nil {
+		out.WriteString(" : " + ps.Reduce.Op.Literal + "(" + ps.Reduce.Target.String() + ")")
+	}
+	out.WriteString(" " + ps.Body.String())
+	return out.String()
+}
+
 // --- Expression Nodes ---
 
 // SanLiteral represents an integer literal.
@@ -146,3 +281,45 @@ type AqıqatLiteral struct {
 func (al *AqıqatLiteral) expressionNode()      {}
 func (al *AqıqatLiteral) TokenLiteral() string { return al.Token.Literal }
 func (al *AqıqatLiteral) String() string       { return al.Token.Literal }
+
+// PrefixExpression represents a unary operator (`-x`).
+type PrefixExpression struct {
+	Token    token.Token // The operator token
+	Operator string
+	Right    Expression
+}
+
+func (pe *PrefixExpression) expressionNode()      {}
+func (pe *PrefixExpression) TokenLiteral() string { return pe.Token.Literal }
+func (pe *PrefixExpression) String() string       { return "(" + pe.Operator + pe.Right.String() + ")" }
+
+// InfixExpression represents a binary operator (`a + b`, `a < b`).
+type InfixExpression struct {
+	Token    token.Token // The operator token
+	Left     Expression
+	Operator string
+	Right    Expression
+}
+
+func (ie *InfixExpression) expressionNode()      {}
+func (ie *InfixExpression) TokenLiteral() string { return ie.Token.Literal }
+func (ie *InfixExpression) String() string {
+	return "(" + ie.Left.String() + " " + ie.Operator + " " + ie.Right.String() + ")"
+}
+
+// CallExpression represents a function call (`fib(n - 1)`).
+type CallExpression struct {
+	Token     token.Token // The '(' token
+	Function  Expression  // Identifier of the callee
+	Arguments []Expression
+}
+
+func (ce *CallExpression) expressionNode()      {}
+func (ce *CallExpression) TokenLiteral() string { return ce.Token.Literal }
+func (ce *CallExpression) String() string {
+	var args []string
+	for _, a := range ce.Arguments {
+		args = append(args, a.String())
+	}
+	return ce.Function.String() + "(" + strings.Join(args, ", ") + ")"
+}
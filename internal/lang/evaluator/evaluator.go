@@ -0,0 +1,332 @@
+// FILE: internal/lang/evaluator/evaluator.go
+
+package evaluator
+
+// Tree-walking interpreter: evaluates the AST directly. Every call gets a fresh
+// Environment (a map) and returns through a QaytarValue; the bytecode VM (package vm) is
+// the fast path, this one is the reference it is checked against.
+
+import (
+	"fmt"
+	"io"
+	"os"
+
+	"github.com/DauletBai/tenge/internal/lang/ast"
+	"github.com/DauletBai/tenge/internal/lang/object"
+	"github.com/shopspring/decimal"
+)
+
+// Out receives `korset` output.
+var Out io.Writer = os.Stdout
+
+func newError(format string, a ...interface{}) *object.Error {
+	return &object.Error{Message: fmt.Sprintf(format, a...)}
+}
+
+func isError(obj object.Object) bool { return obj != nil && obj.Type() == object.ERROR_OBJ }
+
+func nativeBool(b bool) *object.Aqiqat {
+	if b {
+		return object.JAN
+	}
+	return object.JIN
+}
+
+// Eval evaluates node in env.
+func Eval(node ast.Node, env *object.Environment) object.Object {
+	switch node := node.(type) {
+	case *ast.Program:
+		var result object.Object = object.NULL
+		for _, s := range node.Statements {
+			result = Eval(s, env)
+			switch r := result.(type) {
+			case *object.QaytarValue:
+				return r.Value
+			case *object.Error:
+				return r
+			}
+		}
+		return result
+	case *ast.BlockStatement:
+		var result object.Object = object.NULL
+		for _, s := range node.Statements {
+			result = Eval(s, env)
+			if result != nil && (result.Type() == object.QAITAR_VAL || result.Type() == object.ERROR_OBJ) {
+				return result
+			}
+		}
+		return result
+	case *ast.ExpressionStatement:
+		return Eval(node.Expression, env)
+	case *ast.JasauStatement:
+		return declare(node.Name.Value, node.Value, env)
+	case *ast.BekitStatement:
+		return declare(node.Name.Value, node.Value, env)
+	case *ast.AssignStatement:
+		val := Eval(node.Value, env)
+		if isError(val) {
+			return val
+		}
+		if _, ok := env.Assign(node.Name.Value, val); !ok {
+			return newError("assignment to undeclared %s", node.Name.Value)
+		}
+		return object.NULL
+	case *ast.AtqarStatement:
+		env.Set(node.Name.Value, &object.Atqar{Name: node.Name.Value, Parameters: node.Parameters, Body: node.Body, Env: env})
+		return object.NULL
+	case *ast.QaytarStatement:
+		var val object.Object = object.NULL
+		if node.ReturnValue != nil {
+			if val = Eval(node.ReturnValue, env); isError(val) {
+				return val
+			}
+		}
+		return &object.QaytarValue{Value: val}
+	case *ast.EgerStatement:
+		cond := Eval(node.Condition, env)
+		if isError(cond) {
+			return cond
+		}
+		if truthy(cond) {
+			return Eval(node.Consequence, env)
+		}
+		if node.Alternative != nil {
+			return Eval(node.Alternative, env)
+		}
+		return object.NULL
+	case *ast.AzirsheStatement:
+		for {
+			cond := Eval(node.Condition, env)
+			if isError(cond) {
+				return cond
+			}
+			if !truthy(cond) {
+				return object.NULL
+			}
+			r := Eval(node.Body, env)
+			if r != nil && (r.Type() == object.QAITAR_VAL || r.Type() == object.ERROR_OBJ) {
+				return r
+			}
+		}
+	case *ast.ParStatement:
+		return evalPar(node, env)
+	case *ast.KorsetStatement:
+		val := Eval(node.Value, env)
+		if isError(val) {
+			return val
+		}
+		fmt.Fprintln(Out, val.Inspect())
+		return object.NULL
+	case *ast.SanLiteral:
+		return &object.San{Value: node.Value}
+	case *ast.AqshaLiteral:
+		return &object.Aqsha{Value: node.Value}
+	case *ast.AqıqatLiteral:
+		return nativeBool(node.Value)
+	case *ast.Identifier:
+		if val, ok := env.Get(node.Value); ok {
+			return val
+		}
+		return newError("undefined: %s", node.Value)
+	case *ast.PrefixExpression:
+		right := Eval(node.Right, env)
+		if isError(right) {
+			return right
+		}
+		return Negate(right)
+	case *ast.InfixExpression:
+		left := Eval(node.Left, env)
+		if isError(left) {
+			return left
+		}
+		right := Eval(node.Right, env)
+		if isError(right) {
+			return right
+		}
+		return Infix(node.Operator, left, right)
+	case *ast.CallExpression:
+		fn := Eval(node.Function, env)
+		if isError(fn) {
+			return fn
+		}
+		args := make([]object.Object, len(node.Arguments))
+		for i, a := range node.Arguments {
+			if args[i] = Eval(a, env); isError(args[i]) {
+				return args[i]
+			}
+		}
+		return Apply(fn, args)
+	}
+	return newError("cannot evaluate %T", node)
+}
+
+// evalPar runs a `par` loop serially, in iteration order. The reduction target is
+// updated in place, which for exact san and aqsha arithmetic gives the same value as
+// folding per-chunk partials in chunk order (the AOT lowering).
+func evalPar(node *ast.ParStatement, env *object.Environment) object.Object {
+	if node.Reduce != nil {
+		if _, ok := env.Get(node.Reduce.Target.Value); !ok {
+			return newError("par: undefined reduction target %s", node.Reduce.Target.Value)
+		}
+	}
+	i := Eval(node.From, env)
+	if isError(i) {
+		return i
+	}
+	to := Eval(node.To, env)
+	if isError(to) {
+		return to
+	}
+	one := &object.San{Value: 1}
+	for {
+		more := Infix("<", i, to)
+		if isError(more) {
+			return more
+		}
+		if !truthy(more) {
+			return object.NULL
+		}
+		env.Set(node.Index.Value, i)
+		r := Eval(node.Body, env)
+		if isError(r) {
+			return r
+		}
+		if r != nil && r.Type() == object.QAITAR_VAL {
+			return newError("par: qaytar inside a par body")
+		}
+		if i = Infix("+", i, one); isError(i) {
+			return i
+		}
+	}
+}
+
+func declare(name string, value ast.Expression, env *object.Environment) object.Object {
+	val := Eval(value, env)
+	if isError(val) {
+		return val
+	}
+	env.Set(name, val)
+	return object.NULL
+}
+
+// Apply calls fn with args in a new scope nested in fn's environment.
+func Apply(fn object.Object, args []object.Object) object.Object {
+	f, ok := fn.(*object.Atqar)
+	if !ok {
+		return newError("not a function: %s", fn.Type())
+	}
+	if len(args) != len(f.Parameters) {
+		return newError("%s: want %d arguments, got %d", f.Name, len(f.Parameters), len(args))
+	}
+	env := object.NewEnclosedEnvironment(f.Env)
+	for i, p := range f.Parameters {
+		env.Set(p.Value, args[i])
+	}
+	result := Eval(f.Body, env)
+	if r, ok := result.(*object.QaytarValue); ok {
+		return r.Value
+	}
+	if isError(result) {
+		return result
+	}
+	return object.NULL
+}
+
+func truthy(obj object.Object) bool {
+	switch obj := obj.(type) {
+	case *object.Aqiqat:
+		return obj.Value
+	case *object.Null:
+		return false
+	case *object.San:
+		return obj.Value != 0
+	}
+	return true
+}
+
+// Negate evaluates `-x`.
+func Negate(x object.Object) object.Object {
+	switch x := x.(type) {
+	case *object.San:
+		return &object.San{Value: -x.Value}
+	case *object.Aqsha:
+		return &object.Aqsha{Value: x.Value.Neg()}
+	}
+	return newError("unknown operator: -%s", x.Type())
+}
+
+// Infix evaluates a binary operator. san with aqsha promotes to aqsha.
+func Infix(op string, left, right object.Object) object.Object {
+	if l, ok := left.(*object.San); ok {
+		if r, ok := right.(*object.San); ok {
+			return sanInfix(op, l.Value, r.Value)
+		}
+	}
+	if l, ok := toDecimal(left); ok {
+		if r, ok := toDecimal(right); ok {
+			return aqshaInfix(op, l, r)
+		}
+	}
+	if l, ok := left.(*object.Aqiqat); ok {
+		if r, ok := right.(*object.Aqiqat); ok && op == "==" {
+			return nativeBool(l.Value == r.Value)
+		}
+	}
+	return newError("unknown operator: %s %s %s", left.Type(), op, right.Type())
+}
+
+func toDecimal(obj object.Object) (decimal.Decimal, bool) {
+	switch obj := obj.(type) {
+	case *object.San:
+		return decimal.NewFromInt(obj.Value), true
+	case *object.Aqsha:
+		return obj.Value, true
+	}
+	return decimal.Decimal{}, false
+}
+
+func sanInfix(op string, l, r int64) object.Object {
+	switch op {
+	case "+":
+		return &object.San{Value: l + r}
+	case "-":
+		return &object.San{Value: l - r}
+	case "*":
+		return &object.San{Value: l * r}
+	case "/":
+		if r == 0 {
+			return newError("division by zero")
+		}
+		return &object.San{Value: l / r}
+	case "<":
+		return nativeBool(l < r)
+	case ">":
+		return nativeBool(l > r)
+	case "==":
+		return nativeBool(l == r)
+	}
+	return newError("unknown operator: SAN %s SAN", op)
+}
+
+func aqshaInfix(op string, l, r decimal.Decimal) object.Object {
+	switch op {
+	case "+":
+		return &object.Aqsha{Value: l.Add(r)}
+	case "-":
+		return &object.Aqsha{Value: l.Sub(r)}
+	case "*":
+		return &object.Aqsha{Value: l.Mul(r)}
+	case "/":
+		if r.IsZero() {
+			return newError("division by zero")
+		}
+		return &object.Aqsha{Value: l.Div(r)}
+	case "<":
+		return nativeBool(l.Cmp(r) < 0)
+	case ">":
+		return nativeBool(l.Cmp(r) > 0)
+	case "==":
+		return nativeBool(l.Equal(r))
+	}
+	return newError("unknown operator: AQSHA %s AQSHA", op)
+}
@@ -20,6 +20,7 @@ var keywords = map[string]token.TokenType{
 	"jan":     token.JAN,     // true
 	"jin":     token.JIN,     // false
 	"korset":  token.KORSET,  // show/print
+	"par":     token.PAR,     // parallel loop
 	"san":     token.SAN,     // number/int
 	"aqsha":   token.AQSHA,   // money/decimal
 	"jol":     token.JOL,     // string
@@ -68,8 +69,8 @@ func (l *Lexer) readNumber() (tokType token.TokenType, lit string) {
 		l.readChar()
 	}
 
-	// If we find a dot, it's a decimal number.
-	if l.ch == '.' {
+	// If we find a dot, it's a decimal number (unless it starts a `..` range).
+	if l.ch == '.' && l.peekChar() != '.' {
 		tokType = token.AQSHA_LIT
 		l.readChar() // Consume the dot
 		for unicode.IsDigit(l.ch) {
@@ -119,9 +120,22 @@ func (l *Lexer) NextToken() token.Token {
 		tok = newToken(token.BOLU, l.ch)
 	case '>':
 		tok = newToken(token.ULKEN, l.ch)
+	case '<':
+		tok = newToken(token.KISHI, l.ch)
 	case '"':
 		tok.Type = token.JOL_LIT
 		tok.Literal = l.readString()
+	case '.':
+		if l.peekChar() == '.' {
+			l.readChar()
+			tok = token.Token{Type: token.ARALYQ, Literal: ".."}
+		} else {
+			tok = newToken(token.ILLEGAL, l.ch)
+		}
+	case '{':
+		tok = newToken(token.SOL_BUIRA, l.ch)
+	case '}':
+		tok = newToken(token.ON_BUIRA, l.ch)
 	case '[':
 		tok = newToken(token.SOL_KOSHA, l.ch)
 	case ']':
@@ -4,7 +4,8 @@ package object
 
 import (
 	"fmt"
-	//"github.com/DauletBai/tenge/internal/lang/ast"
+
+	"github.com/DauletBai/tenge/internal/lang/ast"
 	"github.com/shopspring/decimal"
 )
 
@@ -18,6 +19,7 @@ const (
 	AQIQAT_OBJ = "AQIQAT"
 	NULL_OBJ   = "NULL"
 	QAITAR_VAL = "QAITAR_VAL"
+	ATQAR_OBJ  = "ATQAR"
 	ERROR_OBJ  = "ERROR"
 )
 
@@ -79,6 +81,18 @@ type QaytarValue struct {
 func (qv *QaytarValue) Type() ObjectType { return QAITAR_VAL }
 func (qv *QaytarValue) Inspect() string  { return qv.Value.Inspect() }
 
+// Atqar is a function declared with `atqar`, closing over the environment it was
+// declared in.
+type Atqar struct {
+	Name       string
+	Parameters []*ast.Identifier
+	Body       *ast.BlockStatement
+	Env        *Environment
+}
+
+func (a *Atqar) Type() ObjectType { return ATQAR_OBJ }
+func (a *Atqar) Inspect() string  { return "atqar " + a.Name }
+
 // Error represents a runtime error.
 type Error struct {
 	Message string
@@ -103,3 +117,21 @@ func (e *Environment) Get(name string) (Object, bool) { /* ... */
 	return obj, ok
 }
 func (e *Environment) Set(name string, val Object) Object { /* ... */ e.store[name] = val; return val }
+
+// NewEnclosedEnvironment returns a scope nested in outer (a function call's).
+func NewEnclosedEnvironment(outer *Environment) *Environment {
+	env := NewEnvironment()
+	env.outer = outer
+	return env
+}
+
+// Assign updates name in the innermost scope that defines it.
+func (e *Environment) Assign(name string, val Object) (Object, bool) {
+	for env := e; env != nil; env = env.outer {
+		if _, ok := env.store[name]; ok {
+			env.store[name] = val
+			return val, true
+		}
+	}
+	return nil, false
+}
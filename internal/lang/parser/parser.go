@@ -0,0 +1,404 @@
+// FILE: internal/lang/parser/parser.go
+
+package parser
+
+import (
+	"fmt"
+	"strconv"
+
+	"github.com/DauletBai/tenge/internal/lang/ast"
+	"github.com/DauletBai/tenge/internal/lang/lexer"
+	"github.com/DauletBai/tenge/internal/lang/token"
+	"github.com/shopspring/decimal"
+)
+
+// Operator precedences, lowest first.
+const (
+	_ int = iota
+	LOWEST
+	EQUALS      // ==
+	LESSGREATER // > or <
+	SUM         // + or -
+	PRODUCT     // * or /
+	PREFIX      // -x
+	CALL        // f(x)
+)
+
+var precedences = map[token.TokenType]int{
+	token.TEN:     EQUALS,
+	token.ULKEN:   LESSGREATER,
+	token.KISHI:   LESSGREATER,
+	token.KOSU:    SUM,
+	token.AZAYTU:  SUM,
+	token.KOBEYTU: PRODUCT,
+	token.BOLU:    PRODUCT,
+	token.SOL_JAI: CALL,
+}
+
+// Parser is a Pratt parser over the lexer's token stream.
+type Parser struct {
+	l      *lexer.Lexer
+	errors []string
+
+	curToken  token.Token
+	peekToken token.Token
+}
+
+func New(l *lexer.Lexer) *Parser {
+	p := &Parser{l: l}
+	p.nextToken()
+	p.nextToken()
+	return p
+}
+
+// Errors returns the syntax errors found so far.
+func (p *Parser) Errors() []string { return p.errors }
+
+func (p *Parser) nextToken() {
+	p.curToken = p.peekToken
+	p.peekToken = p.l.NextToken()
+}
+
+func (p *Parser) curTokenIs(t token.TokenType) bool  { return p.curToken.Type == t }
+func (p *Parser) peekTokenIs(t token.TokenType) bool { return p.peekToken.Type == t }
+
+// expectPeek advances if the next token is t, and records an error otherwise.
+func (p *Parser) expectPeek(t token.TokenType) bool {
+	if p.peekTokenIs(t) {
+		p.nextToken()
+		return true
+	}
+	p.errors = append(p.errors, fmt.Sprintf("expected %q, got %q", t, p.peekToken.Literal))
+	return false
+}
+
+func (p *Parser) peekPrecedence() int {
+	if pr, ok := precedences[p.peekToken.Type]; ok {
+		return pr
+	}
+	return LOWEST
+}
+
+func (p *Parser) curPrecedence() int {
+	if pr, ok := precedences[p.curToken.Type]; ok {
+		return pr
+	}
+	return LOWEST
+}
+
+// ParseProgram parses statements up to EOF.
+func (p *Parser) ParseProgram() *ast.Program {
+	program := &ast.Program{}
+	for !p.curTokenIs(token.EOF) {
+		if stmt := p.parseStatement(); stmt != nil {
+			program.Statements = append(program.Statements, stmt)
+		}
+		p.nextToken()
+	}
+	return program
+}
+
+// --- Statements ---
+// Each parse function starts on the statement's first token and stops on its last.
+
+func (p *Parser) parseStatement() ast.Statement {
+	switch p.curToken.Type {
+	case token.JASA:
+		s := &ast.JasauStatement{Token: p.curToken}
+		if s.Name, s.Type, s.Value = p.parseDeclaration(); s.Value == nil {
+			return nil
+		}
+		return s
+	case token.BEKIT:
+		s := &ast.BekitStatement{Token: p.curToken}
+		if s.Name, s.Type, s.Value = p.parseDeclaration(); s.Value == nil {
+			return nil
+		}
+		return s
+	case token.ATQAR:
+		return p.parseAtqarStatement()
+	case token.QAYTAR:
+		return p.parseQaytarStatement()
+	case token.EGER:
+		return p.parseEgerStatement()
+	case token.AZIRSHE:
+		return p.parseAzirsheStatement()
+	case token.PAR:
+		return p.parseParStatement()
+	case token.KORSET:
+		s := &ast.KorsetStatement{Token: p.curToken}
+		p.nextToken()
+		if s.Value = p.parseExpression(LOWEST); s.Value == nil {
+			return nil
+		}
+		return s
+	case token.IDENT:
+		if p.peekTokenIs(token.TAYINDAU) {
+			name := &ast.Identifier{Token: p.curToken, Value: p.curToken.Literal}
+			p.nextToken()
+			s := &ast.AssignStatement{Token: p.curToken, Name: name}
+			p.nextToken()
+			if s.Value = p.parseExpression(LOWEST); s.Value == nil {
+				return nil
+			}
+			return s
+		}
+	}
+	s := &ast.ExpressionStatement{Token: p.curToken}
+	if s.Expression = p.parseExpression(LOWEST); s.Expression == nil {
+		return nil
+	}
+	return s
+}
+
+// parseDeclaration parses `name (: type)? = value` after `jasau` or `bekit`.
+func (p *Parser) parseDeclaration() (*ast.Identifier, *ast.TypeNode, ast.Expression) {
+	if !p.expectPeek(token.IDENT) {
+		return nil, nil, nil
+	}
+	name := &ast.Identifier{Token: p.curToken, Value: p.curToken.Literal}
+	typ := p.parseOptionalType()
+	if !p.expectPeek(token.TAYINDAU) {
+		return nil, nil, nil
+	}
+	p.nextToken()
+	return name, typ, p.parseExpression(LOWEST)
+}
+
+// parseOptionalType parses a `: type` or `-> type` annotation if one follows.
+func (p *Parser) parseOptionalType() *ast.TypeNode {
+	if !p.peekTokenIs(token.EKI_NUQTA) && !p.peekTokenIs(token.OK) {
+		return nil
+	}
+	p.nextToken()
+	p.nextToken()
+	return &ast.TypeNode{Token: p.curToken}
+}
+
+func (p *Parser) parseAtqarStatement() ast.Statement {
+	s := &ast.AtqarStatement{Token: p.curToken}
+	if !p.expectPeek(token.IDENT) {
+		return nil
+	}
+	s.Name = &ast.Identifier{Token: p.curToken, Value: p.curToken.Literal}
+	if !p.expectPeek(token.SOL_JAI) {
+		return nil
+	}
+	for !p.peekTokenIs(token.ON_JAI) {
+		if len(s.Parameters) > 0 && !p.expectPeek(token.VIRGUL) {
+			return nil
+		}
+		if !p.expectPeek(token.IDENT) {
+			return nil
+		}
+		s.Parameters = append(s.Parameters, &ast.Identifier{Token: p.curToken, Value: p.curToken.Literal})
+		p.parseOptionalType()
+	}
+	p.nextToken()
+	s.ReturnType = p.parseOptionalType()
+	if !p.expectPeek(token.SOL_BUIRA) {
+		return nil
+	}
+	s.Body = p.parseBlockStatement()
+	return s
+}
+
+func (p *Parser) parseQaytarStatement() ast.Statement {
+	s := &ast.QaytarStatement{Token: p.curToken}
+	if p.peekTokenIs(token.ON_BUIRA) || p.peekTokenIs(token.EOF) {
+		return s
+	}
+	p.nextToken()
+	if s.ReturnValue = p.parseExpression(LOWEST); s.ReturnValue == nil {
+		return nil
+	}
+	return s
+}
+
+func (p *Parser) parseEgerStatement() ast.Statement {
+	s := &ast.EgerStatement{Token: p.curToken}
+	p.nextToken()
+	if s.Condition = p.parseExpression(LOWEST); s.Condition == nil {
+		return nil
+	}
+	if !p.expectPeek(token.SOL_BUIRA) {
+		return nil
+	}
+	s.Consequence = p.parseBlockStatement()
+	if !p.peekTokenIs(token.AITPESE) {
+		return s
+	}
+	p.nextToken()
+	if p.peekTokenIs(token.EGER) {
+		p.nextToken()
+		inner := p.parseEgerStatement()
+		if inner == nil {
+			return nil
+		}
+		s.Alternative = &ast.BlockStatement{Token: p.curToken, Statements: []ast.Statement{inner}}
+		return s
+	}
+	if !p.expectPeek(token.SOL_BUIRA) {
+		return nil
+	}
+	s.Alternative = p.parseBlockStatement()
+	return s
+}
+
+func (p *Parser) parseAzirsheStatement() ast.Statement {
+	s := &ast.AzirsheStatement{Token: p.curToken}
+	p.nextToken()
+	if s.Condition = p.parseExpression(LOWEST); s.Condition == nil {
+		return nil
+	}
+	if !p.expectPeek(token.SOL_BUIRA) {
+		return nil
+	}
+	s.Body = p.parseBlockStatement()
+	return s
+}
+
+// parseParStatement parses `par i = from..to (: sum|min|max(target))? { body }`.
+func (p *Parser) parseParStatement() ast.Statement {
+	s := &ast.ParStatement{Token: p.curToken}
+	if !p.expectPeek(token.IDENT) {
+		return nil
+	}
+	s.Index = &ast.Identifier{Token: p.curToken, Value: p.curToken.Literal}
+	if !p.expectPeek(token.TAYINDAU) {
+		return nil
+	}
+	p.nextToken()
+	if s.From = p.parseExpression(LOWEST); s.From == nil || !p.expectPeek(token.ARALYQ) {
+		return nil
+	}
+	p.nextToken()
+	if s.To = p.parseExpression(LOWEST); s.To == nil {
+		return nil
+	}
+	if p.peekTokenIs(token.EKI_NUQTA) {
+		p.nextToken()
+		if !p.expectPeek(token.IDENT) {
+			return nil
+		}
+		r := &ast.ParReduction{Op: p.curToken}
+		switch r.Op.Literal {
+		case ast.ReduceSum, ast.ReduceMin, ast.ReduceMax:
+		default:
+			p.errors = append(p.errors, fmt.Sprintf("par: unknown reduction %q (want sum, min or max)", r.Op.Literal))
+			return nil
+		}
+		if !p.expectPeek(token.SOL_JAI) || !p.expectPeek(token.IDENT) {
+			return nil
+		}
+		r.Target = &ast.Identifier{Token: p.curToken, Value: p.curToken.Literal}
+		if !p.expectPeek(token.ON_JAI) {
+			return nil
+		}
+		s.Reduce = r
+	}
+	if !p.expectPeek(token.SOL_BUIRA) {
+		return nil
+	}
+	s.Body = p.parseBlockStatement()
+	return s
+}
+
+// parseBlockStatement starts on '{' and stops on the matching '}'.
+func (p *Parser) parseBlockStatement() *ast.BlockStatement {
+	block := &ast.BlockStatement{Token: p.curToken}
+	p.nextToken()
+	for !p.curTokenIs(token.ON_BUIRA) {
+		if p.curTokenIs(token.EOF) {
+			p.errors = append(p.errors, "unterminated block: expected \"}\"")
+			return block
+		}
+		if stmt := p.parseStatement(); stmt != nil {
+			block.Statements = append(block.Statements, stmt)
+		}
+		p.nextToken()
+	}
+	return block
+}
+
+// --- Expressions ---
+
+func (p *Parser) parseExpression(precedence int) ast.Expression {
+	left := p.parsePrefix()
+	for left != nil && precedence < p.peekPrecedence() {
+		p.nextToken()
+		if p.curTokenIs(token.SOL_JAI) {
+			left = p.parseCallExpression(left)
+		} else {
+			left = p.parseInfixExpression(left)
+		}
+	}
+	return left
+}
+
+func (p *Parser) parsePrefix() ast.Expression {
+	switch t := p.curToken; t.Type {
+	case token.IDENT:
+		return &ast.Identifier{Token: t, Value: t.Literal}
+	case token.SAN_LIT:
+		v, err := strconv.ParseInt(t.Literal, 10, 64)
+		if err != nil {
+			p.errors = append(p.errors, fmt.Sprintf("could not parse %q as san", t.Literal))
+			return nil
+		}
+		return &ast.SanLiteral{Token: t, Value: v}
+	case token.AQSHA_LIT:
+		v, err := decimal.NewFromString(t.Literal)
+		if err != nil {
+			p.errors = append(p.errors, fmt.Sprintf("could not parse %q as aqsha", t.Literal))
+			return nil
+		}
+		return &ast.AqshaLiteral{Token: t, Value: v}
+	case token.JAN, token.JIN:
+		return &ast.AqıqatLiteral{Token: t, Value: t.Type == token.JAN}
+	case token.AZAYTU:
+		e := &ast.PrefixExpression{Token: t, Operator: t.Literal}
+		p.nextToken()
+		if e.Right = p.parseExpression(PREFIX); e.Right == nil {
+			return nil
+		}
+		return e
+	case token.SOL_JAI:
+		p.nextToken()
+		e := p.parseExpression(LOWEST)
+		if !p.expectPeek(token.ON_JAI) {
+			return nil
+		}
+		return e
+	default:
+		p.errors = append(p.errors, fmt.Sprintf("unexpected %q", t.Literal))
+		return nil
+	}
+}
+
+func (p *Parser) parseInfixExpression(left ast.Expression) ast.Expression {
+	e := &ast.InfixExpression{Token: p.curToken, Operator: p.curToken.Literal, Left: left}
+	precedence := p.curPrecedence()
+	p.nextToken()
+	if e.Right = p.parseExpression(precedence); e.Right == nil {
+		return nil
+	}
+	return e
+}
+
+func (p *Parser) parseCallExpression(fn ast.Expression) ast.Expression {
+	e := &ast.CallExpression{Token: p.curToken, Function: fn}
+	for !p.peekTokenIs(token.ON_JAI) {
+		if len(e.Arguments) > 0 && !p.expectPeek(token.VIRGUL) {
+			return nil
+		}
+		p.nextToken()
+		arg := p.parseExpression(LOWEST)
+		if arg == nil {
+			return nil
+		}
+		e.Arguments = append(e.Arguments, arg)
+	}
+	p.nextToken()
+	return e
+}
@@ -38,6 +38,7 @@ const (
 	JAN     = "jan"     // true
 	JIN     = "jin"     // false
 	KORSET  = "korset"  // show/print
+	PAR     = "par"     // parallel loop
 
 	// Types - Official Latin Kazakh
 	SAN    = "san"    // number/int
@@ -55,6 +56,7 @@ const (
 	BOLU     = "/"  // division (бөлу)
 	TEN      = "==" // equality (тең)
 	ULKEN    = ">"  // greater than (үлкен)
+	KISHI    = "<"  // less than (кіші)
 
 	// Delimiters - Kazakh translations
 	VIRGUL    = ","  // comma (үтір)
@@ -64,4 +66,7 @@ const (
 	SOL_KOSHA = "["  // left bracket (сол қосша)
 	ON_KOSHA  = "]"  // right bracket (оң қосша)
 	OK        = "->" // arrow (оқ)
+	SOL_BUIRA = "{"  // left brace (сол бұйра жақша)
+	ON_BUIRA  = "}"  // right brace (оң бұйра жақша)
+	ARALYQ    = ".." // range (аралық)
 )
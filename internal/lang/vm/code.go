@@ -0,0 +1,117 @@
+// FILE: internal/lang/vm/code.go
+
+package vm
+
+import (
+	"fmt"
+
+	"github.com/DauletBai/tenge/internal/lang/object"
+)
+
+// Op is a register-machine opcode. R[x] is register x of the current frame, K[x] a
+// constant of the function, G[x] a global slot. RK operands name a register when >= 0
+// and the constant K[-1-x] when negative.
+type Op uint8
+
+const (
+	OpMove       Op = iota // R[A] = R[B]
+	OpLoadK                // R[A] = K[B]
+	OpGetG                 // R[A] = G[B]
+	OpSetG                 // G[B] = R[A]
+	OpAdd                  // R[A] = RK[B] + RK[C]
+	OpSub                  // R[A] = RK[B] - RK[C]
+	OpMul                  // R[A] = RK[B] * RK[C]
+	OpDiv                  // R[A] = RK[B] / RK[C]
+	OpLt                   // R[A] = RK[B] < RK[C]
+	OpGt                   // R[A] = RK[B] > RK[C]
+	OpEq                   // R[A] = RK[B] == RK[C]
+	OpNeg                  // R[A] = -R[B]
+	OpJmp                  // pc = A
+	OpJmpIfNot             // if !R[B] { pc = A }
+	OpJmpIfNotLt           // if !(RK[B] < RK[C]) { pc = A }
+	OpJmpIfNotGt           // if !(RK[B] > RK[C]) { pc = A }
+	OpJmpIfNotEq           // if !(RK[B] == RK[C]) { pc = A }
+	OpCall                 // R[A] = R[A](R[A+1] .. R[A+B]), through call site C
+	OpCallG                // R[A] = G[Sites[C].Slot](R[A+1] .. R[A+B]), through call site C
+	OpReturn               // return R[A]
+	OpReturnNull           // return null
+	OpPrint                // korset R[A]
+)
+
+var opNames = [...]string{"MOVE", "LOADK", "GETG", "SETG", "ADD", "SUB", "MUL", "DIV", "LT", "GT", "EQ",
+	"NEG", "JMP", "JMPIFNOT", "JMPIFNOTLT", "JMPIFNOTGT", "JMPIFNOTEQ", "CALL", "CALLG", "RETURN",
+	"RETURNNULL", "PRINT"}
+
+func (op Op) String() string { return opNames[op] }
+
+// Instr is one instruction; unused operands are zero.
+type Instr struct {
+	Op      Op
+	A, B, C int32
+}
+
+func (in Instr) String() string { return fmt.Sprintf("%-10s %d %d %d", in.Op, in.A, in.B, in.C) }
+
+// Value is a register or a constant: a san in I when O is nil, otherwise the object O.
+// san arithmetic therefore never allocates.
+type Value struct {
+	I int64
+	O object.Object
+}
+
+// Object boxes v for code outside the VM.
+func (v Value) Object() object.Object {
+	if v.O == nil {
+		return &object.San{Value: v.I}
+	}
+	return v.O
+}
+
+// FromObject unboxes a san; other objects are kept as they are.
+func FromObject(obj object.Object) Value {
+	if s, ok := obj.(*object.San); ok {
+		return Value{I: s.Value}
+	}
+	return Value{O: obj}
+}
+
+// CallSite is the inline cache of one OpCall / OpCallG: the callee seen last and its
+// code. A call whose callee is the cached one skips the type and arity checks.
+type CallSite struct {
+	Slot   int           // OpCallG: the global holding the callee
+	callee object.Object // last callee, nil before the first call
+	proto  *Proto
+}
+
+// Proto is a compiled function.
+type Proto struct {
+	Name      string
+	NumParams int
+	NumRegs   int // registers a frame uses: parameters, then locals, then temporaries
+	Code      []Instr
+	Consts    []Value
+	Sites     []CallSite
+
+	// JIT tier (jit.go)
+	calls, loops int // calls and loop back-edges while interpreted
+	jitIndex     int // 1 + index in the program's JIT table, 0 before one is assigned
+	jit          *jitFunc
+	noJIT        bool // not compiled: unsupported, or deoptimized too often
+}
+
+// Function is a function value: what `atqar` binds its name to.
+type Function struct {
+	Proto *Proto
+}
+
+func (f *Function) Type() object.ObjectType { return object.ATQAR_OBJ }
+func (f *Function) Inspect() string         { return "atqar " + f.Proto.Name }
+
+// Disassemble lists p's code, one instruction per line.
+func (p *Proto) Disassemble() string {
+	out := fmt.Sprintf("atqar %s: %d params, %d registers\n", p.Name, p.NumParams, p.NumRegs)
+	for pc, in := range p.Code {
+		out += fmt.Sprintf("%4d  %s\n", pc, in)
+	}
+	return out
+}
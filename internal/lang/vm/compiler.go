@@ -0,0 +1,393 @@
+// FILE: internal/lang/vm/compiler.go
+
+package vm
+
+import (
+	"fmt"
+
+	"github.com/DauletBai/tenge/internal/lang/ast"
+	"github.com/DauletBai/tenge/internal/lang/object"
+)
+
+// Program is a compiled source file: top-level code and the global slots.
+type Program struct {
+	Main    *Proto
+	Globals []string       // slot -> name
+	slots   map[string]int // name -> slot
+	jit     jitTable       // compiled functions, shared by the program's VMs
+}
+
+// Slot returns the global slot of name.
+func (p *Program) Slot(name string) (int, bool) {
+	s, ok := p.slots[name]
+	return s, ok
+}
+
+// compiler holds the state of one function being compiled. At top level locals is nil:
+// every variable there is a global, so functions can see it.
+type compiler struct {
+	prog   *Program
+	proto  *Proto
+	locals map[string]int
+	top    int // first free register
+	kInt   map[int64]int
+	inPar  int // depth of enclosing par bodies
+}
+
+// Compile translates a parsed program to bytecode. Top-level `atqar`, `jasau` and
+// `bekit` names become global slots; inside a function, parameters and `jasau` take
+// registers.
+func Compile(program *ast.Program) (prog *Program, err error) {
+	prog = &Program{slots: map[string]int{}}
+	for _, s := range program.Statements {
+		switch s := s.(type) {
+		case *ast.AtqarStatement:
+			prog.global(s.Name.Value)
+		case *ast.JasauStatement:
+			prog.global(s.Name.Value)
+		case *ast.BekitStatement:
+			prog.global(s.Name.Value)
+		}
+	}
+	defer func() {
+		if r := recover(); r != nil {
+			ce, ok := r.(compileError)
+			if !ok {
+				panic(r)
+			}
+			prog, err = nil, ce
+		}
+	}()
+	c := &compiler{prog: prog, proto: &Proto{Name: "main"}, kInt: map[int64]int{}}
+	for _, s := range program.Statements {
+		c.statement(s)
+	}
+	c.emit(OpReturnNull, 0, 0, 0)
+	prog.Main = c.proto
+	return prog, nil
+}
+
+type compileError string
+
+func (e compileError) Error() string { return string(e) }
+
+func fail(format string, a ...interface{}) { panic(compileError(fmt.Sprintf(format, a...))) }
+
+func (p *Program) global(name string) int {
+	if s, ok := p.slots[name]; ok {
+		return s
+	}
+	p.slots[name] = len(p.Globals)
+	p.Globals = append(p.Globals, name)
+	return len(p.Globals) - 1
+}
+
+func (c *compiler) emit(op Op, a, b, cc int) int {
+	c.proto.Code = append(c.proto.Code, Instr{Op: op, A: int32(a), B: int32(b), C: int32(cc)})
+	return len(c.proto.Code) - 1
+}
+
+func (c *compiler) patch(at int) { c.proto.Code[at].A = int32(len(c.proto.Code)) }
+
+func (c *compiler) alloc() int {
+	r := c.top
+	c.top++
+	if c.top > c.proto.NumRegs {
+		c.proto.NumRegs = c.top
+	}
+	return r
+}
+
+// constant returns the RK operand of a constant.
+func (c *compiler) constant(v Value) int {
+	if v.O == nil {
+		if k, ok := c.kInt[v.I]; ok {
+			return -1 - k
+		}
+		c.kInt[v.I] = len(c.proto.Consts)
+	}
+	c.proto.Consts = append(c.proto.Consts, v)
+	return -len(c.proto.Consts)
+}
+
+func literal(e ast.Expression) (Value, bool) {
+	switch e := e.(type) {
+	case *ast.SanLiteral:
+		return Value{I: e.Value}, true
+	case *ast.AqshaLiteral:
+		return Value{O: &object.Aqsha{Value: e.Value}}, true
+	case *ast.AqıqatLiteral:
+		if e.Value {
+			return Value{O: object.JAN}, true
+		}
+		return Value{O: object.JIN}, true
+	}
+	return Value{}, false
+}
+
+// --- Statements ---
+// Temporaries live only within a statement: each one starts and ends with c.top at the
+// first register after the locals.
+
+func (c *compiler) statement(s ast.Statement) {
+	switch s := s.(type) {
+	case *ast.ExpressionStatement:
+		save := c.top
+		c.expr(s.Expression, c.alloc())
+		c.top = save
+	case *ast.JasauStatement:
+		c.declare(s.Name.Value, s.Value)
+	case *ast.BekitStatement:
+		c.declare(s.Name.Value, s.Value)
+	case *ast.AssignStatement:
+		if r, ok := c.locals[s.Name.Value]; ok {
+			c.expr(s.Value, r)
+			return
+		}
+		slot, ok := c.prog.Slot(s.Name.Value)
+		if !ok {
+			fail("assignment to undeclared %s", s.Name.Value)
+		}
+		save := c.top
+		r := c.alloc()
+		c.expr(s.Value, r)
+		c.emit(OpSetG, r, slot, 0)
+		c.top = save
+	case *ast.AtqarStatement:
+		if c.locals != nil {
+			fail("%s: atqar is only allowed at top level", s.Name.Value)
+		}
+		fn := &Function{Proto: compileFunction(c.prog, s)}
+		save := c.top
+		r := c.alloc()
+		c.emit(OpLoadK, r, -1-c.constant(Value{O: fn}), 0)
+		c.emit(OpSetG, r, c.prog.global(s.Name.Value), 0)
+		c.top = save
+	case *ast.QaytarStatement:
+		if c.inPar > 0 {
+			fail("par: qaytar inside a par body")
+		}
+		if s.ReturnValue == nil {
+			c.emit(OpReturnNull, 0, 0, 0)
+			return
+		}
+		save := c.top
+		c.emit(OpReturn, c.reg(s.ReturnValue), 0, 0)
+		c.top = save
+	case *ast.EgerStatement:
+		skip := c.jumpIfNot(s.Condition)
+		c.block(s.Consequence)
+		if s.Alternative == nil {
+			c.patch(skip)
+			return
+		}
+		end := c.emit(OpJmp, 0, 0, 0)
+		c.patch(skip)
+		c.block(s.Alternative)
+		c.patch(end)
+	case *ast.AzirsheStatement:
+		start := len(c.proto.Code)
+		exit := c.jumpIfNot(s.Condition)
+		c.block(s.Body)
+		c.emit(OpJmp, start, 0, 0)
+		c.patch(exit)
+	case *ast.ParStatement:
+		c.par(s)
+	case *ast.KorsetStatement:
+		save := c.top
+		c.emit(OpPrint, c.reg(s.Value), 0, 0)
+		c.top = save
+	case *ast.BlockStatement:
+		c.block(s)
+	default:
+		fail("%s: not supported by the VM", s.TokenLiteral())
+	}
+}
+
+func (c *compiler) block(b *ast.BlockStatement) {
+	for _, s := range b.Statements {
+		c.statement(s)
+	}
+}
+
+// par compiles a `par` loop as a serial counted loop, like evalPar: the counter and the
+// bound live in registers of their own (the bound is evaluated once), the index is set
+// from the counter at the start of every iteration, and the reduction target is updated
+// in place. The index is a local inside a function and a global at top level.
+func (c *compiler) par(s *ast.ParStatement) {
+	if t := s.Reduce; t != nil {
+		if _, ok := c.locals[t.Target.Value]; !ok {
+			if _, ok := c.prog.Slot(t.Target.Value); !ok {
+				fail("par: undefined reduction target %s", t.Target.Value)
+			}
+		}
+	}
+	save := c.top
+	n, end := c.alloc(), c.alloc()
+	c.expr(s.From, n)
+	c.expr(s.To, end)
+	i, local := -1, c.locals != nil
+	if local {
+		var ok bool
+		if i, ok = c.locals[s.Index.Value]; !ok {
+			i = c.alloc()
+			c.locals[s.Index.Value] = i
+		}
+	}
+	start := c.emit(OpJmpIfNotLt, 0, n, end)
+	if local {
+		c.emit(OpMove, i, n, 0)
+	} else {
+		c.emit(OpSetG, n, c.prog.global(s.Index.Value), 0)
+	}
+	c.inPar++
+	c.block(s.Body)
+	c.inPar--
+	c.emit(OpAdd, n, n, c.constant(Value{I: 1}))
+	c.emit(OpJmp, start, 0, 0)
+	c.patch(start)
+	if !local {
+		c.top = save // at top level nothing above save is a variable
+	}
+}
+
+// declare compiles `jasau name = value`. Inside a function the value is computed into
+// the next free register, which then becomes the variable.
+func (c *compiler) declare(name string, value ast.Expression) {
+	if c.locals == nil {
+		save := c.top
+		r := c.alloc()
+		c.expr(value, r)
+		c.emit(OpSetG, r, c.prog.global(name), 0)
+		c.top = save
+		return
+	}
+	if r, ok := c.locals[name]; ok {
+		c.expr(value, r)
+		return
+	}
+	r := c.alloc()
+	c.expr(value, r)
+	c.locals[name] = r
+}
+
+func compileFunction(prog *Program, s *ast.AtqarStatement) *Proto {
+	c := &compiler{prog: prog, proto: &Proto{Name: s.Name.Value, NumParams: len(s.Parameters)},
+		locals: map[string]int{}, kInt: map[int64]int{}}
+	for _, p := range s.Parameters {
+		if _, dup := c.locals[p.Value]; dup {
+			fail("%s: duplicate parameter %s", s.Name.Value, p.Value)
+		}
+		c.locals[p.Value] = c.alloc()
+	}
+	c.block(s.Body)
+	c.emit(OpReturnNull, 0, 0, 0)
+	return c.proto
+}
+
+// jumpIfNot emits a jump taken when cond is false and returns it for patching.
+// Comparisons compile to a single compare-and-branch.
+func (c *compiler) jumpIfNot(cond ast.Expression) int {
+	save := c.top
+	defer func() { c.top = save }()
+	if in, ok := cond.(*ast.InfixExpression); ok {
+		op, ok := map[string]Op{"<": OpJmpIfNotLt, ">": OpJmpIfNotGt, "==": OpJmpIfNotEq}[in.Operator]
+		if ok {
+			b, cc := c.rk(in.Left), c.rk(in.Right)
+			return c.emit(op, 0, b, cc)
+		}
+	}
+	return c.emit(OpJmpIfNot, 0, c.reg(cond), 0)
+}
+
+// --- Expressions ---
+
+// rk returns an RK operand holding e: a constant, a local's register, or a temporary.
+func (c *compiler) rk(e ast.Expression) int {
+	if v, ok := literal(e); ok {
+		return c.constant(v)
+	}
+	return c.reg(e)
+}
+
+// reg returns a register holding e: a local's own, or a temporary.
+func (c *compiler) reg(e ast.Expression) int {
+	if id, ok := e.(*ast.Identifier); ok {
+		if r, ok := c.locals[id.Value]; ok {
+			return r
+		}
+	}
+	r := c.alloc()
+	c.expr(e, r)
+	return r
+}
+
+var arith = map[string]Op{"+": OpAdd, "-": OpSub, "*": OpMul, "/": OpDiv, "<": OpLt, ">": OpGt, "==": OpEq}
+
+// expr compiles e into register dst.
+func (c *compiler) expr(e ast.Expression, dst int) {
+	if v, ok := literal(e); ok {
+		c.emit(OpLoadK, dst, -1-c.constant(v), 0)
+		return
+	}
+	save := c.top
+	defer func() { c.top = save }()
+	switch e := e.(type) {
+	case *ast.Identifier:
+		if r, ok := c.locals[e.Value]; ok {
+			if r != dst {
+				c.emit(OpMove, dst, r, 0)
+			}
+			return
+		}
+		slot, ok := c.prog.Slot(e.Value)
+		if !ok {
+			fail("undefined: %s", e.Value)
+		}
+		c.emit(OpGetG, dst, slot, 0)
+	case *ast.PrefixExpression:
+		c.emit(OpNeg, dst, c.reg(e.Right), 0)
+	case *ast.InfixExpression:
+		op, ok := arith[e.Operator]
+		if !ok {
+			fail("unknown operator %s", e.Operator)
+		}
+		b, cc := c.rk(e.Left), c.rk(e.Right)
+		c.emit(op, dst, b, cc)
+	case *ast.CallExpression:
+		c.call(e, dst)
+	default:
+		fail("cannot compile %s", e.String())
+	}
+}
+
+// call places the callee's arguments in the registers after A: the callee's frame
+// starts at A+1, so they become its parameters without copying, and it returns into A.
+// A is dst when nothing lives above dst, else a fresh register.
+func (c *compiler) call(e *ast.CallExpression, dst int) {
+	a := dst
+	if dst != c.top-1 {
+		a = c.alloc()
+	}
+	op, site := OpCall, CallSite{Slot: -1}
+	if id, ok := e.Function.(*ast.Identifier); ok {
+		if _, local := c.locals[id.Value]; !local {
+			slot, ok := c.prog.Slot(id.Value)
+			if !ok {
+				fail("undefined: %s", id.Value)
+			}
+			op, site.Slot = OpCallG, slot
+		}
+	}
+	if op == OpCall {
+		c.expr(e.Function, a)
+	}
+	for _, arg := range e.Arguments {
+		c.expr(arg, c.alloc())
+	}
+	c.proto.Sites = append(c.proto.Sites, site)
+	c.emit(op, a, len(e.Arguments), len(c.proto.Sites)-1)
+	if a != dst {
+		c.emit(OpMove, dst, a, 0)
+	}
+}
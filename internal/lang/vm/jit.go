@@ -0,0 +1,217 @@
+// FILE: internal/lang/vm/jit.go
+
+package vm
+
+// Baseline JIT tier. The interpreter counts calls and loop back-edges per function; past
+// JITCallThreshold calls or JITLoopThreshold back-edges a function is compiled to
+// machine code by emitting one template per bytecode instruction (jit_amd64.go).
+//
+// Compiled code works on the interpreter's value stack and keeps nothing in machine
+// registers from one instruction to the next, so it can be entered at any instruction (a
+// hot loop tiers up in the middle of a call) and left at any instruction. Each template
+// guards that its operands are san and that a call's callee is the one it was compiled
+// for; a failed guard, or an instruction without a template, deoptimizes: the
+// interpreter rebuilds a frame for every compiled call in progress and resumes at the
+// failing instruction. A function that deoptimizes too often is left to the interpreter.
+//
+// Compiled code runs on its own native stack with no Go preemption points: a long call
+// delays Go's stop-the-world phases until it returns.
+
+import (
+	"time"
+	"unsafe"
+
+	"github.com/DauletBai/tenge/internal/lang/object"
+)
+
+const (
+	JITCallThreshold   = 1000
+	JITLoopThreshold   = 10000
+	jitMaxDeopts       = 100
+	jitMaxFuncs        = 1024
+	jitNativeStackSize = 1 << 20
+
+	valueSize    = unsafe.Sizeof(Value{})
+	jitFrameSize = unsafe.Sizeof(jitFrame{})
+)
+
+// jitFunc is a compiled function.
+type jitFunc struct {
+	proto   *Proto
+	index   int
+	entry   uintptr // address of instruction 0
+	offsets []int32 // instruction -> code offset
+	mem     []byte  // the executable mapping
+	keep    []object.Object
+	deopts  int
+}
+
+// jitTable is a program's compiled code. entries[i] is the entry address of function i
+// (0 while it is not compiled); compiled calls go through it.
+type jitTable struct {
+	protos  []*Proto
+	entries []uintptr
+}
+
+// jitFrame is a frame record pushed by a compiled call: the caller's function index,
+// return instruction and base. The layout is the templates'.
+type jitFrame struct {
+	fn, pc, base, _ int64
+}
+
+// jitContext is shared with compiled code (field offsets: jit_amd64.go, go_asm.h). It
+// holds no Go pointers, so machine code may write it.
+type jitContext struct {
+	// set by enter
+	stack0     uintptr // &stack[0]
+	globals0   uintptr // &globals[0]
+	entries0   uintptr // &entries[0]
+	stackBase  uintptr // &stack[base]
+	base       int64
+	jframes    uintptr // first free frame record
+	jframesEnd uintptr
+	code       uintptr // where to start
+	nativeTop  uintptr
+	// set by the trampoline
+	goSP    uintptr
+	entrySP uintptr
+	// set on exit
+	status   int64 // 0: returned, 1: deoptimized
+	exitFn   int64
+	exitPC   int64
+	exitBase int64
+	jtop     uintptr // frame records in use end here
+}
+
+// JITStats counts what the JIT tier did.
+type JITStats struct {
+	Compiled  int           // functions compiled
+	Rejected  int           // functions not compiled, or given up after deoptimizing
+	Compile   time.Duration // spent compiling
+	Entries   int64         // entries into compiled code from the interpreter
+	Deopts    int64
+	FirstCode time.Duration // from New to the first compiled function
+}
+
+func (t *jitTable) index(p *Proto) int {
+	if p.jitIndex == 0 {
+		if len(t.protos) == jitMaxFuncs {
+			return -1
+		}
+		t.protos = append(t.protos, p)
+		if t.entries == nil {
+			t.entries = make([]uintptr, jitMaxFuncs)
+		}
+		p.jitIndex = len(t.protos)
+	}
+	return p.jitIndex - 1
+}
+
+func addrOf[T any](s []T) uintptr { return uintptr(unsafe.Pointer(unsafe.SliceData(s))) }
+
+// hot counts an event (a call or a back-edge) of p and reports whether p has compiled
+// code to run, compiling it when count reaches threshold.
+func (vm *VM) hot(p *Proto, count *int, threshold int) bool {
+	if p.jit == nil {
+		if p.noJIT {
+			return false
+		}
+		if *count++; *count < threshold {
+			return false
+		}
+		vm.tierUp(p)
+		if p.jit == nil {
+			return false
+		}
+	}
+	return vm.jframes != nil || vm.jitInit()
+}
+
+// jitInit allocates the VM's native stack and frame records, or turns the JIT off.
+func (vm *VM) jitInit() bool {
+	native, err := jitNativeStack()
+	if err != nil {
+		vm.JIT = false
+		return false
+	}
+	vm.native = native
+	vm.ctx.nativeTop = (addrOf(native) + uintptr(len(native))) &^ 15
+	vm.jframes = make([]jitFrame, MaxFrames)
+	return true
+}
+
+// tierUp compiles p, then the functions its call sites have seen that are not compiled
+// yet: compiled code calls compiled code only.
+func (vm *VM) tierUp(p *Proto) {
+	if p.jit != nil || p.noJIT {
+		return
+	}
+	t0 := time.Now()
+	fn := jitCompile(&vm.prog.jit, p)
+	vm.stats.Compile += time.Since(t0)
+	if fn == nil {
+		p.noJIT = true
+		vm.stats.Rejected++
+		return
+	}
+	if vm.stats.Compiled == 0 {
+		vm.stats.FirstCode = time.Since(vm.born)
+	}
+	vm.stats.Compiled++
+	p.jit = fn
+	vm.prog.jit.entries[fn.index] = fn.entry
+	for _, site := range p.Sites {
+		if site.proto != nil && site.Slot >= 0 {
+			vm.tierUp(site.proto)
+		}
+	}
+}
+
+// enterJIT runs fn's code from instruction pc in a frame at base. It reports whether the
+// code returned (the result is in stack[base-1]); otherwise it deoptimized and the
+// interpreter must continue from vm.deopt.
+func (vm *VM) enterJIT(fn *jitFunc, base, pc int) bool {
+	vm.stats.Entries++
+	free := cap(vm.frames) - len(vm.frames) - 1 // one for the interpreter's own frame
+	if free < 0 {
+		free = 0
+	}
+	if len(vm.jframes) < free {
+		free = len(vm.jframes)
+	}
+	ctx := &vm.ctx
+	ctx.stack0 = addrOf(vm.stack)
+	ctx.globals0 = addrOf(vm.globals)
+	ctx.entries0 = addrOf(vm.prog.jit.entries)
+	ctx.stackBase = ctx.stack0 + uintptr(base)*valueSize
+	ctx.base = int64(base)
+	ctx.jframes = addrOf(vm.jframes)
+	ctx.jframesEnd = ctx.jframes + uintptr(free)*jitFrameSize
+	ctx.code = fn.entry + uintptr(fn.offsets[pc])
+	ctx.status = 0
+	jitEnter(ctx)
+	return ctx.status == 0
+}
+
+// deopt rebuilds interpreter frames for the compiled calls in progress at the last exit
+// and returns where to resume.
+func (vm *VM) deopt() (p *Proto, pc, base int) {
+	ctx, t := &vm.ctx, &vm.prog.jit
+	n := int((ctx.jtop - addrOf(vm.jframes)) / jitFrameSize)
+	for _, f := range vm.jframes[:n] {
+		vm.frames = append(vm.frames, frame{proto: t.protos[f.fn], pc: int(f.pc), base: int(f.base)})
+	}
+	vm.stats.Deopts++
+	p = t.protos[ctx.exitFn]
+	if fn := p.jit; fn != nil {
+		if fn.deopts++; fn.deopts > jitMaxDeopts {
+			p.jit, p.noJIT = nil, true
+			t.entries[fn.index] = 0
+			vm.stats.Rejected++
+		}
+	}
+	return p, int(ctx.exitPC), int(ctx.exitBase)
+}
+
+// Stats returns the JIT tier's counters.
+func (vm *VM) Stats() JITStats { return vm.stats }
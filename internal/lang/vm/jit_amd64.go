@@ -0,0 +1,405 @@
+// FILE: internal/lang/vm/jit_amd64.go
+
+//go:build linux && amd64
+
+package vm
+
+// x86-64 templates. Compiled code keeps the context in RDI, &stack[base] in RBX, base in
+// R15, the next free frame record in R12 and the end of the records in R13; RAX, RCX and
+// RDX are scratch. A value is 24 bytes: I, then the interface words of O; a san has a nil
+// type word. Templates only ever store san values: they write I and clear the type word,
+// never a pointer, so compiled code needs no GC write barriers (type words point at
+// itabs, which are not in the Go heap).
+
+import (
+	"syscall"
+	"unsafe"
+
+	"github.com/DauletBai/tenge/internal/lang/object"
+)
+
+const jitSupported = true
+
+const (
+	rax = 0
+	rcx = 1
+	rbx = 3
+	rsp = 4
+	rdi = 7
+	r12 = 12
+	r13 = 13
+	r15 = 15
+)
+
+// condition codes
+const (
+	ccE  = 0x4
+	ccNE = 0x5
+	ccAE = 0x3
+	ccA  = 0x7
+	ccGE = 0xD
+	ccLE = 0xE
+)
+
+const (
+	offGlobals  = int32(unsafe.Offsetof(jitContext{}.globals0))
+	offEntries  = int32(unsafe.Offsetof(jitContext{}.entries0))
+	offEntrySP  = int32(unsafe.Offsetof(jitContext{}.entrySP))
+	offStatus   = int32(unsafe.Offsetof(jitContext{}.status))
+	offExitFn   = int32(unsafe.Offsetof(jitContext{}.exitFn))
+	offExitPC   = int32(unsafe.Offsetof(jitContext{}.exitPC))
+	offExitBase = int32(unsafe.Offsetof(jitContext{}.exitBase))
+	offJtop     = int32(unsafe.Offsetof(jitContext{}.jtop))
+	offTab      = int32(unsafe.Offsetof(Value{}.O))
+)
+
+// jitEnter switches to the native stack and runs compiled code from ctx.code (jit_amd64.s).
+//
+//go:noescape
+func jitEnter(ctx *jitContext)
+
+// --- Encoder ---
+
+type asm struct{ b []byte }
+
+func (a *asm) emit(bs ...byte) { a.b = append(a.b, bs...) }
+
+func (a *asm) imm32(v int32) { a.b = append(a.b, byte(v), byte(v>>8), byte(v>>16), byte(v>>24)) }
+
+func (a *asm) rexW(reg, rm int) { a.emit(0x48 | byte(reg>>3)<<2 | byte(rm>>3)) }
+
+// rm emits op reg, [base+disp] with REX.W.
+func (a *asm) rm(reg, base int, disp int32, op ...byte) {
+	a.rexW(reg, base)
+	a.emit(op...)
+	mod := byte(0x80)
+	switch {
+	case disp == 0 && base&7 != 5:
+		mod = 0
+	case disp >= -128 && disp <= 127:
+		mod = 0x40
+	}
+	a.emit(mod | byte(reg&7)<<3 | byte(base&7))
+	if base&7 == 4 {
+		a.emit(0x24)
+	}
+	switch mod {
+	case 0x40:
+		a.emit(byte(disp))
+	case 0x80:
+		a.imm32(disp)
+	}
+}
+
+// rr emits op reg, rm between registers with REX.W.
+func (a *asm) rr(reg, rm int, op ...byte) {
+	a.rexW(reg, rm)
+	a.emit(op...)
+	a.emit(0xC0 | byte(reg&7)<<3 | byte(rm&7))
+}
+
+func (a *asm) load(r, base int, disp int32)      { a.rm(r, base, disp, 0x8B) }
+func (a *asm) store(base int, disp int32, r int) { a.rm(r, base, disp, 0x89) }
+
+func (a *asm) storeImm(base int, disp, v int32) {
+	a.rm(0, base, disp, 0xC7)
+	a.imm32(v)
+}
+
+// alu emits add (0), sub (5) or cmp (7) of an immediate to r.
+func (a *asm) alu(ext, r int, v int32) {
+	a.rexW(0, r)
+	a.emit(0x81, 0xC0|byte(ext)<<3|byte(r&7))
+	a.imm32(v)
+}
+
+func (a *asm) movImm(r int, v int64) {
+	if v == int64(int32(v)) {
+		a.rexW(0, r)
+		a.emit(0xC7, 0xC0|byte(r&7))
+		a.imm32(int32(v))
+		return
+	}
+	a.rexW(0, r)
+	a.emit(0xB8 | byte(r&7))
+	for i := 0; i < 8; i++ {
+		a.emit(byte(v >> (8 * i)))
+	}
+}
+
+// jcc emits a conditional jump and returns the position of its rel32.
+func (a *asm) jcc(cc byte) int {
+	a.emit(0x0F, 0x80|cc)
+	a.imm32(0)
+	return len(a.b) - 4
+}
+
+func (a *asm) jmp() int {
+	a.emit(0xE9)
+	a.imm32(0)
+	return len(a.b) - 4
+}
+
+func (a *asm) patch(at, target int) {
+	v := int32(target - (at + 4))
+	a.b[at], a.b[at+1], a.b[at+2], a.b[at+3] = byte(v), byte(v>>8), byte(v>>16), byte(v>>24)
+}
+
+// --- Templates ---
+
+type fixup struct{ at, pc int }
+
+type jitCompiler struct {
+	asm
+	t     *jitTable
+	p     *Proto
+	index int
+	pc    int
+	jumps []fixup // to instructions
+	exits []fixup // to deoptimization stubs
+	keep  []object.Object
+}
+
+func slot(x int32) int32 { return 24 * x }
+
+func (c *jitCompiler) exit(cc byte) { c.exits = append(c.exits, fixup{c.jcc(cc), c.pc}) }
+
+func (c *jitCompiler) exitAlways() { c.exits = append(c.exits, fixup{c.jmp(), c.pc}) }
+
+// san checks that the RK operand x holds a san; a constant that is not one makes the
+// instruction deoptimize unconditionally.
+func (c *jitCompiler) san(x int32) bool {
+	if x < 0 {
+		return c.p.Consts[-1-x].O == nil
+	}
+	c.rm(7, rbx, slot(x)+offTab, 0x83)
+	c.emit(0)
+	c.exit(ccNE)
+	return true
+}
+
+func (c *jitCompiler) loadRK(r int, x int32) {
+	if x < 0 {
+		c.movImm(r, c.p.Consts[-1-x].I)
+		return
+	}
+	c.load(r, rbx, slot(x))
+}
+
+// setSan stores r into R[a] as a san.
+func (c *jitCompiler) setSan(a int32, r int) {
+	c.store(rbx, slot(a), r)
+	c.storeImm(rbx, slot(a)+offTab, 0)
+}
+
+// operands guards and loads RK[B] into RAX and RK[C] into RCX.
+func (c *jitCompiler) operands(in Instr) bool {
+	if !c.san(in.B) || !c.san(in.C) {
+		return false
+	}
+	c.loadRK(rax, in.B)
+	c.loadRK(rcx, in.C)
+	return true
+}
+
+func (c *jitCompiler) instr(in Instr) {
+	switch in.Op {
+	case OpMove:
+		c.san(in.B)
+		c.load(rax, rbx, slot(in.B))
+		c.setSan(in.A, rax)
+	case OpLoadK:
+		if c.p.Consts[in.B].O != nil {
+			c.exitAlways()
+			return
+		}
+		c.movImm(rax, c.p.Consts[in.B].I)
+		c.setSan(in.A, rax)
+	case OpGetG:
+		c.load(rcx, rdi, offGlobals)
+		c.rm(7, rcx, slot(in.B)+offTab, 0x83)
+		c.emit(0)
+		c.exit(ccNE)
+		c.load(rax, rcx, slot(in.B))
+		c.setSan(in.A, rax)
+	case OpSetG:
+		c.san(in.A)
+		c.load(rcx, rdi, offGlobals)
+		c.load(rax, rbx, slot(in.A))
+		c.store(rcx, slot(in.B), rax)
+		c.storeImm(rcx, slot(in.B)+offTab, 0)
+	case OpAdd, OpSub, OpMul:
+		if !c.operands(in) {
+			c.exitAlways()
+			return
+		}
+		switch in.Op {
+		case OpAdd:
+			c.rr(rcx, rax, 0x01)
+		case OpSub:
+			c.rr(rcx, rax, 0x29)
+		default:
+			c.rr(rax, rcx, 0x0F, 0xAF)
+		}
+		c.setSan(in.A, rax)
+	case OpDiv:
+		if !c.operands(in) {
+			c.exitAlways()
+			return
+		}
+		// x/0 is an error and goes to the interpreter. idiv traps on MinInt64/-1, so x/-1
+		// is a neg, which wraps MinInt64 to itself as Go does.
+		c.rr(rcx, rcx, 0x85)
+		c.exit(ccE)
+		c.alu(7, rcx, -1)
+		div := c.jcc(ccNE)
+		c.emit(0x48, 0xF7, 0xD8) // neg rax
+		done := c.jmp()
+		c.patch(div, len(c.b))
+		c.emit(0x48, 0x99)       // cqo
+		c.emit(0x48, 0xF7, 0xF9) // idiv rcx
+		c.patch(done, len(c.b))
+		c.setSan(in.A, rax)
+	case OpNeg:
+		c.san(in.B)
+		c.load(rax, rbx, slot(in.B))
+		c.emit(0x48, 0xF7, 0xD8) // neg rax
+		c.setSan(in.A, rax)
+	case OpJmp:
+		c.jumps = append(c.jumps, fixup{c.jmp(), int(in.A)})
+	case OpJmpIfNot:
+		c.san(in.B)
+		c.rm(7, rbx, slot(in.B), 0x83)
+		c.emit(0)
+		c.jumps = append(c.jumps, fixup{c.jcc(ccE), int(in.A)})
+	case OpJmpIfNotLt, OpJmpIfNotGt, OpJmpIfNotEq:
+		if !c.operands(in) {
+			c.exitAlways()
+			return
+		}
+		c.rr(rcx, rax, 0x39) // cmp rax, rcx
+		cc := map[Op]byte{OpJmpIfNotLt: ccGE, OpJmpIfNotGt: ccLE, OpJmpIfNotEq: ccNE}[in.Op]
+		c.jumps = append(c.jumps, fixup{c.jcc(cc), int(in.A)})
+	case OpCallG:
+		c.callG(in)
+	case OpReturn:
+		c.san(in.A)
+		c.load(rax, rbx, slot(in.A))
+		c.store(rbx, -24, rax)
+		c.storeImm(rbx, -24+offTab, 0)
+		c.emit(0xC3)
+	default:
+		// OpCall, OpReturnNull, OpPrint and comparisons producing aqiqat stay interpreted
+		c.exitAlways()
+	}
+}
+
+// callG calls the callee the site's inline cache holds, guarded on the global still
+// holding it and on it being compiled. It pushes a frame record for deoptimization and
+// moves the frame to A+1, as the interpreter does.
+func (c *jitCompiler) callG(in Instr) {
+	site := &c.p.Sites[in.C]
+	fn, ok := site.callee.(*Function)
+	if !ok || fn.Proto.noJIT {
+		c.exitAlways()
+		return
+	}
+	q := fn.Proto
+	qi := c.t.index(q)
+	if qi < 0 {
+		c.exitAlways()
+		return
+	}
+	c.keep = append(c.keep, site.callee)
+	words := *(*[2]int64)(unsafe.Pointer(&site.callee))
+	g := slot(int32(site.Slot))
+	c.load(rcx, rdi, offGlobals)
+	c.movImm(rax, words[0])
+	c.rm(rax, rcx, g+offTab, 0x3B)
+	c.exit(ccNE)
+	c.movImm(rax, words[1])
+	c.rm(rax, rcx, g+offTab+8, 0x3B)
+	c.exit(ccNE)
+	c.load(rax, rdi, offEntries)
+	c.load(rax, rax, int32(8*qi))
+	c.rr(rax, rax, 0x85)
+	c.exit(ccE)
+	c.rr(r13, r12, 0x39) // cmp r12, r13
+	c.exit(ccAE)
+	c.rm(rcx, r15, in.A+1+int32(q.NumRegs), 0x8D) // lea rcx, [r15+A+1+NumRegs]
+	c.alu(7, rcx, StackSize)
+	c.exit(ccA)
+
+	c.storeImm(r12, 0, int32(c.index))
+	c.storeImm(r12, 8, int32(c.pc+1))
+	c.store(r12, 16, r15)
+	c.alu(0, r12, int32(jitFrameSize))
+	c.alu(0, rbx, slot(in.A+1))
+	c.alu(0, r15, in.A+1)
+	c.emit(0xFF, 0xD0) // call rax
+	c.alu(5, r15, in.A+1)
+	c.alu(5, rbx, slot(in.A+1))
+	c.alu(5, r12, int32(jitFrameSize))
+}
+
+// exitStubs emits one stub per deoptimizing instruction, recording its pc, and the
+// common exit, which records where compiled code stopped and unwinds the native stack
+// to jitEnter.
+func (c *jitCompiler) exitStubs() {
+	stubs := map[int]int{}
+	var toCommon []int
+	for _, f := range c.exits {
+		at, ok := stubs[f.pc]
+		if !ok {
+			at = len(c.b)
+			stubs[f.pc] = at
+			c.storeImm(rdi, offExitPC, int32(f.pc))
+			toCommon = append(toCommon, c.jmp())
+		}
+		c.patch(f.at, at)
+	}
+	for _, at := range toCommon {
+		c.patch(at, len(c.b))
+	}
+	c.storeImm(rdi, offExitFn, int32(c.index))
+	c.store(rdi, offExitBase, r15)
+	c.store(rdi, offJtop, r12)
+	c.storeImm(rdi, offStatus, 1)
+	c.load(rsp, rdi, offEntrySP)
+	c.alu(5, rsp, 8)
+	c.emit(0xC3) // back into jitEnter
+}
+
+// jitCompile translates p to machine code, or returns nil.
+func jitCompile(t *jitTable, p *Proto) *jitFunc {
+	idx := t.index(p)
+	if idx < 0 {
+		return nil
+	}
+	c := &jitCompiler{t: t, p: p, index: idx}
+	offsets := make([]int32, len(p.Code))
+	for pc, in := range p.Code {
+		offsets[pc] = int32(len(c.b))
+		c.pc = pc
+		c.instr(in)
+	}
+	for _, j := range c.jumps {
+		c.patch(j.at, int(offsets[j.pc]))
+	}
+	c.exitStubs()
+
+	mem, err := syscall.Mmap(-1, 0, len(c.b), syscall.PROT_READ|syscall.PROT_WRITE, syscall.MAP_PRIVATE|syscall.MAP_ANON)
+	if err != nil {
+		return nil
+	}
+	copy(mem, c.b)
+	if syscall.Mprotect(mem, syscall.PROT_READ|syscall.PROT_EXEC) != nil {
+		syscall.Munmap(mem)
+		return nil
+	}
+	return &jitFunc{proto: p, index: idx, entry: addrOf(mem), offsets: offsets, mem: mem, keep: c.keep}
+}
+
+func jitNativeStack() ([]byte, error) {
+	return syscall.Mmap(-1, 0, jitNativeStackSize, syscall.PROT_READ|syscall.PROT_WRITE, syscall.MAP_PRIVATE|syscall.MAP_ANON)
+}
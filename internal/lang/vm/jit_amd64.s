@@ -0,0 +1,35 @@
+// FILE: internal/lang/vm/jit_amd64.s
+
+//go:build linux && amd64
+
+#include "textflag.h"
+#include "go_asm.h"
+
+// func jitEnter(ctx *jitContext)
+// Runs compiled code on the native stack. Compiled code returns here with RET, or
+// deoptimizes by resetting SP to entrySP-8 and returning.
+TEXT ·jitEnter(SB), NOSPLIT, $0-8
+	MOVQ ctx+0(FP), DI
+	MOVQ SP, jitContext_goSP(DI)
+	MOVQ jitContext_nativeTop(DI), SP
+	PUSHQ BP
+	PUSHQ BX
+	PUSHQ R12
+	PUSHQ R13
+	PUSHQ R14
+	PUSHQ R15
+	MOVQ jitContext_stackBase(DI), BX
+	MOVQ jitContext_base(DI), R15
+	MOVQ jitContext_jframes(DI), R12
+	MOVQ jitContext_jframesEnd(DI), R13
+	MOVQ jitContext_code(DI), AX
+	MOVQ SP, jitContext_entrySP(DI)
+	CALL AX
+	POPQ R15
+	POPQ R14
+	POPQ R13
+	POPQ R12
+	POPQ BX
+	POPQ BP
+	MOVQ jitContext_goSP(DI), SP
+	RET
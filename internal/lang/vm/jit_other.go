@@ -0,0 +1,17 @@
+// FILE: internal/lang/vm/jit_other.go
+
+//go:build !(linux && amd64)
+
+package vm
+
+import "errors"
+
+// Elsewhere the JIT tier is off and functions stay interpreted.
+
+const jitSupported = false
+
+func jitCompile(t *jitTable, p *Proto) *jitFunc { return nil }
+
+func jitEnter(ctx *jitContext) {}
+
+func jitNativeStack() ([]byte, error) { return nil, errors.New("jit: unsupported platform") }
@@ -0,0 +1,319 @@
+// FILE: internal/lang/vm/vm.go
+
+package vm
+
+// Calling convention: all frames live in one value stack allocated with the VM. A call
+// OpCall(G) A B C evaluates its arguments into the caller's registers A+1 .. A+B, and the
+// callee's frame starts at A+1, so the arguments already are its parameters. Returning
+// writes the result into the caller's register A and pops the frame: no environment is
+// created and no return wrapper is allocated, and san values are unboxed throughout.
+// Each call site caches its last callee (inline cache). Hot functions tier up to
+// compiled code (jit.go), which uses the same stack and frames.
+
+import (
+	"fmt"
+	"io"
+	"os"
+	"time"
+
+	"github.com/DauletBai/tenge/internal/lang/evaluator"
+	"github.com/DauletBai/tenge/internal/lang/object"
+)
+
+const (
+	StackSize = 1 << 18 // values on the value stack
+	MaxFrames = 1 << 15 // call depth
+)
+
+// frame is a caller saved across a call.
+type frame struct {
+	proto *Proto
+	pc    int
+	base  int
+}
+
+// VM runs a Program. A Program's VMs share its call-site caches and compiled code, so
+// they must not run concurrently.
+type VM struct {
+	prog    *Program
+	globals []Value
+	stack   []Value // stack[0] receives the result of Run and Call
+	frames  []frame
+	Out     io.Writer // korset output
+	JIT     bool      // tier hot functions up to machine code; on by default where supported
+
+	ctx     jitContext
+	jframes []jitFrame
+	native  []byte // the native stack compiled code runs on
+	stats   JITStats
+	born    time.Time
+}
+
+func New(prog *Program) *VM {
+	vm := &VM{prog: prog, globals: make([]Value, len(prog.Globals)), stack: make([]Value, StackSize),
+		frames: make([]frame, 0, MaxFrames), Out: os.Stdout, JIT: jitSupported, born: time.Now()}
+	for i := range vm.globals {
+		vm.globals[i] = Value{O: object.NULL}
+	}
+	return vm
+}
+
+// Run executes the top-level code. Errors are returned as *object.Error.
+func (vm *VM) Run() object.Object {
+	if 1+vm.prog.Main.NumRegs > len(vm.stack) {
+		return &object.Error{Message: "stack overflow"}
+	}
+	v, err := vm.execute(vm.prog.Main, 1)
+	vm.frames = vm.frames[:0]
+	if err != nil {
+		return err
+	}
+	return v.Object()
+}
+
+// Call calls the global function name with args (after Run has defined it).
+func (vm *VM) Call(name string, args ...object.Object) object.Object {
+	slot, ok := vm.prog.Slot(name)
+	if !ok {
+		return &object.Error{Message: "undefined: " + name}
+	}
+	fn, ok := vm.globals[slot].O.(*Function)
+	if !ok {
+		return &object.Error{Message: "not a function: " + name}
+	}
+	if len(args) != fn.Proto.NumParams {
+		return &object.Error{Message: fmt.Sprintf("%s: want %d arguments, got %d", name, fn.Proto.NumParams, len(args))}
+	}
+	if 1+fn.Proto.NumRegs > len(vm.stack) {
+		return &object.Error{Message: "stack overflow"}
+	}
+	for i, a := range args {
+		vm.stack[1+i] = FromObject(a)
+	}
+	var v Value
+	var err *object.Error
+	if q := fn.Proto; vm.JIT && vm.hot(q, &q.calls, JITCallThreshold) {
+		if vm.enterJIT(q.jit, 1, 0) {
+			v = vm.stack[0]
+		} else {
+			p, pc, base := vm.deopt()
+			v, err = vm.resume(p, pc, base, 0)
+		}
+	} else {
+		v, err = vm.execute(fn.Proto, 1)
+	}
+	vm.frames = vm.frames[:0]
+	if err != nil {
+		return err
+	}
+	return v.Object()
+}
+
+func rk(regs, consts []Value, x int32) Value {
+	if x >= 0 {
+		return regs[x]
+	}
+	return consts[-1-x]
+}
+
+func boolValue(b bool) Value {
+	if b {
+		return Value{O: object.JAN}
+	}
+	return Value{O: object.JIN}
+}
+
+func truthy(v Value) bool {
+	switch o := v.O.(type) {
+	case nil:
+		return v.I != 0
+	case *object.Aqiqat:
+		return o.Value
+	case *object.Null:
+		return false
+	}
+	return true
+}
+
+var opSymbol = map[Op]string{OpAdd: "+", OpSub: "-", OpMul: "*", OpDiv: "/", OpLt: "<", OpGt: ">", OpEq: "==",
+	OpJmpIfNotLt: "<", OpJmpIfNotGt: ">", OpJmpIfNotEq: "=="}
+
+// slowInfix handles operands that are not both san, with the evaluator's semantics.
+func slowInfix(op Op, b, c Value) (Value, *object.Error) {
+	r := evaluator.Infix(opSymbol[op], b.Object(), c.Object())
+	if e, ok := r.(*object.Error); ok {
+		return Value{}, e
+	}
+	return FromObject(r), nil
+}
+
+// resolve fills a call site's cache with callee, which must be a Function taking nargs.
+func resolve(site *CallSite, callee object.Object, nargs int32) *object.Error {
+	fn, ok := callee.(*Function)
+	if !ok {
+		typ := object.ObjectType(object.SAN_OBJ) // nil: an unboxed san
+		if callee != nil {
+			typ = callee.Type()
+		}
+		return &object.Error{Message: fmt.Sprintf("not a function: %s", typ)}
+	}
+	if int(nargs) != fn.Proto.NumParams {
+		return &object.Error{Message: fmt.Sprintf("%s: want %d arguments, got %d", fn.Proto.Name, fn.Proto.NumParams, nargs)}
+	}
+	site.callee, site.proto = callee, fn.Proto
+	return nil
+}
+
+// execute runs p in a frame at base until it returns.
+func (vm *VM) execute(p *Proto, base int) (Value, *object.Error) {
+	return vm.resume(p, 0, base, len(vm.frames))
+}
+
+// resume runs p from pc in a frame at base until the frame that returns leaves entry
+// frames saved.
+func (vm *VM) resume(p *Proto, pc, base, entry int) (Value, *object.Error) {
+	code, consts, regs := p.Code, p.Consts, vm.stack[base:]
+	for {
+		in := code[pc]
+		pc++
+		switch in.Op {
+		case OpMove:
+			regs[in.A] = regs[in.B]
+		case OpLoadK:
+			regs[in.A] = consts[in.B]
+		case OpGetG:
+			regs[in.A] = vm.globals[in.B]
+		case OpSetG:
+			vm.globals[in.B] = regs[in.A]
+		case OpAdd, OpSub, OpMul, OpDiv, OpLt, OpGt, OpEq:
+			b, c := rk(regs, consts, in.B), rk(regs, consts, in.C)
+			if b.O != nil || c.O != nil {
+				v, err := slowInfix(in.Op, b, c)
+				if err != nil {
+					return Value{}, err
+				}
+				regs[in.A] = v
+				continue
+			}
+			switch in.Op {
+			case OpAdd:
+				regs[in.A] = Value{I: b.I + c.I}
+			case OpSub:
+				regs[in.A] = Value{I: b.I - c.I}
+			case OpMul:
+				regs[in.A] = Value{I: b.I * c.I}
+			case OpDiv:
+				if c.I == 0 {
+					return Value{}, &object.Error{Message: "division by zero"}
+				}
+				regs[in.A] = Value{I: b.I / c.I}
+			case OpLt:
+				regs[in.A] = boolValue(b.I < c.I)
+			case OpGt:
+				regs[in.A] = boolValue(b.I > c.I)
+			case OpEq:
+				regs[in.A] = boolValue(b.I == c.I)
+			}
+		case OpNeg:
+			if b := regs[in.B]; b.O == nil {
+				regs[in.A] = Value{I: -b.I}
+			} else if r := evaluator.Negate(b.O); r.Type() == object.ERROR_OBJ {
+				return Value{}, r.(*object.Error)
+			} else {
+				regs[in.A] = FromObject(r)
+			}
+		case OpJmp:
+			back := int(in.A) < pc
+			pc = int(in.A)
+			if !back || !vm.JIT || !vm.hot(p, &p.loops, JITLoopThreshold) {
+				continue
+			}
+			// on-stack replacement: continue the loop in compiled code
+			if !vm.enterJIT(p.jit, base, pc) {
+				p, pc, base = vm.deopt()
+				code, consts, regs = p.Code, p.Consts, vm.stack[base:]
+				continue
+			}
+			v := vm.stack[base-1]
+			if len(vm.frames) == entry {
+				return v, nil
+			}
+			f := vm.frames[len(vm.frames)-1]
+			vm.frames = vm.frames[:len(vm.frames)-1]
+			p, base, pc = f.proto, f.base, f.pc
+			code, consts, regs = p.Code, p.Consts, vm.stack[base:]
+		case OpJmpIfNot:
+			if !truthy(regs[in.B]) {
+				pc = int(in.A)
+			}
+		case OpJmpIfNotLt, OpJmpIfNotGt, OpJmpIfNotEq:
+			b, c := rk(regs, consts, in.B), rk(regs, consts, in.C)
+			var ok bool
+			if b.O == nil && c.O == nil {
+				switch in.Op {
+				case OpJmpIfNotLt:
+					ok = b.I < c.I
+				case OpJmpIfNotGt:
+					ok = b.I > c.I
+				default:
+					ok = b.I == c.I
+				}
+			} else {
+				v, err := slowInfix(in.Op, b, c)
+				if err != nil {
+					return Value{}, err
+				}
+				ok = truthy(v)
+			}
+			if !ok {
+				pc = int(in.A)
+			}
+		case OpCall, OpCallG:
+			site := &p.Sites[in.C]
+			var callee object.Object
+			if in.Op == OpCallG {
+				callee = vm.globals[site.Slot].O
+			} else {
+				callee = regs[in.A].O
+			}
+			if callee == nil || callee != site.callee {
+				if err := resolve(site, callee, in.B); err != nil {
+					return Value{}, err
+				}
+			}
+			q := site.proto
+			if len(vm.frames) == cap(vm.frames) || base+int(in.A)+1+q.NumRegs > len(vm.stack) {
+				return Value{}, &object.Error{Message: "stack overflow"}
+			}
+			if vm.JIT && vm.hot(q, &q.calls, JITCallThreshold) {
+				if vm.enterJIT(q.jit, base+int(in.A)+1, 0) {
+					continue // the result is in R[A]
+				}
+				vm.frames = append(vm.frames, frame{proto: p, pc: pc, base: base})
+				p, pc, base = vm.deopt()
+				code, consts, regs = p.Code, p.Consts, vm.stack[base:]
+				continue
+			}
+			vm.frames = append(vm.frames, frame{proto: p, pc: pc, base: base})
+			p, base, pc = q, base+int(in.A)+1, 0
+			code, consts, regs = p.Code, p.Consts, vm.stack[base:]
+		case OpReturn, OpReturnNull:
+			v := Value{O: object.NULL}
+			if in.Op == OpReturn {
+				v = regs[in.A]
+			}
+			if len(vm.frames) == entry {
+				return v, nil
+			}
+			vm.stack[base-1] = v
+			f := vm.frames[len(vm.frames)-1]
+			vm.frames = vm.frames[:len(vm.frames)-1]
+			p, base, pc = f.proto, f.base, f.pc
+			code, consts, regs = p.Code, p.Consts, vm.stack[base:]
+		case OpPrint:
+			fmt.Fprintln(vm.Out, regs[in.A].Object().Inspect())
+		default:
+			return Value{}, &object.Error{Message: fmt.Sprintf("bad opcode %d", in.Op)}
+		}
+	}
+}